@@ -397,6 +397,11 @@ void QQmlTypeCompiler::setBindingPropertyDataPerObject(const QVector<QV4::Compil
     compiledData->compilationUnit->bindingPropertyDataPerObject = propertyData;
 }
 
+void QQmlTypeCompiler::setConvertedLiteralBindingsPerObject(const QHash<int, QHash<int, QVariant> > &convertedLiteralBindingsPerObject)
+{
+    compiledData->convertedLiteralBindingsPerObject = convertedLiteralBindingsPerObject;
+}
+
 QString QQmlTypeCompiler::bindingAsString(const QmlIR::Object *object, int scriptIndex) const
 {
     return object->bindingAsString(document, scriptIndex);
@@ -1755,6 +1760,7 @@ bool QQmlPropertyValidator::validate()
         return false;
     compiler->setDeferredBindingsPerObject(_deferredBindingsPerObject);
     compiler->setBindingPropertyDataPerObject(_bindingPropertyDataPerObject);
+    compiler->setConvertedLiteralBindingsPerObject(_convertedLiteralBindingsPerObject);
     return true;
 }
 
@@ -1833,6 +1839,7 @@ bool QQmlPropertyValidator::validateObject(int objectIndex, const QV4::CompiledD
 
     QBitArray customParserBindings(obj->nBindings);
     QBitArray deferredBindings;
+    QHash<int, QVariant> convertedLiteralBindings;
 
     QmlIR::PropertyResolver propertyResolver(propertyCache);
 
@@ -1988,8 +1995,11 @@ bool QQmlPropertyValidator::validateObject(int objectIndex, const QV4::CompiledD
             }
 
             if (binding->type < QV4::CompiledData::Binding::Type_Script) {
-                if (!validateLiteralBinding(propertyCache, pd, binding))
+                QVariant convertedValue;
+                if (!validateLiteralBinding(propertyCache, pd, binding, &convertedValue))
                     return false;
+                if (convertedValue.isValid())
+                    convertedLiteralBindings.insert(i, convertedValue);
             } else if (binding->type == QV4::CompiledData::Binding::Type_Object) {
                 if (!validateObjectBinding(pd, name, binding))
                     return false;
@@ -2051,12 +2061,15 @@ bool QQmlPropertyValidator::validateObject(int objectIndex, const QV4::CompiledD
     if (!deferredBindings.isEmpty())
         _deferredBindingsPerObject.insert(objectIndex, deferredBindings);
 
+    if (!convertedLiteralBindings.isEmpty())
+        _convertedLiteralBindingsPerObject.insert(objectIndex, convertedLiteralBindings);
+
     _bindingPropertyDataPerObject[objectIndex] = collectedBindingPropertyData;
 
     return true;
 }
 
-bool QQmlPropertyValidator::validateLiteralBinding(QQmlPropertyCache *propertyCache, QQmlPropertyData *property, const QV4::CompiledData::Binding *binding) const
+bool QQmlPropertyValidator::validateLiteralBinding(QQmlPropertyCache *propertyCache, QQmlPropertyData *property, const QV4::CompiledData::Binding *binding, QVariant *convertedValue) const
 {
     if (property->isQList()) {
         recordError(binding->valueLocation, tr("Cannot assign primitives to lists"));
@@ -2149,94 +2162,110 @@ bool QQmlPropertyValidator::validateLiteralBinding(QQmlPropertyCache *propertyCa
     break;
     case QVariant::Color: {
         bool ok = false;
-        QQmlStringConverters::rgbaFromString(binding->valueAsString(qmlUnit), &ok);
+        uint colorValue = QQmlStringConverters::rgbaFromString(binding->valueAsString(qmlUnit), &ok);
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: color expected"));
             return false;
         }
+        *convertedValue = QVariant::fromValue(colorValue);
     }
     break;
 #ifndef QT_NO_DATESTRING
     case QVariant::Date: {
         bool ok = false;
-        QQmlStringConverters::dateFromString(binding->valueAsString(qmlUnit), &ok);
+        QDate value = QQmlStringConverters::dateFromString(binding->valueAsString(qmlUnit), &ok);
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: date expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::Time: {
         bool ok = false;
-        QQmlStringConverters::timeFromString(binding->valueAsString(qmlUnit), &ok);
+        QTime value = QQmlStringConverters::timeFromString(binding->valueAsString(qmlUnit), &ok);
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: time expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::DateTime: {
         bool ok = false;
-        QQmlStringConverters::dateTimeFromString(binding->valueAsString(qmlUnit), &ok);
+        QDateTime value = QQmlStringConverters::dateTimeFromString(binding->valueAsString(qmlUnit), &ok);
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: datetime expected"));
             return false;
         }
+        // ### VME compatibility :(
+        {
+            const qint64 date = value.date().toJulianDay();
+            const int msecsSinceStartOfDay = value.time().msecsSinceStartOfDay();
+            value = QDateTime(QDate::fromJulianDay(date), QTime::fromMSecsSinceStartOfDay(msecsSinceStartOfDay));
+        }
+        *convertedValue = value;
     }
     break;
 #endif // QT_NO_DATESTRING
     case QVariant::Point: {
         bool ok = false;
-        QQmlStringConverters::pointFFromString(binding->valueAsString(qmlUnit), &ok);
+        QPoint value = QQmlStringConverters::pointFFromString(binding->valueAsString(qmlUnit), &ok).toPoint();
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: point expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::PointF: {
         bool ok = false;
-        QQmlStringConverters::pointFFromString(binding->valueAsString(qmlUnit), &ok);
+        QPointF value = QQmlStringConverters::pointFFromString(binding->valueAsString(qmlUnit), &ok);
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: point expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::Size: {
         bool ok = false;
-        QQmlStringConverters::sizeFFromString(binding->valueAsString(qmlUnit), &ok);
+        QSize value = QQmlStringConverters::sizeFFromString(binding->valueAsString(qmlUnit), &ok).toSize();
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: size expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::SizeF: {
         bool ok = false;
-        QQmlStringConverters::sizeFFromString(binding->valueAsString(qmlUnit), &ok);
+        QSizeF value = QQmlStringConverters::sizeFFromString(binding->valueAsString(qmlUnit), &ok);
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: size expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::Rect: {
         bool ok = false;
-        QQmlStringConverters::rectFFromString(binding->valueAsString(qmlUnit), &ok);
+        QRect value = QQmlStringConverters::rectFFromString(binding->valueAsString(qmlUnit), &ok).toRect();
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: rect expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::RectF: {
         bool ok = false;
-        QQmlStringConverters::rectFFromString(binding->valueAsString(qmlUnit), &ok);
+        QRectF value = QQmlStringConverters::rectFFromString(binding->valueAsString(qmlUnit), &ok);
         if (!ok) {
             recordError(binding->valueLocation, tr("Invalid property assignment: point expected"));
             return false;
         }
+        *convertedValue = value;
     }
     break;
     case QVariant::Bool: {
@@ -105,6 +105,7 @@ public:
     const QV4::Compiler::StringTableGenerator *stringPool() const;
     void setDeferredBindingsPerObject(const QHash<int, QBitArray> &deferredBindingsPerObject);
     void setBindingPropertyDataPerObject(const QVector<QV4::CompiledData::BindingPropertyData> &propertyData);
+    void setConvertedLiteralBindingsPerObject(const QHash<int, QHash<int, QVariant> > &convertedLiteralBindingsPerObject);
 
     const QHash<int, QQmlCustomParser*> &customParserCache() const { return customParsers; }
 
@@ -292,7 +293,7 @@ public:
 
 private:
     bool validateObject(int objectIndex, const QV4::CompiledData::Binding *instantiatingBinding, bool populatingValueTypeGroupProperty = false) const;
-    bool validateLiteralBinding(QQmlPropertyCache *propertyCache, QQmlPropertyData *property, const QV4::CompiledData::Binding *binding) const;
+    bool validateLiteralBinding(QQmlPropertyCache *propertyCache, QQmlPropertyData *property, const QV4::CompiledData::Binding *binding, QVariant *convertedValue) const;
     bool validateObjectBinding(QQmlPropertyData *property, const QString &propertyName, const QV4::CompiledData::Binding *binding) const;
 
     bool isComponent(int objectIndex) const { return objectIndexToIdPerComponent.contains(objectIndex); }
@@ -311,6 +312,7 @@ private:
     mutable QHash<int, QBitArray> _deferredBindingsPerObject;
     mutable bool _seenObjectWithId;
     mutable QVector<QV4::CompiledData::BindingPropertyData> _bindingPropertyDataPerObject;
+    mutable QHash<int, QHash<int, QVariant> > _convertedLiteralBindingsPerObject;
 };
 
 // ### merge with QtQml::JSCodeGen and operate directly on object->functionsAndExpressions once old compiler is gone.
@@ -102,6 +102,9 @@ struct QQmlProfilerDefinitions {
         PixmapLoadingStarted,
         PixmapLoadingFinished,
         PixmapLoadingError,
+        PixmapCacheHit,
+        PixmapCacheMiss,
+        PixmapCacheEviction,
 
         MaximumPixmapEventType
     };
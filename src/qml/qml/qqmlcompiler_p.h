@@ -130,6 +130,10 @@ public:
     // hash key is object index, value is indicies of bindings covered by custom parser
     QHash<int, QBitArray> customParserBindings;
     QHash<int, QBitArray> deferredBindingsPerObject; // index is object index
+    // Literal bindings to value types (color, date, point, rect, ...) already converted from
+    // their string form by the type compiler, so that instantiation only has to write them.
+    // Outer key is object index, inner key is binding index.
+    QHash<int, QHash<int, QVariant> > convertedLiteralBindingsPerObject;
     int totalBindingsCount; // Number of bindings used in this type
     int totalParserStatusCount; // Number of instantiated types that are QQmlParserStatus subclasses
     int totalObjectCount; // Number of objects explicitly instantiated
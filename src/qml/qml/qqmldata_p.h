@@ -115,11 +115,14 @@ public:
     quint32 hasInterceptorMetaObject:1;
     quint32 hasVMEMetaObject:1;
     quint32 parentFrozen:1;
-    quint32 dummy:21;
+    quint32 bindingBitsPreallocated:1;
+    quint32 dummy:20;
 
     // When bindingBitsSize < 32, we store the binding bit flags inside
     // bindingBitsValue. When we need more than 32 bits, we allocated
-    // sufficient space and use bindingBits to point to it.
+    // sufficient space and use bindingBits to point to it. If
+    // bindingBitsPreallocated is set, bindingBits points into memory
+    // allocated together with the object and must not be freed.
     int bindingBitsSize;
     union {
         quint32 *bindingBits;
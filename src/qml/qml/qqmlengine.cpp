@@ -668,7 +668,7 @@ void QQmlPrivate::qdeclarativeelement_destructor(QObject *o)
 QQmlData::QQmlData()
     : ownedByQml1(false), ownMemory(true), ownContext(false), indestructible(true), explicitIndestructibleSet(false),
       hasTaintedV4Object(false), isQueuedForDeletion(false), rootObjectInCreation(false),
-      hasInterceptorMetaObject(false), hasVMEMetaObject(false), parentFrozen(false), bindingBitsSize(0), bindingBits(0), notifyList(0), context(0), outerContext(0),
+      hasInterceptorMetaObject(false), hasVMEMetaObject(false), parentFrozen(false), bindingBitsPreallocated(false), bindingBitsSize(0), bindingBits(0), notifyList(0), context(0), outerContext(0),
       bindings(0), signalHandlers(0), nextContextObject(0), prevContextObject(0),
       lineNumber(0), columnNumber(0), jsEngineId(0), compiledData(0), deferredData(0),
       propertyCache(0), guards(0), extendedData(0)
@@ -1693,7 +1693,7 @@ void QQmlData::destroyed(QObject *object)
         signalHandler = next;
     }
 
-    if (bindingBitsSize > 32)
+    if (bindingBitsSize > 32 && !bindingBitsPreallocated)
         free(bindingBits);
 
     if (propertyCache)
@@ -1758,8 +1758,16 @@ static void QQmlData_setBit(QQmlData *data, QObject *obj, int bit)
         int oldArraySize = data->bindingBitsSize > 32 ? data->bindingBitsSize / 32 : 0;
         quint32 oldValue = data->bindingBitsSize == 32 ? data->bindingBitsValue : 0;
 
-        data->bindingBits = (quint32 *)realloc((data->bindingBitsSize == 32) ? 0 : data->bindingBits,
-                                               arraySize * sizeof(quint32));
+        if (data->bindingBitsPreallocated) {
+            // the preallocated bits live with the object, so move them to the heap
+            quint32 *bits = (quint32 *)malloc(arraySize * sizeof(quint32));
+            memcpy(bits, data->bindingBits, oldArraySize * sizeof(quint32));
+            data->bindingBits = bits;
+            data->bindingBitsPreallocated = false;
+        } else {
+            data->bindingBits = (quint32 *)realloc((data->bindingBitsSize == 32) ? 0 : data->bindingBits,
+                                                   arraySize * sizeof(quint32));
+        }
 
         memset(data->bindingBits + oldArraySize,
                0x00,
@@ -276,6 +276,29 @@ bool QQmlObjectCreator::populateDeferredProperties(QObject *instance)
     return errors.isEmpty();
 }
 
+/*
+ * The types whose string literals QQmlPropertyValidator converts while the
+ * type is compiled. Only bindings to these need to look for a converted value.
+ */
+static inline bool isConvertedLiteralType(int propertyType)
+{
+    switch (propertyType) {
+    case QVariant::Color:
+    case QVariant::Date:
+    case QVariant::Time:
+    case QVariant::DateTime:
+    case QVariant::Point:
+    case QVariant::PointF:
+    case QVariant::Size:
+    case QVariant::SizeF:
+    case QVariant::Rect:
+    case QVariant::RectF:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const QV4::CompiledData::Binding *binding)
 {
     QQmlPropertyPrivate::WriteFlags propertyWriteFlags = QQmlPropertyPrivate::BypassInterceptor |
@@ -300,6 +323,26 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
         }
     }
 
+    const QVariant *convertedValue = 0;
+    if (binding->type == QV4::CompiledData::Binding::Type_String && isConvertedLiteralType(propertyType))
+        convertedValue = convertedLiteralValue(binding);
+    if (convertedValue) {
+        // The type compiler has already converted the literal on the loader thread.
+        if (propertyType == QVariant::Color) {
+            uint colorValue = convertedValue->toUInt();
+            struct { void *data[4]; } buffer;
+            if (QQml_valueTypeProvider()->storeValueType(property->propType, &colorValue, &buffer, sizeof(buffer))) {
+                argv[0] = reinterpret_cast<void *>(&buffer);
+                QMetaObject::metacall(_qobject, QMetaObject::WriteProperty, property->coreIndex, argv);
+            }
+        } else {
+            Q_ASSERT(convertedValue->userType() == propertyType);
+            argv[0] = const_cast<void *>(convertedValue->constData());
+            QMetaObject::metacall(_qobject, QMetaObject::WriteProperty, property->coreIndex, argv);
+        }
+        return;
+    }
+
     switch (propertyType) {
     case QMetaType::QVariant: {
         if (binding->type == QV4::CompiledData::Binding::Type_Number) {
@@ -614,6 +657,23 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
     }
 }
 
+const QVariant *QQmlObjectCreator::convertedLiteralValue(const QV4::CompiledData::Binding *binding) const
+{
+    QHash<int, QHash<int, QVariant> >::ConstIterator convertedBindings = compiledData->convertedLiteralBindingsPerObject.constFind(_compiledObjectIndex);
+    if (convertedBindings == compiledData->convertedLiteralBindingsPerObject.constEnd())
+        return 0;
+
+    // Synthesized bindings such as the one for the id property are not part of the binding table.
+    const QV4::CompiledData::Binding *bindingTable = _compiledObject->bindingTable();
+    if (binding < bindingTable || binding >= bindingTable + _compiledObject->nBindings)
+        return 0;
+
+    QHash<int, QVariant>::ConstIterator value = convertedBindings->constFind(binding - bindingTable);
+    if (value == convertedBindings->constEnd())
+        return 0;
+    return &value.value();
+}
+
 static QQmlType *qmlTypeForObject(QObject *object)
 {
     QQmlType *type = 0;
@@ -1014,6 +1074,40 @@ QV4::Heap::QmlContext *QQmlObjectCreator::currentQmlContext()
     return _qmlContext->d();
 }
 
+// Allocates the object, its QQmlData and the binding bits the compiled object's
+// property cache calls for in a single block, instead of one heap allocation each.
+QObject *QQmlObjectCreator::createInstanceWithData(QQmlType *type, int index)
+{
+    int bindingBitsArraySize = 0;
+    if (QQmlPropertyCache *cache = propertyCaches.at(index)) {
+        bindingBitsArraySize = (2 * cache->propertyCount() + 31) / 32;
+        if (bindingBitsArraySize < 2)
+            bindingBitsArraySize = 0;
+    }
+
+    QObject *instance = 0;
+    void *ddataMemory = 0;
+    type->create(&instance, &ddataMemory, sizeof(QQmlData) + bindingBitsArraySize * sizeof(quint32));
+    if (!instance)
+        return 0;
+
+    // The constructor may already have attached its own declarative data.
+    QObjectPrivate *p = QObjectPrivate::get(instance);
+    if (p->declarativeData)
+        return instance;
+
+    QQmlData *ddata = new (ddataMemory) QQmlData;
+    ddata->ownMemory = false;
+    if (bindingBitsArraySize) {
+        ddata->bindingBits = reinterpret_cast<quint32 *>(ddata + 1);
+        memset(ddata->bindingBits, 0, bindingBitsArraySize * sizeof(quint32));
+        ddata->bindingBitsSize = bindingBitsArraySize * 32;
+        ddata->bindingBitsPreallocated = true;
+    }
+    p->declarativeData = ddata;
+    return instance;
+}
+
 QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isContextObject)
 {
     QQmlObjectCreationProfiler profiler(sharedState->profiler.profiler);
@@ -1043,7 +1137,7 @@ QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isCo
         if (type) {
             Q_QML_OC_PROFILE(sharedState->profiler, profiler.update(type->qmlTypeName(),
                     context->url(), obj->location.line, obj->location.column));
-            instance = type->create();
+            instance = createInstanceWithData(type, index);
             if (!instance) {
                 recordError(obj->location, tr("Unable to create object of type %1").arg(stringAt(obj->inheritedTypeNameIndex)));
                 return 0;
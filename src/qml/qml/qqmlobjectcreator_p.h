@@ -103,6 +103,7 @@ private:
     void init(QQmlContextData *parentContext);
 
     QObject *createInstance(int index, QObject *parent = 0, bool isContextObject = false);
+    QObject *createInstanceWithData(QQmlType *type, int index);
 
     bool populateInstance(int index, QObject *instance,
                           QObject *bindingTarget, const QQmlPropertyData *valueTypeProperty,
@@ -111,6 +112,7 @@ private:
     void setupBindings(const QBitArray &bindingsToSkip);
     bool setPropertyBinding(const QQmlPropertyData *property, const QV4::CompiledData::Binding *binding);
     void setPropertyValue(const QQmlPropertyData *property, const QV4::CompiledData::Binding *binding);
+    const QVariant *convertedLiteralValue(const QV4::CompiledData::Binding *binding) const;
     void setupFunctions();
 
     QString stringAt(int idx) const { return qmlUnit->stringAt(idx); }
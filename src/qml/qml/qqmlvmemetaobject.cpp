@@ -356,61 +356,61 @@ void QQmlVMEMetaObject::writeProperty(int id, const QString& v)
         *(md->data() + id) = cache->engine->newString(v);
 }
 
-void QQmlVMEMetaObject::writeProperty(int id, const QUrl& v)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (md)
-        *(md->data() + id) = cache->engine->newVariantObject(QVariant::fromValue(v));
-}
-
-void QQmlVMEMetaObject::writeProperty(int id, const QDate& v)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (md)
-        *(md->data() + id) = cache->engine->newVariantObject(QVariant::fromValue(v));
-}
-
-void QQmlVMEMetaObject::writeProperty(int id, const QDateTime& v)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (md)
-        *(md->data() + id) = cache->engine->newVariantObject(QVariant::fromValue(v));
-}
-
-void QQmlVMEMetaObject::writeProperty(int id, const QPointF& v)
+void QQmlVMEMetaObject::writeProperty(int id, QObject* v)
 {
     QV4::MemberData *md = propertiesAsMemberData();
     if (md)
-        *(md->data() + id) = cache->engine->newVariantObject(QVariant::fromValue(v));
-}
+        *(md->data() + id) = QV4::QObjectWrapper::wrap(cache->engine, v);
 
-void QQmlVMEMetaObject::writeProperty(int id, const QSizeF& v)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (md)
-        *(md->data() + id) = cache->engine->newVariantObject(QVariant::fromValue(v));
+    QQmlVMEVariantQObjectPtr *guard = getQObjectGuardForProperty(id);
+    if (v && !guard) {
+        guard = new QQmlVMEVariantQObjectPtr();
+        varObjectGuards.append(guard);
+    }
+    if (guard)
+        guard->setGuardedValue(v, this, id);
 }
 
-void QQmlVMEMetaObject::writeProperty(int id, const QRectF& v)
+// Value type properties are stored in a VariantObject that is updated in place, so
+// that reads and writes go straight to the typed QVariant payload instead of
+// allocating a new VariantObject for every write.
+template <typename T>
+void QQmlVMEMetaObject::readValueTypeProperty(int id, void *out)
 {
+    T *value = static_cast<T *>(out);
     QV4::MemberData *md = propertiesAsMemberData();
-    if (md)
-        *(md->data() + id) = cache->engine->newVariantObject(QVariant::fromValue(v));
+    if (md) {
+        const QV4::VariantObject *v = (md->data() + id)->as<QV4::VariantObject>();
+        if (v && v->d()->data.userType() == qMetaTypeId<T>()) {
+            *value = *static_cast<const T *>(v->d()->data.constData());
+            return;
+        }
+    }
+    *value = T();
 }
 
-void QQmlVMEMetaObject::writeProperty(int id, QObject* v)
+template <typename T>
+bool QQmlVMEMetaObject::writeValueTypeProperty(int id, const void *in)
 {
+    const T &value = *static_cast<const T *>(in);
     QV4::MemberData *md = propertiesAsMemberData();
-    if (md)
-        *(md->data() + id) = QV4::QObjectWrapper::wrap(cache->engine, v);
+    if (!md)
+        return false;
 
-    QQmlVMEVariantQObjectPtr *guard = getQObjectGuardForProperty(id);
-    if (v && !guard) {
-        guard = new QQmlVMEVariantQObjectPtr();
-        varObjectGuards.append(guard);
+    QV4::Value *slot = md->data() + id;
+    QV4::VariantObject *v = slot->as<QV4::VariantObject>();
+    if (v && v->d()->data.userType() == qMetaTypeId<T>()) {
+        // Always store the value: values which compare equal may still differ,
+        // e.g. QDateTime with a different time spec. The comparison only
+        // decides whether the change is notified.
+        T *current = static_cast<T *>(v->d()->data.data());
+        const bool changed = !(*current == value);
+        *current = value;
+        return changed;
     }
-    if (guard)
-        guard->setGuardedValue(v, this, id);
+
+    *slot = cache->engine->newVariantObject(QVariant::fromValue(value));
+    return !(value == T());
 }
 
 int QQmlVMEMetaObject::readPropertyAsInt(int id)
@@ -419,11 +419,10 @@ int QQmlVMEMetaObject::readPropertyAsInt(int id)
     if (!md)
         return 0;
 
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    if (!sv->isInt32())
+    const QV4::Value *v = md->data() + id;
+    if (!v->isInt32())
         return 0;
-    return sv->integerValue();
+    return v->integerValue();
 }
 
 bool QQmlVMEMetaObject::readPropertyAsBool(int id)
@@ -432,11 +431,10 @@ bool QQmlVMEMetaObject::readPropertyAsBool(int id)
     if (!md)
         return false;
 
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    if (!sv->isBoolean())
+    const QV4::Value *v = md->data() + id;
+    if (!v->isBoolean())
         return false;
-    return sv->booleanValue();
+    return v->booleanValue();
 }
 
 double QQmlVMEMetaObject::readPropertyAsDouble(int id)
@@ -445,11 +443,10 @@ double QQmlVMEMetaObject::readPropertyAsDouble(int id)
     if (!md)
         return 0.0;
 
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    if (!sv->isDouble())
+    const QV4::Value *v = md->data() + id;
+    if (!v->isDouble())
         return 0.0;
-    return sv->doubleValue();
+    return v->doubleValue();
 }
 
 QString QQmlVMEMetaObject::readPropertyAsString(int id)
@@ -465,76 +462,6 @@ QString QQmlVMEMetaObject::readPropertyAsString(int id)
     return sv->stringValue()->toQString();
 }
 
-QUrl QQmlVMEMetaObject::readPropertyAsUrl(int id)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (!md)
-        return QUrl();
-
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
-    if (!v || v->d()->data.type() != QVariant::Url)
-        return QUrl();
-    return v->d()->data.value<QUrl>();
-}
-
-QDate QQmlVMEMetaObject::readPropertyAsDate(int id)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (!md)
-        return QDate();
-
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
-    if (!v || v->d()->data.type() != QVariant::Date)
-        return QDate();
-    return v->d()->data.value<QDate>();
-}
-
-QDateTime QQmlVMEMetaObject::readPropertyAsDateTime(int id)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (!md)
-        return QDateTime();
-
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
-    if (!v || v->d()->data.type() != QVariant::DateTime)
-        return QDateTime();
-    return v->d()->data.value<QDateTime>();
-}
-
-QSizeF QQmlVMEMetaObject::readPropertyAsSizeF(int id)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (!md)
-        return QSizeF();
-
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
-    if (!v || v->d()->data.type() != QVariant::SizeF)
-        return QSizeF();
-    return v->d()->data.value<QSizeF>();
-}
-
-QPointF QQmlVMEMetaObject::readPropertyAsPointF(int id)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (!md)
-        return QPointF();
-
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
-    if (!v || v->d()->data.type() != QVariant::PointF)
-        return QPointF();
-    return v->d()->data.value<QPointF>();
-}
-
 QObject* QQmlVMEMetaObject::readPropertyAsQObject(int id)
 {
     QV4::MemberData *md = propertiesAsMemberData();
@@ -565,20 +492,6 @@ QList<QObject *> *QQmlVMEMetaObject::readPropertyAsList(int id)
     return static_cast<QList<QObject *> *>(v->d()->data.data());
 }
 
-QRectF QQmlVMEMetaObject::readPropertyAsRectF(int id)
-{
-    QV4::MemberData *md = propertiesAsMemberData();
-    if (!md)
-        return QRectF();
-
-    QV4::Scope scope(cache->engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
-    if (!v || v->d()->data.type() != QVariant::RectF)
-        return QRectF();
-    return v->d()->data.value<QRectF>();
-}
-
 int QQmlVMEMetaObject::metaCall(QObject *o, QMetaObject::Call c, int _id, void **a)
 {
     Q_ASSERT(o == object);
@@ -629,22 +542,22 @@ int QQmlVMEMetaObject::metaCall(QObject *o, QMetaObject::Call c, int _id, void *
                             *reinterpret_cast<QString *>(a[0]) = readPropertyAsString(id);
                             break;
                         case QVariant::Url:
-                            *reinterpret_cast<QUrl *>(a[0]) = readPropertyAsUrl(id);
+                            readValueTypeProperty<QUrl>(id, a[0]);
                             break;
                         case QVariant::Date:
-                            *reinterpret_cast<QDate *>(a[0]) = readPropertyAsDate(id);
+                            readValueTypeProperty<QDate>(id, a[0]);
                             break;
                         case QVariant::DateTime:
-                            *reinterpret_cast<QDateTime *>(a[0]) = readPropertyAsDateTime(id);
+                            readValueTypeProperty<QDateTime>(id, a[0]);
                             break;
                         case QVariant::RectF:
-                            *reinterpret_cast<QRectF *>(a[0]) = readPropertyAsRectF(id);
+                            readValueTypeProperty<QRectF>(id, a[0]);
                             break;
                         case QVariant::SizeF:
-                            *reinterpret_cast<QSizeF *>(a[0]) = readPropertyAsSizeF(id);
+                            readValueTypeProperty<QSizeF>(id, a[0]);
                             break;
                         case QVariant::PointF:
-                            *reinterpret_cast<QPointF *>(a[0]) = readPropertyAsPointF(id);
+                            readValueTypeProperty<QPointF>(id, a[0]);
                             break;
                         case QMetaType::QObjectStar:
                             *reinterpret_cast<QObject **>(a[0]) = readPropertyAsQObject(id);
@@ -695,28 +608,22 @@ int QQmlVMEMetaObject::metaCall(QObject *o, QMetaObject::Call c, int _id, void *
                             writeProperty(id, *reinterpret_cast<QString *>(a[0]));
                             break;
                         case QVariant::Url:
-                            needActivate = *reinterpret_cast<QUrl *>(a[0]) != readPropertyAsUrl(id);
-                            writeProperty(id, *reinterpret_cast<QUrl *>(a[0]));
+                            needActivate = writeValueTypeProperty<QUrl>(id, a[0]);
                             break;
                         case QVariant::Date:
-                            needActivate = *reinterpret_cast<QDate *>(a[0]) != readPropertyAsDate(id);
-                            writeProperty(id, *reinterpret_cast<QDate *>(a[0]));
+                            needActivate = writeValueTypeProperty<QDate>(id, a[0]);
                             break;
                         case QVariant::DateTime:
-                            needActivate = *reinterpret_cast<QDateTime *>(a[0]) != readPropertyAsDateTime(id);
-                            writeProperty(id, *reinterpret_cast<QDateTime *>(a[0]));
+                            needActivate = writeValueTypeProperty<QDateTime>(id, a[0]);
                             break;
                         case QVariant::RectF:
-                            needActivate = *reinterpret_cast<QRectF *>(a[0]) != readPropertyAsRectF(id);
-                            writeProperty(id, *reinterpret_cast<QRectF *>(a[0]));
+                            needActivate = writeValueTypeProperty<QRectF>(id, a[0]);
                             break;
                         case QVariant::SizeF:
-                            needActivate = *reinterpret_cast<QSizeF *>(a[0]) != readPropertyAsSizeF(id);
-                            writeProperty(id, *reinterpret_cast<QSizeF *>(a[0]));
+                            needActivate = writeValueTypeProperty<QSizeF>(id, a[0]);
                             break;
                         case QVariant::PointF:
-                            needActivate = *reinterpret_cast<QPointF *>(a[0]) != readPropertyAsPointF(id);
-                            writeProperty(id, *reinterpret_cast<QPointF *>(a[0]));
+                            needActivate = writeValueTypeProperty<QPointF>(id, a[0]);
                             break;
                         case QMetaType::QObjectStar:
                             needActivate = *reinterpret_cast<QObject **>(a[0]) != readPropertyAsQObject(id);
@@ -238,25 +238,16 @@ public:
     bool readPropertyAsBool(int id);
     double readPropertyAsDouble(int id);
     QString readPropertyAsString(int id);
-    QSizeF readPropertyAsSizeF(int id);
-    QPointF readPropertyAsPointF(int id);
-    QUrl readPropertyAsUrl(int id);
-    QDate readPropertyAsDate(int id);
-    QDateTime readPropertyAsDateTime(int id);
-    QRectF readPropertyAsRectF(int id);
     QObject *readPropertyAsQObject(int id);
     QList<QObject *> *readPropertyAsList(int id);
 
+    template <typename T> void readValueTypeProperty(int id, void *out);
+    template <typename T> bool writeValueTypeProperty(int id, const void *in);
+
     void writeProperty(int id, int v);
     void writeProperty(int id, bool v);
     void writeProperty(int id, double v);
     void writeProperty(int id, const QString& v);
-    void writeProperty(int id, const QPointF& v);
-    void writeProperty(int id, const QSizeF& v);
-    void writeProperty(int id, const QUrl& v);
-    void writeProperty(int id, const QDate& v);
-    void writeProperty(int id, const QDateTime& v);
-    void writeProperty(int id, const QRectF& v);
     void writeProperty(int id, QObject *v);
 
     void ensureQObjectWrapper();
@@ -48,8 +48,12 @@
 #include <private/qv4functionobject_p.h>
 #include <qv4objectiterator_p.h>
 
+#include <QtCore/qloggingcategory.h>
+
 QT_BEGIN_NAMESPACE
 
+Q_LOGGING_CATEGORY(lcDelegateModelPool, "qt.qml.delegatemodel.pool")
+
 class QQmlDelegateModelItem;
 
 namespace QV4 {
@@ -197,6 +201,9 @@ QQmlDelegateModelPrivate::QQmlDelegateModelPrivate(QQmlContext *ctxt)
     , m_filterGroup(QStringLiteral("items"))
     , m_count(0)
     , m_groupCount(Compositor::MinimumGroupCount)
+    , m_poolSize(0)
+    , m_reusedItemCount(0)
+    , m_reuseMissCount(0)
     , m_compositorGroup(Compositor::Cache)
     , m_complete(false)
     , m_delegateValidated(false)
@@ -246,6 +253,8 @@ QQmlDelegateModel::~QQmlDelegateModel()
 {
     Q_D(QQmlDelegateModel);
 
+    d->drainReusableItemsPool();
+
     foreach (QQmlDelegateModelItem *cacheItem, d->m_cache) {
         if (cacheItem->object) {
             delete cacheItem->object;
@@ -358,6 +367,9 @@ void QQmlDelegateModel::setModel(const QVariant &model)
     if (d->m_complete)
         _q_itemsRemoved(0, d->m_count);
 
+    // Pooled items are bound to the data type of the previous model.
+    d->drainReusableItemsPool();
+
     d->m_adaptorModel.setModel(model, this, d->m_context->engine());
     d->m_adaptorModel.replaceWatchedRoles(QList<QByteArray>(), d->m_watchedRoles);
     for (int i = 0; d->m_parts && i < d->m_parts->models.count(); ++i) {
@@ -393,6 +405,7 @@ void QQmlDelegateModel::setDelegate(QQmlComponent *delegate)
         return;
     }
     bool wasValid = d->m_delegate != 0;
+    d->drainReusableItemsPool();
     d->m_delegate = delegate;
     d->m_delegateValidated = false;
     if (wasValid && d->m_complete) {
@@ -453,6 +466,7 @@ void QQmlDelegateModel::setRootIndex(const QVariant &root)
     const bool changed = d->m_adaptorModel.rootIndex != modelIndex;
     if (changed || !d->m_adaptorModel.isValid()) {
         const int oldCount = d->m_count;
+        d->drainReusableItemsPool();
         d->m_adaptorModel.rootIndex = modelIndex;
         if (!d->m_adaptorModel.isValid() && d->m_adaptorModel.aim())  // The previous root index was invalidated, so we need to reconnect the model.
             d->m_adaptorModel.setModel(d->m_adaptorModel.list.list(), this, d->m_context->engine());
@@ -470,6 +484,47 @@ void QQmlDelegateModel::setRootIndex(const QVariant &root)
     }
 }
 
+/*!
+    \qmlproperty int QtQml.Models::DelegateModel::poolSize
+    \since QtQml.Models 2.3
+
+    This property holds the maximum number of released delegate instances
+    that are kept for reuse.
+
+    When a view releases a delegate instance that is no longer referenced, the
+    instance is put aside instead of being destroyed. The next time an instance
+    is requested for a model item, a pooled instance is handed out instead of
+    creating a new one from the delegate component. Only the \c index and the
+    model data of the reused instance change, so only the bindings depending on
+    them are evaluated again. \c Component.onCompleted is not emitted again for
+    a reused instance, and \c hasModelChildren keeps the value it had when the
+    instance was created.
+
+    Delegates of QObject list models and \l Package delegates are never reused.
+    A C++ type used as the root of a delegate can opt out of reuse by declaring
+    \c {Q_CLASSINFO("DelegateReusable", "false")}.
+
+    The default value is 0, which disables reuse.
+*/
+int QQmlDelegateModel::poolSize() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_poolSize;
+}
+
+void QQmlDelegateModel::setPoolSize(int size)
+{
+    Q_D(QQmlDelegateModel);
+    size = qMax(0, size);
+    if (d->m_poolSize == size)
+        return;
+
+    d->m_poolSize = size;
+    while (d->m_reusableItems.count() > d->m_poolSize)
+        d->destroyReusableItem(d->m_reusableItems.takeFirst());
+    emit poolSizeChanged();
+}
+
 /*!
     \qmlmethod QModelIndex QtQml.Models::DelegateModel::modelIndex(int index)
 
@@ -526,6 +581,10 @@ QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *objec
 
     if (QQmlDelegateModelItem *cacheItem = QQmlDelegateModelItem::dataForObject(object)) {
         if (cacheItem->releaseObject()) {
+            if (addToReusableItemsPool(cacheItem)) {
+                stat |= QQmlInstanceModel::Destroyed;
+                return stat;
+            }
             cacheItem->destroyObject();
             emitDestroyingItem(object);
             if (cacheItem->incubationTask) {
@@ -833,6 +892,84 @@ void QQDMIncubationTask::statusChanged(Status status)
     }
 }
 
+static bool isReusable(QObject *object)
+{
+    const QMetaObject *metaObject = object->metaObject();
+    const int index = metaObject->indexOfClassInfo("DelegateReusable");
+    return index == -1 || qstrcmp(metaObject->classInfo(index).value(), "false") != 0;
+}
+
+/*
+    Puts a delegate instance that is no longer referenced aside for reuse
+    instead of destroying it.  As far as the views are concerned the instance
+    is destroyed, and the cache item is removed from the cache so that no
+    further model changes are applied to it.
+*/
+bool QQmlDelegateModelPrivate::addToReusableItemsPool(QQmlDelegateModelItem *cacheItem)
+{
+    if (m_poolSize == 0
+            || !cacheItem->object
+            || cacheItem->incubationTask
+            || cacheItem->index < 0
+            || cacheItem->scriptRef != 1 // Only referenced by its delegate instance.
+            || (cacheItem->groups & Compositor::UnresolvedFlag)
+            || m_adaptorModel.hasProxyObject()
+            || qmlobject_cast<QQuickPackage *>(cacheItem->object)
+            || !isReusable(cacheItem->object)) {
+        return false;
+    }
+
+    emitDestroyingItem(cacheItem->object);
+    removeCacheItem(cacheItem);
+
+    m_reusableItems.append(cacheItem);
+    while (m_reusableItems.count() > m_poolSize)
+        destroyReusableItem(m_reusableItems.takeFirst());
+    return true;
+}
+
+QQmlDelegateModelItem *QQmlDelegateModelPrivate::takeReusableItem(int modelIndex)
+{
+    if (m_poolSize == 0)
+        return 0;
+
+    while (!m_reusableItems.isEmpty()) {
+        QQmlDelegateModelItem *cacheItem = m_reusableItems.takeLast();
+        if (cacheItem->object && cacheItem->reuse(m_adaptorModel, modelIndex)) {
+            ++m_reusedItemCount;
+            return cacheItem;
+        }
+        destroyReusableItem(cacheItem);
+    }
+
+    ++m_reuseMissCount;
+    return 0;
+}
+
+void QQmlDelegateModelPrivate::destroyReusableItem(QQmlDelegateModelItem *cacheItem)
+{
+    if (cacheItem->object) {
+        cacheItem->destroyObject();
+    } else if (cacheItem->contextData) {
+        cacheItem->contextData->destroy();
+        cacheItem->contextData = 0;
+    }
+    cacheItem->Dispose();
+}
+
+void QQmlDelegateModelPrivate::drainReusableItemsPool()
+{
+    if (m_reusedItemCount || m_reuseMissCount) {
+        qCDebug(lcDelegateModelPool) << "reused" << m_reusedItemCount << "of"
+                                     << (m_reusedItemCount + m_reuseMissCount)
+                                     << "requested delegate instances, dropping"
+                                     << m_reusableItems.count() << "pooled instances";
+    }
+
+    while (!m_reusableItems.isEmpty())
+        destroyReusableItem(m_reusableItems.takeLast());
+}
+
 void QQmlDelegateModelPrivate::releaseIncubator(QQDMIncubationTask *incubationTask)
 {
     Q_Q(QQmlDelegateModel);
@@ -925,9 +1062,13 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
     Compositor::iterator it = m_compositor.find(group, index);
 
     QQmlDelegateModelItem *cacheItem = it->inCache() ? m_cache.at(it.cacheIndex) : 0;
+    bool reused = false;
 
     if (!cacheItem) {
-        cacheItem = m_adaptorModel.createItem(m_cacheMetaType, m_context->engine(), it.modelIndex());
+        cacheItem = takeReusableItem(it.modelIndex());
+        reused = cacheItem != 0;
+        if (!cacheItem)
+            cacheItem = m_adaptorModel.createItem(m_cacheMetaType, m_context->engine(), it.modelIndex());
         if (!cacheItem)
             return 0;
 
@@ -936,6 +1077,11 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
         m_cache.insert(it.cacheIndex, cacheItem);
         m_compositor.setFlags(it, 1, Compositor::CacheFlag);
         Q_ASSERT(m_cache.count() == m_compositor.count(Compositor::Cache));
+
+        if (reused && cacheItem->attached) {
+            cacheItem->attached->resetCurrentIndex();
+            cacheItem->attached->emitChanges();
+        }
     }
 
     // Bump the reference counts temporarily so neither the content data or the delegate object
@@ -943,7 +1089,11 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
     cacheItem->scriptRef += 1;
     cacheItem->referenceObject();
 
-    if (cacheItem->incubationTask) {
+    if (reused) {
+        // Let the views set up the reused instance as if it had just been incubated.
+        Q_EMIT q->initItem(it.index[m_compositorGroup], cacheItem->object);
+        Q_EMIT q->createdItem(it.index[m_compositorGroup], cacheItem->object);
+    } else if (cacheItem->incubationTask) {
         if (!asynchronous && cacheItem->incubationTask->incubationMode() == QQmlIncubator::Asynchronous) {
             // previously requested async - now needed immediately
             cacheItem->incubationTask->forceCompletion();
@@ -1458,6 +1608,9 @@ void QQmlDelegateModel::_q_modelReset()
     int oldCount = d->m_count;
     d->m_adaptorModel.rootIndex = QModelIndex();
 
+    // The roles provided by the model may have changed with the reset.
+    d->drainReusableItemsPool();
+
     if (d->m_complete) {
         d->m_count = d->m_adaptorModel.count();
 
@@ -2088,11 +2241,9 @@ QQmlDelegateModelAttached::QQmlDelegateModelAttached(
         for (int i = 1; i < qMin<int>(m_cacheItem->metaType->groupCount, Compositor::MaximumGroupCount); ++i)
             m_currentIndex[i] = m_previousIndex[i] = incubationTask->index[i];
     } else {
-        QQmlDelegateModelPrivate * const model = QQmlDelegateModelPrivate::get(m_cacheItem->metaType->model);
-        Compositor::iterator it = model->m_compositor.find(
-                Compositor::Cache, model->m_cache.indexOf(m_cacheItem));
+        resetCurrentIndex();
         for (int i = 1; i < m_cacheItem->metaType->groupCount; ++i)
-            m_currentIndex[i] = m_previousIndex[i] = it.index[i];
+            m_previousIndex[i] = m_currentIndex[i];
     }
 
     if (!cacheItem->metaType->metaObject)
@@ -2207,6 +2358,19 @@ bool QQmlDelegateModelAttached::isUnresolved() const
     It is attached to each instance of the delegate.
 */
 
+/*
+    Looks up the indexes of the cache item in all groups again, for instance
+    when the item has been reused for a different model index.
+*/
+void QQmlDelegateModelAttached::resetCurrentIndex()
+{
+    QQmlDelegateModelPrivate * const model = QQmlDelegateModelPrivate::get(m_cacheItem->metaType->model);
+    Compositor::iterator it = model->m_compositor.find(
+            Compositor::Cache, model->m_cache.indexOf(m_cacheItem));
+    for (int i = 1; i < m_cacheItem->metaType->groupCount; ++i)
+        m_currentIndex[i] = it.index[i];
+}
+
 void QQmlDelegateModelAttached::emitChanges()
 {
     const int groupChanges = m_previousGroups ^ m_cacheItem->groups;
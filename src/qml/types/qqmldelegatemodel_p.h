@@ -79,6 +79,7 @@ class Q_QML_PRIVATE_EXPORT QQmlDelegateModel : public QQmlInstanceModel, public
     Q_PROPERTY(QQmlListProperty<QQmlDelegateModelGroup> groups READ groups CONSTANT)
     Q_PROPERTY(QObject *parts READ parts CONSTANT)
     Q_PROPERTY(QVariant rootIndex READ rootIndex WRITE setRootIndex NOTIFY rootIndexChanged)
+    Q_PROPERTY(int poolSize READ poolSize WRITE setPoolSize NOTIFY poolSizeChanged REVISION 1)
     Q_CLASSINFO("DefaultProperty", "delegate")
     Q_INTERFACES(QQmlParserStatus)
 public:
@@ -98,6 +99,9 @@ public:
     QVariant rootIndex() const;
     void setRootIndex(const QVariant &root);
 
+    int poolSize() const;
+    void setPoolSize(int size);
+
     Q_INVOKABLE QVariant modelIndex(int idx) const;
     Q_INVOKABLE QVariant parentModelIndex() const;
 
@@ -128,6 +132,7 @@ Q_SIGNALS:
     void filterGroupChanged();
     void defaultGroupsChanged();
     void rootIndexChanged();
+    Q_REVISION(1) void poolSizeChanged();
 
 private Q_SLOTS:
     void _q_itemsChanged(int index, int count, const QVector<int> &roles);
@@ -212,6 +217,7 @@ public:
 
     bool isUnresolved() const;
 
+    void resetCurrentIndex();
     void emitChanges();
 
     void emitUnresolvedChanged() { Q_EMIT unresolvedChanged(); }
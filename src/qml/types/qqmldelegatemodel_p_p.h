@@ -124,6 +124,7 @@ public:
 
     virtual void setValue(const QString &role, const QVariant &value) { Q_UNUSED(role); Q_UNUSED(value); }
     virtual bool resolveIndex(const QQmlAdaptorModel &, int) { return false; }
+    virtual bool reuse(const QQmlAdaptorModel &, int) { return false; }
 
     static QV4::ReturnedValue get_model(QV4::CallContext *ctx);
     static QV4::ReturnedValue get_groups(QV4::CallContext *ctx);
@@ -295,6 +296,11 @@ public:
     static int group_count(QQmlListProperty<QQmlDelegateModelGroup> *property);
     static QQmlDelegateModelGroup *group_at(QQmlListProperty<QQmlDelegateModelGroup> *property, int index);
 
+    bool addToReusableItemsPool(QQmlDelegateModelItem *cacheItem);
+    QQmlDelegateModelItem *takeReusableItem(int modelIndex);
+    void destroyReusableItem(QQmlDelegateModelItem *cacheItem);
+    void drainReusableItemsPool();
+
     void releaseIncubator(QQDMIncubationTask *incubationTask);
     void incubatorStatusChanged(QQDMIncubationTask *incubationTask, QQmlIncubator::Status status);
     void setInitialState(QQDMIncubationTask *incubationTask, QObject *o);
@@ -308,6 +314,7 @@ public:
     QQmlDelegateModelGroupEmitterList m_pendingParts;
 
     QList<QQmlDelegateModelItem *> m_cache;
+    QList<QQmlDelegateModelItem *> m_reusableItems;
     QList<QQDMIncubationTask *> m_finishedIncubating;
     QList<QByteArray> m_watchedRoles;
 
@@ -315,6 +322,9 @@ public:
 
     int m_count;
     int m_groupCount;
+    int m_poolSize;
+    int m_reusedItemCount;
+    int m_reuseMissCount;
 
     QQmlListCompositor::Group m_compositorGroup;
     bool m_complete : 1;
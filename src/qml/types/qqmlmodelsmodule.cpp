@@ -46,6 +46,7 @@ void QQmlModelsModule::defineModule()
     qmlRegisterType<QQmlListElement>(uri, 2, 1, "ListElement");
     qmlRegisterCustomType<QQmlListModel>(uri, 2, 1, "ListModel", new QQmlListModelParser);
     qmlRegisterType<QQmlDelegateModel>(uri, 2, 1, "DelegateModel");
+    qmlRegisterType<QQmlDelegateModel,1>(uri, 2, 3, "DelegateModel");
     qmlRegisterType<QQmlDelegateModelGroup>(uri, 2, 1, "DelegateModelGroup");
     qmlRegisterType<QQmlObjectModel>(uri, 2, 1, "ObjectModel");
     qmlRegisterType<QQmlObjectModel,3>(uri, 2, 3, "ObjectModel");
@@ -99,6 +99,7 @@ public:
 
     void setValue(const QString &role, const QVariant &value);
     bool resolveIndex(const QQmlAdaptorModel &model, int idx);
+    bool reuse(const QQmlAdaptorModel &model, int idx);
 
     static QV4::ReturnedValue get_property(QV4::CallContext *ctx, uint propertyId);
     static QV4::ReturnedValue set_property(QV4::CallContext *ctx, uint propertyId);
@@ -337,6 +338,19 @@ bool QQmlDMCachedModelData::resolveIndex(const QQmlAdaptorModel &, int idx)
     }
 }
 
+bool QQmlDMCachedModelData::reuse(const QQmlAdaptorModel &, int idx)
+{
+    Q_ASSERT(idx >= 0);
+    index = idx;
+    cachedData.clear();
+    emit modelIndexChanged();
+    const QMetaObject *meta = metaObject();
+    const int propertyCount = type->propertyRoles.count();
+    for (int i = 0; i < propertyCount; ++i)
+        QMetaObject::activate(this, meta, i, 0);
+    return true;
+}
+
 QV4::ReturnedValue QQmlDMCachedModelData::get_property(QV4::CallContext *ctx, uint propertyId)
 {
     QV4::Scope scope(ctx);
@@ -632,6 +646,15 @@ public:
         }
     }
 
+    bool reuse(const QQmlAdaptorModel &model, int idx)
+    {
+        index = idx;
+        cachedData = model.list.at(idx);
+        emit modelIndexChanged();
+        emit modelDataChanged();
+        return true;
+    }
+
 
 Q_SIGNALS:
     void modelDataChanged();
@@ -89,9 +89,9 @@ QT_BEGIN_NAMESPACE
     that group.  To avoid the inefficiency of iterating over potentially all ranges when looking
     for a specific index, each time a lookup is done the range and its indexes are cached and the
     next lookup is done relative to this.   This works out to near constant time in most relevant
-    use cases because successive index lookups are most frequently adjacent.  The total number of
-    ranges is often quite small, which helps as well. If there is a need for faster random access
-    then a skip list like index may be an appropriate addition.
+    use cases because successive index lookups are most frequently adjacent.  Lookups further
+    away than that instead do a binary search of an index of the ranges and the group indexes at
+    the start of each, which is rebuilt the first time it is needed after the ranges change.
 
     \sa VisualDataModel
 */
@@ -225,6 +225,10 @@ static bool qt_verifyIntegrity(
 //#define QT_QML_TRACE_LISTCOMPOSITOR(args) qDebug() << m_end.index[1] << m_end.index[0] << Q_FUNC_INFO args;
 #define QT_QML_TRACE_LISTCOMPOSITOR(args)
 
+// The distance in items from the cached iterator beyond which a lookup uses the range index
+// rather than walking over the ranges in between.
+static const int qt_listCompositorWalkDistance = 64;
+
 QQmlListCompositor::iterator &QQmlListCompositor::iterator::operator +=(int difference)
 {
     // Update all indexes to the start of the range.
@@ -285,6 +289,7 @@ QQmlListCompositor::QQmlListCompositor()
     , m_defaultFlags(PrependFlag | DefaultFlag)
     , m_removeFlags(AppendFlag | PrependFlag | GroupMask)
     , m_moveId(0)
+    , m_rangeIndexValid(false)
 {
 }
 
@@ -336,6 +341,65 @@ void QQmlListCompositor::setGroupCount(int count)
     m_groupCount = count;
     m_end = iterator(&m_ranges, 0, Default, m_groupCount);
     m_cacheIt = m_end;
+    m_rangeIndexValid = false;
+}
+
+/*!
+    Rebuilds the index of ranges used to look up items far from the cached iterator.
+*/
+
+void QQmlListCompositor::updateRangeIndex()
+{
+    m_rangeIndex.resize(0);
+    m_rangeGroupIndexes.resize(0);
+    for (iterator it(m_ranges.next, 0, Default, m_groupCount); *it != &m_ranges; *it = it->next) {
+        m_rangeIndex.append(*it);
+        for (int i = 0; i < m_groupCount; ++i)
+            m_rangeGroupIndexes.append(it.index[i]);
+        it.incrementIndexes(it->count);
+    }
+    m_rangeIndexValid = true;
+}
+
+/*!
+    Returns an iterator representing the item at \a index in a \a group, found by a binary search
+    of the range index.
+
+    The index must be between 0 and count(group).
+*/
+
+QQmlListCompositor::iterator QQmlListCompositor::findIndexed(Group group, int index)
+{
+    if (index >= count(group)) {
+        iterator it = m_end;
+        it.setGroup(group);
+        return it;
+    }
+
+    if (!m_rangeIndexValid)
+        updateRangeIndex();
+
+    // Find the last range starting at or before index, which is the member of group that
+    // contains it as ranges that aren't members don't advance the group index.
+    const int *groupIndexes = m_rangeGroupIndexes.constData();
+    int low = 0;
+    int high = m_rangeIndex.count();
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        if (groupIndexes[middle * m_groupCount + group] <= index)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    const int rangeIndex = low - 1;
+    Q_ASSERT(rangeIndex >= 0);
+
+    groupIndexes += rangeIndex * m_groupCount;
+    iterator it(m_rangeIndex.at(rangeIndex), index - groupIndexes[group], group, m_groupCount);
+    for (int i = 0; i < m_groupCount; ++i)
+        it.index[i] = groupIndexes[i];
+    it.incrementIndexes(it.offset);
+    return it;
 }
 
 /*!
@@ -358,8 +422,14 @@ QQmlListCompositor::iterator QQmlListCompositor::find(Group group, int index)
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index < count(group));
     if (m_cacheIt == m_end) {
-        m_cacheIt = iterator(m_ranges.next, 0, group, m_groupCount);
-        m_cacheIt += index;
+        if (index > qt_listCompositorWalkDistance) {
+            m_cacheIt = findIndexed(group, index);
+        } else {
+            m_cacheIt = iterator(m_ranges.next, 0, group, m_groupCount);
+            m_cacheIt += index;
+        }
+    } else if (qAbs(index - m_cacheIt.index[group]) > qt_listCompositorWalkDistance) {
+        m_cacheIt = findIndexed(group, index);
     } else {
         const int offset = index - m_cacheIt.index[group];
         m_cacheIt.setGroup(group);
@@ -399,7 +469,15 @@ QQmlListCompositor::insert_iterator QQmlListCompositor::findInsertPosition(Group
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index <= count(group));
     insert_iterator it;
-    if (m_cacheIt == m_end) {
+    const int distance = m_cacheIt == m_end ? index : qAbs(index - m_cacheIt.index[group]);
+    if (distance > qt_listCompositorWalkDistance) {
+        it = findIndexed(group, index);
+        // As with insert_iterator::operator +=, insert after items appended to the previous range.
+        if (it.offset == 0 && it->previous->append()) {
+            *it = it->previous;
+            it.offset = it->inGroup() ? it->count : 0;
+        }
+    } else if (m_cacheIt == m_end) {
         it = iterator(m_ranges.next, 0, group, m_groupCount);
         it += index;
     } else {
@@ -493,6 +571,7 @@ QQmlListCompositor::iterator QQmlListCompositor::insert(
 
     m_end.incrementIndexes(count, flags);
     m_cacheIt = before;
+    m_rangeIndexValid = false;
     QT_QML_VERIFY_LISTCOMPOSITOR
     return before;
 }
@@ -604,6 +683,7 @@ void QQmlListCompositor::setFlags(
         *from = erase(*from)->previous;
     }
     m_cacheIt = from;
+    m_rangeIndexValid = false;
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
@@ -719,6 +799,7 @@ void QQmlListCompositor::clearFlags(
         *from = erase(*from)->previous;
     }
     m_cacheIt = from;
+    m_rangeIndexValid = false;
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
@@ -924,6 +1005,7 @@ void QQmlListCompositor::move(
     }
 
     m_cacheIt = toIt;
+    m_rangeIndexValid = false;
 
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
@@ -938,6 +1020,7 @@ void QQmlListCompositor::clear()
     for (Range *range = m_ranges.next; range != &m_ranges; range = erase(range)) {}
     m_end = iterator(m_ranges.next, 0, Default, m_groupCount);
     m_cacheIt = m_end;
+    m_rangeIndexValid = false;
 }
 
 void QQmlListCompositor::listItemsInserted(
@@ -1033,6 +1116,7 @@ void QQmlListCompositor::listItemsInserted(
         it.incrementIndexes(it->count);
     }
     m_cacheIt = m_end;
+    m_rangeIndexValid = false;
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
@@ -1223,6 +1307,7 @@ void QQmlListCompositor::listItemsRemoved(
         }
     }
     m_cacheIt = m_end;
+    m_rangeIndexValid = false;
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
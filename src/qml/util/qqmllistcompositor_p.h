@@ -267,9 +267,18 @@ private:
     int m_removeFlags;
     int m_moveId;
 
+    // Ranges in order and the group indexes at the start of each, for binary searching far
+    // away indexes.  Rebuilt on demand after the ranges change.
+    QVector<Range *> m_rangeIndex;
+    QVector<int> m_rangeGroupIndexes;
+    bool m_rangeIndexValid;
+
     inline Range *insert(Range *before, void *list, int index, int count, uint flags);
     inline Range *erase(Range *range);
 
+    void updateRangeIndex();
+    iterator findIndexed(Group group, int index);
+
     struct MovedFlags
     {
         MovedFlags() {}
@@ -27,6 +27,8 @@ HEADERS += \
     $$PWD/qquicktextedit_p.h \
     $$PWD/qquicktextedit_p_p.h \
     $$PWD/qquicktextutil_p.h \
+    $$PWD/qquicktextlayoutcache_p.h \
+    $$PWD/qquicktextlayoutjob_p.h \
     $$PWD/qquickimagebase_p.h \
     $$PWD/qquickimagebase_p_p.h \
     $$PWD/qquickimage_p.h \
@@ -99,6 +101,8 @@ SOURCES += \
     $$PWD/qquicktextdocument.cpp \
     $$PWD/qquicktextedit.cpp \
     $$PWD/qquicktextutil.cpp \
+    $$PWD/qquicktextlayoutcache.cpp \
+    $$PWD/qquicktextlayoutjob.cpp \
     $$PWD/qquickimagebase.cpp \
     $$PWD/qquickimage.cpp \
     $$PWD/qquickborderimage.cpp \
@@ -331,6 +331,7 @@ void QQuickBorderImage::load()
             d->pix.load(qmlEngine(this), loadUrl, d->sourcesize * d->devicePixelRatio, options);
 
             if (d->pix.isLoading()) {
+                d->pix.setLoadPriority(d->loadPriority());
                 if (d->progress != 0.0) {
                     d->progress = 0.0;
                     emit progressChanged(d->progress);
@@ -467,6 +468,7 @@ void QQuickBorderImage::setGridScaledImage(const QQuickGridScaledImage& sci)
         d->pix.load(qmlEngine(this), d->sciurl, options);
 
         if (d->pix.isLoading()) {
+            d->pix.setLoadPriority(d->loadPriority());
             if (d->progress != 0.0) {
                 d->progress = 0.0;
                 emit progressChanged(d->progress);
@@ -37,6 +37,8 @@
 #include <QtQuick/qsgtextureprovider.h>
 
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qsgtexture_p.h>
+#include <QtQuick/private/qsgatlastexture_p.h>
 #include <private/qsgadaptationlayer_p.h>
 
 #include <QtCore/qmath.h>
@@ -52,12 +54,18 @@ public:
     QQuickImageTextureProvider()
         : m_texture(0)
         , m_smooth(false)
+        , m_uploadPending(false)
     {
     }
 
-    void updateTexture(QSGTexture *texture) {
-        if (m_texture == texture)
+    void updateTexture(QSGTexture *texture, bool uploadPending = false) {
+        // Consumers draw again when a pending upload is done.
+        if (m_texture == texture && m_uploadPending == uploadPending)
             return;
+        m_uploadPending = uploadPending;
+        // Users of the provider may hold on to the atlas sub rect.
+        if (QSGAtlasTexture::Texture *atlasTexture = qobject_cast<QSGAtlasTexture::Texture *>(texture))
+            atlasTexture->setRelocatable(false);
         m_texture = texture;
         emit textureChanged();
     }
@@ -77,6 +85,7 @@ public:
     QSGTexture *m_texture;
     bool m_smooth;
     bool m_mipmap;
+    bool m_uploadPending;
 };
 
 #include "qquickimage.moc"
@@ -90,6 +99,7 @@ QQuickImagePrivate::QQuickImagePrivate()
     , hAlign(QQuickImage::AlignHCenter)
     , vAlign(QQuickImage::AlignVCenter)
     , provider(0)
+    , shownTextureFactory(0)
 {
 }
 
@@ -141,6 +151,25 @@ QQuickImagePrivate::QQuickImagePrivate()
     Images are cached and shared internally, so if several Image items have the same \l source,
     only one copy of the image will be loaded.
 
+    Images that are no longer used stay in the cache for a while, within a budget for the
+    decoded image memory and one for the texture memory they keep alive. The budgets
+    default to 2048 KB and 4096 KB, and can be changed with the
+    \c QML_PIXMAP_CACHE_IMAGE_LIMIT and \c QML_PIXMAP_CACHE_TEXTURE_LIMIT environment
+    variables, in kilobytes. Additionally, the encoded data of images downloaded from the
+    network is kept within \c QML_PIXMAP_CACHE_ORIGINALS_LIMIT, 2048 KB by default, so
+    that evicted images are decoded again without another download. Unused decoded images
+    are released when the application is suspended, and QQuickWindow::releaseResources()
+    releases everything that is not in use.
+
+    Textures stored in KTX or PKM files, for example ETC1 or ETC2 compressed data, are
+    memory mapped and passed to the graphics hardware as they are, without being decoded.
+    The same applies to KTX files that hold uncompressed \c GL_RGBA or \c GL_RGB data with
+    \c GL_UNSIGNED_BYTE components, which must have premultiplied alpha. Such files load
+    much faster than PNG or JPEG files and, when compressed, use less graphics memory.
+    Only the first mipmap level is used, and \l sourceSize does not scale them. If the
+    OpenGL implementation does not support the compressed format, nothing is shown and a
+    warning is printed.
+
     \b Note: Images are often the greatest user of memory in QML user interfaces.  It is recommended
     that images which do not form part of the user interface have their
     size bounded via the \l sourceSize property. This is especially important for content
@@ -455,6 +484,15 @@ qreal QQuickImage::paintedHeight() const
     maintaining a responsive user interface is more desirable
     than having images immediately visible.
 
+    Asynchronous images are decoded by a small pool of threads, at most
+    four by default. The \c QML_PIXMAP_DECODE_THREADS environment variable
+    overrides the number of threads. The decoders share the worker threads of
+    Qt Quick, so the number is capped by the size of that pool, which can be
+    raised with the \c QML_WORKER_THREADS environment variable. Requests from
+    visible images are served before those from hidden ones, and requests from
+    images that are destroyed before loading starts are dropped without
+    decoding.
+
     Note that this property is only valid for images read from the
     local filesystem.  Images loaded via a network resource (e.g. HTTP)
     are always loaded asynchronously.
@@ -567,7 +605,9 @@ QSGTextureProvider *QQuickImage::textureProvider() const
         dd->provider = new QQuickImageTextureProvider;
         dd->provider->m_smooth = d->smooth;
         dd->provider->m_mipmap = d->mipmap;
-        dd->provider->updateTexture(d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window()));
+        QSGRenderContext *rc = d->sceneGraphRenderContext();
+        dd->provider->updateTexture(d->async ? rc->asynchronousTextureForFactory(d->pix.textureFactory(), window())
+                                             : rc->textureForFactory(d->pix.textureFactory(), window()));
     }
 
     return d->provider;
@@ -593,17 +633,46 @@ QSGNode *QQuickImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
 {
     Q_D(QQuickImage);
 
-    QSGTexture *texture = d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window());
+    QSGRenderContext *rc = d->sceneGraphRenderContext();
+    QSGTexture *texture = 0;
+    bool uploadPending = false;
+
+    // Asynchronous images accept that their texture is shown once its upload
+    // is done, a new frame is requested for that. They get a texture of their
+    // own, so other users of the same image are not affected.
+    if (d->async) {
+        texture = rc->asynchronousTextureForFactory(d->pix.textureFactory(), window());
+        if (QSGPlainTexture *plainTexture = qobject_cast<QSGPlainTexture *>(texture)) {
+            if (plainTexture->asynchronousUpload()) {
+                connect(plainTexture, &QSGPlainTexture::asynchronousUploadReady, this, &QQuickItem::update,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::UniqueConnection));
+                uploadPending = !plainTexture->prepareTexture();
+            }
+        }
+
+        // The previous image stays on screen, and in the texture provider,
+        // until the new one has been loaded and uploaded.
+        if (oldNode && d->shownTextureFactory
+                && d->previousPix.textureFactory() == d->shownTextureFactory
+                && (d->pix.isLoading() || uploadPending)) {
+            return oldNode;
+        }
+        if (!d->previousPix.isNull())
+            QMetaObject::invokeMethod(this, "releasePreviousPixmap", Qt::QueuedConnection);
+    } else {
+        texture = rc->textureForFactory(d->pix.textureFactory(), window());
+    }
 
     // Copy over the current texture state into the texture provider...
     if (d->provider) {
         d->provider->m_smooth = d->smooth;
         d->provider->m_mipmap = d->mipmap;
-        d->provider->updateTexture(texture);
+        d->provider->updateTexture(texture, uploadPending);
     }
 
     if (!texture || width() <= 0 || height() <= 0) {
         delete oldNode;
+        d->shownTextureFactory = 0;
         return 0;
     }
 
@@ -712,6 +781,7 @@ QSGNode *QQuickImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
         || nsrect.isEmpty()
         || !qIsFinite(nsrect.width()) || !qIsFinite(nsrect.height())) {
         delete node;
+        d->shownTextureFactory = 0;
         return 0;
     }
 
@@ -737,9 +807,31 @@ QSGNode *QQuickImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
     node->setAntialiasing(d->antialiasing);
     node->update();
 
+    d->shownTextureFactory = d->pix.textureFactory();
     return node;
 }
 
+void QQuickImage::load()
+{
+    Q_D(QQuickImage);
+
+    // An asynchronous image holds on to the image it shows until the next
+    // one can be shown.
+    if (d->async && d->pix.textureFactory() && d->pix.textureFactory() == d->shownTextureFactory)
+        d->previousPix.setPixmap(d->pix);
+
+    QQuickImageBase::load();
+}
+
+void QQuickImage::releasePreviousPixmap()
+{
+    Q_D(QQuickImage);
+
+    // The image may have been shown again since the release was requested.
+    if (d->previousPix.textureFactory() != d->shownTextureFactory)
+        d->previousPix.clear();
+}
+
 void QQuickImage::pixmapChange()
 {
     Q_D(QQuickImage);
@@ -836,4 +928,52 @@ void QQuickImage::setMipmap(bool use)
     By default, this property is set to false.
  */
 
+/*!
+    \qmlproperty rect QtQuick::Image::sourceClipRect
+    \since 5.7
+
+    This property, if set, holds the rectangular region of the source image
+    to be loaded.
+
+    The rectangle is in the pixel coordinates of the full-size source image,
+    before any transformation from \l autoTransform. \l sourceSize then
+    applies to the clipped region. Decoders that support it, such as the
+    JPEG decoder, only decode the requested region, which makes it possible
+    to show parts of very large images without decoding them completely.
+
+    The property is ignored for images from a QQuickImageProvider.
+
+    \code
+    Image {
+        source: "large-photo.jpg"
+        sourceClipRect: Qt.rect(1200, 800, 640, 480)
+    }
+    \endcode
+
+    By default, the whole image is loaded.
+ */
+
+QRectF QQuickImage::sourceClipRect() const
+{
+    Q_D(const QQuickImage);
+    return d->sourceClipRect;
+}
+
+void QQuickImage::setSourceClipRect(const QRectF &rect)
+{
+    Q_D(QQuickImage);
+    if (d->sourceClipRect == rect)
+        return;
+
+    d->sourceClipRect = rect;
+    emit sourceClipRectChanged();
+    if (isComponentComplete())
+        load();
+}
+
+void QQuickImage::resetSourceClipRect()
+{
+    setSourceClipRect(QRectF());
+}
+
 QT_END_NAMESPACE
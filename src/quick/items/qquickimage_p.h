@@ -62,6 +62,7 @@ class Q_QUICK_PRIVATE_EXPORT QQuickImage : public QQuickImageBase
     Q_PROPERTY(VAlignment verticalAlignment READ verticalAlignment WRITE setVerticalAlignment NOTIFY verticalAlignmentChanged)
     Q_PROPERTY(bool mipmap READ mipmap WRITE setMipmap NOTIFY mipmapChanged REVISION 1)
     Q_PROPERTY(bool autoTransform READ autoTransform WRITE setAutoTransform NOTIFY autoTransformChanged REVISION 2)
+    Q_PROPERTY(QRectF sourceClipRect READ sourceClipRect WRITE setSourceClipRect RESET resetSourceClipRect NOTIFY sourceClipRectChanged REVISION 3)
 
 public:
     QQuickImage(QQuickItem *parent=0);
@@ -99,6 +100,10 @@ public:
     bool mipmap() const;
     void setMipmap(bool use);
 
+    QRectF sourceClipRect() const;
+    void setSourceClipRect(const QRectF &rect);
+    void resetSourceClipRect();
+
     virtual void emitAutoTransformBaseChanged() Q_DECL_OVERRIDE { emit autoTransformChanged(); }
 
 Q_SIGNALS:
@@ -108,12 +113,15 @@ Q_SIGNALS:
     void verticalAlignmentChanged(VAlignment alignment);
     Q_REVISION(1) void mipmapChanged(bool);
     Q_REVISION(2) void autoTransformChanged();
+    Q_REVISION(3) void sourceClipRectChanged();
 
 private Q_SLOTS:
     void invalidateSceneGraph();
+    void releasePreviousPixmap();
 
 protected:
     QQuickImage(QQuickImagePrivate &dd, QQuickItem *parent);
+    void load() Q_DECL_OVERRIDE;
     void pixmapChange() Q_DECL_OVERRIDE;
     void updatePaintedGeometry();
     void releaseResources() Q_DECL_OVERRIDE;
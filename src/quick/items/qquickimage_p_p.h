@@ -71,6 +71,11 @@ public:
     QQuickImage::VAlignment vAlign;
 
     QQuickImageTextureProvider *provider;
+
+    // The image an asynchronous Image shows while the next one is loaded and
+    // uploaded, and the texture factory of the image on screen.
+    QQuickPixmap previousPix;
+    QQuickTextureFactory *shownTextureFactory;
 };
 
 QT_END_NAMESPACE
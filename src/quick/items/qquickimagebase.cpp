@@ -43,6 +43,14 @@
 
 QT_BEGIN_NAMESPACE
 
+// Images that are on screen are decoded before those hidden or not yet in a window,
+// such as delegates a view creates ahead of time.
+QQuickPixmap::LoadPriority QQuickImageBasePrivate::loadPriority() const
+{
+    Q_Q(const QQuickImageBase);
+    return q->isVisible() && q->window() ? QQuickPixmap::HighPriority : QQuickPixmap::LowPriority;
+}
+
 QQuickImageBase::QQuickImageBase(QQuickItem *parent)
 : QQuickImplicitSizeItem(*(new QQuickImageBasePrivate), parent)
 {
@@ -240,9 +248,16 @@ void QQuickImageBase::load()
             resolve2xLocalFile(d->url, targetDevicePixelRatio, &loadUrl, &d->devicePixelRatio);
         }
 
-        d->pix.load(qmlEngine(this), loadUrl, d->sourcesize * d->devicePixelRatio, options, d->autoTransform);
+        QRect requestRegion;
+        if (d->sourceClipRect.isValid()) {
+            requestRegion = QRectF(d->sourceClipRect.topLeft() * d->devicePixelRatio,
+                                   d->sourceClipRect.size() * d->devicePixelRatio).toAlignedRect();
+        }
+
+        d->pix.load(qmlEngine(this), loadUrl, requestRegion, d->sourcesize * d->devicePixelRatio, options, d->autoTransform);
 
         if (d->pix.isLoading()) {
+            d->pix.setLoadPriority(d->loadPriority());
             if (d->progress != 0.0) {
                 d->progress = 0.0;
                 emit progressChanged(d->progress);
@@ -313,8 +328,11 @@ void QQuickImageBase::requestProgress(qint64 received, qint64 total)
 
 void QQuickImageBase::itemChange(ItemChange change, const ItemChangeData &value)
 {
+    Q_D(QQuickImageBase);
     if (change == ItemSceneChange && value.window)
         connect(value.window, &QQuickWindow::screenChanged, this, &QQuickImageBase::handleScreenChanged);
+    if ((change == ItemSceneChange || change == ItemVisibleHasChanged) && d->pix.isLoading())
+        d->pix.setLoadPriority(d->loadPriority());
     QQuickItem::itemChange(change, value);
 }
 
@@ -70,12 +70,15 @@ public:
     {
     }
 
+    QQuickPixmap::LoadPriority loadPriority() const;
+
     QQuickPixmap pix;
     QQuickImageBase::Status status;
     QUrl url;
     qreal progress;
     QSize sourcesize;
     QSize oldSourceSize;
+    QRectF sourceClipRect;
     qreal devicePixelRatio;
     AutoTransform autoTransform;
     bool async : 1;
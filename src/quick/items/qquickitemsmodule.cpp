@@ -274,6 +274,10 @@ static void qt_quickitems_defineModule(const char *uri, int major, int minor)
     qmlRegisterUncreatableType<QQuickEnterKeyAttached, 6>(uri, 2, 6, "EnterKey",
                                                            QQuickEnterKeyAttached::tr("EnterKey is only available via attached properties"));
     qmlRegisterType<QQuickShaderEffectSource, 1>(uri, 2, 6, "ShaderEffectSource");
+
+    qmlRegisterType<QQuickImage, 3>(uri, 2, 7, "Image");
+    qmlRegisterType<QQuickText, 7>(uri, 2, 7, "Text");
+    qmlRegisterType<QQuickListView, 3>(uri, 2, 7, "ListView");
 }
 
 static void initResources()
@@ -248,6 +248,175 @@ void QQuickItemViewChangeSet::reset()
 
 //-----------------------------------
 
+QQuickItemViewExtentIndex::QQuickItemViewExtentIndex()
+    : m_dirty(false), m_unrequested(false)
+{
+}
+
+void QQuickItemViewExtentIndex::clear()
+{
+    m_extents.clear();
+    m_sums.clear();
+    m_counts.clear();
+    m_dirty = false;
+    m_unrequested = false;
+}
+
+void QQuickItemViewExtentIndex::resize(int count)
+{
+    const int oldCount = m_extents.count();
+    if (count == oldCount)
+        return;
+    m_extents.resize(count);
+    for (int i = oldCount; i < count; ++i)
+        m_extents[i] = Unrequested;
+    m_unrequested |= count > oldCount;
+    m_dirty = true;
+}
+
+void QQuickItemViewExtentIndex::insert(int index, int count)
+{
+    if (count <= 0)
+        return;
+    m_extents.insert(qBound(0, index, m_extents.count()), count, Unrequested);
+    m_unrequested = true;
+    m_dirty = true;
+}
+
+void QQuickItemViewExtentIndex::remove(int index, int count)
+{
+    index = qBound(0, index, m_extents.count());
+    count = qMin(count, m_extents.count() - index);
+    if (count <= 0)
+        return;
+    m_extents.remove(index, count);
+    m_dirty = true;
+}
+
+void QQuickItemViewExtentIndex::reset(int index, int count)
+{
+    index = qBound(0, index, m_extents.count());
+    count = qMin(count, m_extents.count() - index);
+    if (count <= 0)
+        return;
+    for (int i = index; i < index + count; ++i)
+        m_extents[i] = Unrequested;
+    m_unrequested = true;
+    m_dirty = true;
+}
+
+qreal QQuickItemViewExtentIndex::extent(int index) const
+{
+    return m_extents.at(index);
+}
+
+void QQuickItemViewExtentIndex::setExtent(int index, qreal extent)
+{
+    extent = qMax(qreal(0), extent);
+    const qreal oldExtent = m_extents.at(index);
+    if (oldExtent == extent)
+        return;
+    m_extents[index] = extent;
+    if (m_dirty)
+        return;
+
+    const qreal delta = oldExtent >= 0 ? extent - oldExtent : extent;
+    const int known = oldExtent >= 0 ? 0 : 1;
+    for (int i = index + 1; i <= m_extents.count(); i += i & -i) {
+        m_sums[i] += delta;
+        m_counts[i] += known;
+    }
+}
+
+void QQuickItemViewExtentIndex::setExtentHint(int index, qreal hint)
+{
+    if (m_extents.at(index) != Unrequested)
+        return;
+    if (hint >= 0) {
+        setExtent(index, hint);
+    } else {
+        // both states count as unknown, so the trees are unaffected
+        m_extents[index] = Unknown;
+    }
+}
+
+// Returns the start of item index relative to the start of item 0, using
+// defaultExtent for every item whose extent is not known. Indexes outside
+// the model are extrapolated.
+qreal QQuickItemViewExtentIndex::prefix(int index, qreal defaultExtent, qreal spacing) const
+{
+    const int count = m_extents.count();
+    if (index <= 0)
+        return index * (defaultExtent + spacing);
+    if (m_dirty)
+        rebuild();
+
+    const int last = qMin(index, count);
+    qreal sum = 0;
+    int known = 0;
+    for (int i = last; i > 0; i -= i & -i) {
+        sum += m_sums.at(i);
+        known += m_counts.at(i);
+    }
+    return sum + (last - known) * defaultExtent + last * spacing
+            + (index - last) * (defaultExtent + spacing);
+}
+
+// Returns the item at pos, i.e. the last item starting at or before pos.
+int QQuickItemViewExtentIndex::indexAt(qreal pos, qreal defaultExtent, qreal spacing) const
+{
+    const int count = m_extents.count();
+    if (!count)
+        return -1;
+    if (m_dirty)
+        rebuild();
+
+    int bit = 1;
+    while (bit * 2 <= count)
+        bit *= 2;
+
+    int index = 0;
+    qreal sum = 0;
+    int known = 0;
+    for (; bit > 0; bit /= 2) {
+        const int next = index + bit;
+        if (next > count)
+            continue;
+        const qreal nextSum = sum + m_sums.at(next);
+        const int nextKnown = known + m_counts.at(next);
+        if (nextSum + (next - nextKnown) * defaultExtent + next * spacing <= pos) {
+            index = next;
+            sum = nextSum;
+            known = nextKnown;
+        }
+    }
+    return qMin(index, count - 1);
+}
+
+void QQuickItemViewExtentIndex::rebuild() const
+{
+    const int count = m_extents.count();
+    m_sums.fill(0, count + 1);
+    m_counts.fill(0, count + 1);
+    for (int i = 0; i < count; ++i) {
+        const qreal extent = m_extents.at(i);
+        if (extent >= 0) {
+            m_sums[i + 1] = extent;
+            m_counts[i + 1] = 1;
+        }
+    }
+    for (int i = 1; i <= count; ++i) {
+        const int parent = i + (i & -i);
+        if (parent <= count) {
+            m_sums[parent] += m_sums.at(i);
+            m_counts[parent] += m_counts.at(i);
+        }
+    }
+    m_dirty = false;
+}
+
+//-----------------------------------
+
 QQuickItemView::QQuickItemView(QQuickFlickablePrivate &dd, QQuickItem *parent)
     : QQuickFlickable(dd, parent)
 {
@@ -1176,6 +1345,30 @@ void QQuickItemViewPrivate::showVisibleItems() const
     }
 }
 
+// Brings the extent index in line with itemCount and asks for the size hints
+// of any indexes that have been added since the last sync.
+void QQuickItemViewPrivate::syncExtentIndex()
+{
+    if (!usesExtentIndex() || !model) {
+        extentIndex.clear();
+        return;
+    }
+    extentIndex.resize(itemCount);
+    if (extentIndex.hasUnrequestedExtents()) {
+        for (int i = 0; i < itemCount; ++i) {
+            if (!extentIndex.isExtentRequested(i))
+                extentIndex.setExtentHint(i, extentHint(i));
+        }
+        extentIndex.markRequested();
+    }
+}
+
+void QQuickItemViewPrivate::recordExtent(const FxViewItem *item)
+{
+    if (item && item->index >= 0 && hasExtentIndex() && item->index < itemCount)
+        extentIndex.setExtent(item->index, item->size());
+}
+
 void QQuickItemViewPrivate::itemGeometryChanged(QQuickItem *item, const QRectF &newGeometry, const QRectF &oldGeometry)
 {
     Q_Q(QQuickItemView);
@@ -1734,6 +1927,7 @@ void QQuickItemViewPrivate::clear()
     }
 
     markExtentsDirty();
+    extentIndex.clear();
     itemCount = 0;
 }
 
@@ -1772,6 +1966,7 @@ void QQuickItemViewPrivate::refill(qreal from, qreal to)
 
     int prevCount = itemCount;
     itemCount = model->count();
+    syncExtentIndex();
     qreal bufferFrom = from - buffer;
     qreal bufferTo = to + buffer;
     qreal fillFrom = from;
@@ -1977,6 +2172,10 @@ bool QQuickItemViewPrivate::applyModelChanges(ChangeResult *totalInsertionResult
 
     int removedCount = 0;
     for (int i=0; i<removals.count(); i++) {
+        if (hasExtentIndex())
+            extentIndex.remove(removals[i].index, removals[i].count);
+        else
+            extentIndex.clear();
         itemCount -= removals[i].count;
         if (applyRemovalChange(removals[i], &removalResult, &removedCount))
             visibleAffected = true;
@@ -2019,6 +2218,11 @@ bool QQuickItemViewPrivate::applyModelChanges(ChangeResult *totalInsertionResult
 
     for (int i=0; i<insertions.count(); i++) {
         bool wasEmpty = visibleItems.isEmpty();
+        // the index stays out of use until itemCount catches up below
+        if (hasExtentIndex())
+            extentIndex.insert(insertions[i].index, insertions[i].count);
+        else
+            extentIndex.clear();
         if (applyInsertionChange(insertions[i], &insertionResult, &newItems, &movingIntoView))
             visibleAffected = true;
         if (!visibleAffected && needsRefillForAddedOrRemovedIndex(insertions[i].index))
@@ -2080,6 +2284,13 @@ bool QQuickItemViewPrivate::applyModelChanges(ChangeResult *totalInsertionResult
 
     if (!visibleAffected)
         visibleAffected = !currentChanges.pendingChanges.changes().isEmpty();
+    if (hasExtentIndex()) {
+        // changed data may carry a different size hint
+        const QVector<QQmlChangeSet::Change> &changes = currentChanges.pendingChanges.changes();
+        for (int i = 0; i < changes.count(); ++i)
+            extentIndex.reset(changes[i].index, changes[i].count);
+    }
+    syncExtentIndex();
     currentChanges.reset();
 
     updateSections();
@@ -123,6 +123,48 @@ public:
 };
 
 
+// Extents of every model index along the flow, as far as they are known from
+// size hints or from delegates that have been laid out. Unknown extents are
+// substituted with a default size. Prefix sums and position lookups are
+// answered from a pair of Fenwick trees in O(log n); structural changes only
+// mark the trees dirty, and they are rebuilt on the next query.
+class Q_AUTOTEST_EXPORT QQuickItemViewExtentIndex
+{
+public:
+    QQuickItemViewExtentIndex();
+
+    int count() const { return m_extents.count(); }
+    bool isEmpty() const { return m_extents.isEmpty(); }
+    bool hasUnrequestedExtents() const { return m_unrequested; }
+
+    void clear();
+    void resize(int count);
+    void insert(int index, int count);
+    void remove(int index, int count);
+    void reset(int index, int count);
+
+    qreal extent(int index) const;
+    void setExtent(int index, qreal extent);
+    void setExtentHint(int index, qreal hint);
+    bool isExtentRequested(int index) const { return m_extents.at(index) != Unrequested; }
+    void markRequested() { m_unrequested = false; }
+
+    qreal prefix(int index, qreal defaultExtent, qreal spacing) const;
+    int indexAt(qreal pos, qreal defaultExtent, qreal spacing) const;
+
+private:
+    enum { Unrequested = -1, Unknown = -2 };
+
+    void rebuild() const;
+
+    QVector<qreal> m_extents;
+    mutable QVector<qreal> m_sums;
+    mutable QVector<int> m_counts;
+    mutable bool m_dirty;
+    bool m_unrequested;
+};
+
+
 class Q_AUTOTEST_EXPORT QQuickItemViewPrivate : public QQuickFlickablePrivate, public QQuickItemViewTransitionChangeListener, public QAnimationJobChangeListener
 {
     Q_DECLARE_PUBLIC(QQuickItemView)
@@ -233,6 +275,10 @@ public:
     void checkVisible() const;
     void showVisibleItems() const;
 
+    void syncExtentIndex();
+    void recordExtent(const FxViewItem *item);
+    bool hasExtentIndex() const { return !extentIndex.isEmpty() && extentIndex.count() == itemCount; }
+
     void markExtentsDirty() {
         if (layoutOrientation() == Qt::Vertical)
             vData.markExtentsDirty();
@@ -281,6 +327,7 @@ public:
     QQuickItemViewChangeSet currentChanges;
     QQuickItemViewChangeSet bufferedChanges;
     QPauseAnimationJob bufferPause;
+    QQuickItemViewExtentIndex extentIndex;
 
     QQmlComponent *highlightComponent;
     FxViewItem *highlight;
@@ -363,6 +410,8 @@ protected:
                 QList<FxViewItem *> *newItems, QList<MovedItem> *movingIntoView) = 0;
 
     virtual bool needsRefillForAddedOrRemovedIndex(int) const { return false; }
+    virtual bool usesExtentIndex() const { return false; }
+    virtual qreal extentHint(int) const { return -1; }
     virtual void translateAndTransitionItemsAfter(int afterIndex, const ChangeResult &insertionResult, const ChangeResult &removalResult) = 0;
 
     virtual void initializeViewItem(FxViewItem *) {}
@@ -124,6 +124,9 @@ public:
     void initializeCurrentItem() Q_DECL_OVERRIDE;
 
     void updateAverage();
+    qreal extentBetween(int from, int to) const;
+    bool usesExtentIndex() const Q_DECL_OVERRIDE { return !sizeHintRole.isEmpty(); }
+    qreal extentHint(int modelIndex) const Q_DECL_OVERRIDE;
 
     void itemGeometryChanged(QQuickItem *item, const QRectF &newGeometry, const QRectF &oldGeometry) Q_DECL_OVERRIDE;
     void fixupPosition() Q_DECL_OVERRIDE;
@@ -139,6 +142,7 @@ public:
 
     QQuickListView::HeaderPositioning headerPositioning;
     QQuickListView::FooterPositioning footerPositioning;
+    QString sizeHintRole;
 
     QSmoothedAnimation *highlightPosAnimator;
     QSmoothedAnimation *highlightWidthAnimator;
@@ -420,7 +424,7 @@ qreal QQuickListViewPrivate::originPosition() const
     if (!visibleItems.isEmpty()) {
         pos = (*visibleItems.constBegin())->position();
         if (visibleIndex > 0)
-            pos -= visibleIndex * (averageSize + spacing);
+            pos -= extentBetween(0, visibleIndex);
     }
     return pos;
 }
@@ -446,9 +450,9 @@ qreal QQuickListViewPrivate::lastPosition() const
         }
         pos = (*(--visibleItems.constEnd()))->endPosition();
         if (invisibleCount > 0)
-            pos += invisibleCount * (averageSize + spacing);
+            pos += extentBetween(model->count() - invisibleCount, model->count());
     } else if (model && model->count()) {
-        pos = (model->count() * averageSize + (model->count()-1) * spacing);
+        pos = extentBetween(0, model->count()) - spacing;
     }
     return pos;
 }
@@ -460,16 +464,16 @@ qreal QQuickListViewPrivate::positionAt(int modelIndex) const
     }
     if (!visibleItems.isEmpty()) {
         if (modelIndex < visibleIndex) {
-            int count = visibleIndex - modelIndex;
+            int from = modelIndex;
             qreal cs = 0;
             if (modelIndex == currentIndex && currentItem) {
                 cs = currentItem->size() + spacing;
-                --count;
+                ++from;
             }
-            return (*visibleItems.constBegin())->position() - count * (averageSize + spacing) - cs;
+            return (*visibleItems.constBegin())->position() - extentBetween(from, visibleIndex) - cs;
         } else {
-            int count = modelIndex - findLastVisibleIndex(visibleIndex) - 1;
-            return (*(--visibleItems.constEnd()))->endPosition() + spacing + count * (averageSize + spacing);
+            int from = findLastVisibleIndex(visibleIndex) + 1;
+            return (*(--visibleItems.constEnd()))->endPosition() + spacing + extentBetween(from, modelIndex);
         }
     }
     return 0;
@@ -481,10 +485,12 @@ qreal QQuickListViewPrivate::endPositionAt(int modelIndex) const
         return item->endPosition();
     if (!visibleItems.isEmpty()) {
         if (modelIndex < visibleIndex) {
-            int count = visibleIndex - modelIndex;
-            return (*visibleItems.constBegin())->position() - (count - 1) * (averageSize + spacing) - spacing;
+            return (*visibleItems.constBegin())->position() - extentBetween(modelIndex + 1, visibleIndex) - spacing;
         } else {
-            int count = modelIndex - findLastVisibleIndex(visibleIndex) - 1;
+            int from = findLastVisibleIndex(visibleIndex) + 1;
+            if (hasExtentIndex())
+                return (*(--visibleItems.constEnd()))->endPosition() + extentBetween(from, modelIndex + 1);
+            int count = modelIndex - from;
             return (*(--visibleItems.constEnd()))->endPosition() + count * (averageSize + spacing);
         }
     }
@@ -650,16 +656,21 @@ bool QQuickListViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
         || bufferTo < visiblePos - averageSize - spacing)) {
         // We've jumped more than a page.  Estimate which items are now
         // visible and fill from there.
-        int count = (fillFrom - itemEnd) / (averageSize + spacing);
-        int newModelIdx = qBound(0, modelIndex + count, model->count());
-        count = newModelIdx - modelIndex;
-        if (count) {
+        int newModelIdx;
+        if (hasExtentIndex()) {
+            qreal origin = itemEnd - extentIndex.prefix(modelIndex, averageSize, spacing);
+            newModelIdx = extentIndex.indexAt(fillFrom - origin, averageSize, spacing);
+        } else {
+            int count = (fillFrom - itemEnd) / (averageSize + spacing);
+            newModelIdx = qBound(0, modelIndex + count, model->count());
+        }
+        if (newModelIdx != modelIndex) {
             for (int i = 0; i < visibleItems.count(); ++i)
                 releaseItem(visibleItems.at(i));
             visibleItems.clear();
+            visiblePos = itemEnd + extentBetween(modelIndex, newModelIdx);
             modelIndex = newModelIdx;
             visibleIndex = modelIndex;
-            visiblePos = itemEnd + count * (averageSize + spacing);
             itemEnd = visiblePos;
         }
     }
@@ -780,6 +791,7 @@ void QQuickListViewPrivate::layoutVisibleItems(int fromModelIndex)
 
         FxViewItem *firstItem = *visibleItems.constBegin();
         bool fixedCurrent = currentItem && firstItem->item == currentItem->item;
+        recordExtent(firstItem);
         qreal sum = firstItem->size();
         qreal pos = firstItem->position() + firstItem->size() + spacing;
         firstItem->setVisible(firstItem->endPosition() >= from && firstItem->position() <= to);
@@ -790,6 +802,7 @@ void QQuickListViewPrivate::layoutVisibleItems(int fromModelIndex)
                 item->setPosition(pos);
                 item->setVisible(item->endPosition() >= from && item->position() <= to);
             }
+            recordExtent(item);
             pos += item->size() + spacing;
             sum += item->size();
             fixedCurrent = fixedCurrent || (currentItem && item->item == currentItem->item);
@@ -1282,9 +1295,27 @@ void QQuickListViewPrivate::updateAverage()
     if (!visibleItems.count())
         return;
     qreal sum = 0.0;
-    for (int i = 0; i < visibleItems.count(); ++i)
+    for (int i = 0; i < visibleItems.count(); ++i) {
+        recordExtent(visibleItems.at(i));
         sum += visibleItems.at(i)->size();
+    }
     averageSize = qRound(sum / visibleItems.count());
+    recordExtent(currentItem);
+}
+
+// Returns the space taken by the items in [from, to), each followed by spacing.
+qreal QQuickListViewPrivate::extentBetween(int from, int to) const
+{
+    if (hasExtentIndex())
+        return extentIndex.prefix(to, averageSize, spacing) - extentIndex.prefix(from, averageSize, spacing);
+    return (to - from) * (averageSize + spacing);
+}
+
+qreal QQuickListViewPrivate::extentHint(int modelIndex) const
+{
+    bool ok = false;
+    qreal hint = model->stringValue(modelIndex, sizeHintRole).toDouble(&ok);
+    return ok ? hint : -1;
 }
 
 qreal QQuickListViewPrivate::headerSize() const
@@ -2558,6 +2589,48 @@ void QQuickListView::setFooterPositioning(QQuickListView::FooterPositioning posi
     }
 }
 
+/*!
+    \qmlproperty string QtQuick::ListView::sizeHintRole
+    \since 5.7
+
+    This property holds the name of a model role that provides the expected
+    size of each delegate along the orientation of the list.
+
+    By default a list view only knows the size of the delegates it has
+    created, and estimates the position of every other item from their
+    average size. For models with delegates of widely varying sizes this
+    makes the content size change while the list is scrolled, and
+    \l positionViewAtIndex() may take several passes to settle.
+
+    When this property is set, the list view reads the hint for every item
+    in the model and keeps an index of item sizes, replacing hints with the
+    actual size of delegates as they are created. Positions outside the
+    visible area are then computed from that index, so the content size and
+    any attached scroll bar remain stable. Items for which the role does not
+    hold a number fall back to the average delegate size.
+
+    The hint does not include the size of the \l section delegate.
+
+    By default this property is empty, and no hints are read.
+*/
+QString QQuickListView::sizeHintRole() const
+{
+    Q_D(const QQuickListView);
+    return d->sizeHintRole;
+}
+
+void QQuickListView::setSizeHintRole(const QString &role)
+{
+    Q_D(QQuickListView);
+    if (d->sizeHintRole != role) {
+        d->sizeHintRole = role;
+        d->extentIndex.clear();
+        if (isComponentComplete())
+            d->forceLayoutPolish();
+        emit sizeHintRoleChanged();
+    }
+}
+
 /*!
     \qmlproperty Transition QtQuick::ListView::populate
 
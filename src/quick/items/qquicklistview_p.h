@@ -116,6 +116,7 @@ class Q_AUTOTEST_EXPORT QQuickListView : public QQuickItemView
 
     Q_PROPERTY(HeaderPositioning headerPositioning READ headerPositioning WRITE setHeaderPositioning NOTIFY headerPositioningChanged REVISION 2)
     Q_PROPERTY(FooterPositioning footerPositioning READ footerPositioning WRITE setFooterPositioning NOTIFY footerPositioningChanged REVISION 2)
+    Q_PROPERTY(QString sizeHintRole READ sizeHintRole WRITE setSizeHintRole NOTIFY sizeHintRoleChanged REVISION 3)
 
     Q_CLASSINFO("DefaultProperty", "data")
 
@@ -162,6 +163,9 @@ public:
     FooterPositioning footerPositioning() const;
     void setFooterPositioning(FooterPositioning positioning);
 
+    QString sizeHintRole() const;
+    void setSizeHintRole(const QString &role);
+
     static QQuickListViewAttached *qmlAttachedProperties(QObject *);
 
 public Q_SLOTS:
@@ -178,6 +182,7 @@ Q_SIGNALS:
     void snapModeChanged();
     Q_REVISION(2) void headerPositioningChanged();
     Q_REVISION(2) void footerPositioningChanged();
+    Q_REVISION(3) void sizeHintRoleChanged();
 
 protected:
     void viewportMoved(Qt::Orientations orient) Q_DECL_OVERRIDE;
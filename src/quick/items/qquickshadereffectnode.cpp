@@ -36,6 +36,7 @@
 #include "qquickshadereffect_p.h"
 #include <QtQuick/qsgtextureprovider.h>
 #include <QtQuick/private/qsgrenderer_p.h>
+#include <QtQuick/private/qsgshaderdiskcache_p.h>
 #include <QtQuick/private/qsgshadersourcebuilder_p.h>
 #include <QtQuick/private/qsgtexture_p.h>
 #include <QtCore/qmutex.h>
@@ -253,6 +254,12 @@ void QQuickCustomMaterialShader::compile()
 
     m_log.clear();
     m_compiled = true;
+
+    QSGShaderDiskCache cache(QOpenGLContext::currentContext());
+    const QByteArray cacheKey = cache.key(vertexShader(), fragmentShader(), attributeNames());
+    if (cache.load(program(), cacheKey))
+        return;
+
     if (!program()->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader())) {
         m_log += QLatin1String("*** Vertex shader ***\n");
         m_log += program()->log();
@@ -289,8 +296,11 @@ void QQuickCustomMaterialShader::compile()
             if (*attr[i])
                 program()->bindAttributeLocation(attr[i], i);
         }
+        cache.prepare(program());
         m_compiled = program()->link();
         m_log += program()->log();
+        if (m_compiled)
+            cache.store(program(), cacheKey);
     }
 
     if (!m_compiled) {
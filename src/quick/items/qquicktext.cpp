@@ -53,6 +53,7 @@
 #include <QtGui/qtextcursor.h>
 #include <QtGui/qguiapplication.h>
 #include <QtGui/qinputmethod.h>
+#include <QtGui/qfontdatabase.h>
 
 #include <private/qtextengine_p.h>
 #include <private/qquickstyledtext_p.h>
@@ -104,6 +105,9 @@ QQuickTextPrivate::ExtraData::ExtraData()
     , lineHeightValid(false)
     , lineHeightMode(QQuickText::ProportionalHeight)
     , fontSizeMode(QQuickText::FixedSize)
+    , asynchronous(false)
+    , textRevision(0)
+    , layoutJob(0)
 {
 }
 
@@ -274,6 +278,8 @@ void QQuickTextPrivate::updateLayout()
                 }
                 layout.setText(tmp);
             }
+            if (extra.isAllocated())
+                ++extra->textRevision;
             textHasChanged = false;
         }
     } else if (extra.isAllocated() && extra->lineHeightValid) {
@@ -299,6 +305,25 @@ void QQuickTextPrivate::updateLayout()
     q->polish();
 }
 
+void QQuickText::asyncLayoutFinished(QQuickTextLayoutJob *job)
+{
+    Q_D(QQuickText);
+
+    // Results of jobs the item has moved on from are dropped.
+    if (!d->extra.isAllocated() || d->extra->layoutJob != job)
+        return;
+
+    d->extra->layoutJob = 0;
+    d->extra->asyncLayout = job->result;
+    d->extra->asyncLayoutInput = job->input;
+
+    // The font engines cached in the layout belong to the worker thread.
+    if (job->result->layout.engine() != 0)
+        job->result->layout.engine()->resetFontEngineCache();
+
+    d->updateSize();
+}
+
 void QQuickText::imageDownloadFinished()
 {
     Q_D(QQuickText);
@@ -369,6 +394,8 @@ void QQuickTextPrivate::updateSize()
         // There may be subtle differences in the height and baseline calculations between
         // QTextLayout and QFontMetrics and the number of variables that can affect the size
         // and position of a line is increasing.
+        sharedLayout.reset();
+        resetAsynchronousLayout();
         QFontMetricsF fm(font);
         qreal fontHeight = qCeil(fm.height());  // QScriptLine and therefore QTextLine rounds up
         if (!richText) {                        // line height, so we will as well.
@@ -390,6 +417,10 @@ void QQuickTextPrivate::updateSize()
 
     //setup instance of QTextLayout for all cases other than richtext
     if (!richText) {
+        // Keep the previous layout until the text has been laid out on a worker thread.
+        if (isAsynchronousLayout() && !updateAsynchronousLayout())
+            return;
+
         qreal baseline = 0;
         QRectF textRect = setupTextLayout(&baseline);
 
@@ -400,6 +431,8 @@ void QQuickTextPrivate::updateSize()
         size = textRect.size();
         updateBaseline(baseline, q->height() - size.height() - vPadding);
     } else {
+        sharedLayout.reset();
+        resetAsynchronousLayout();
         widthExceeded = true; // always relayout rich text on width changes..
         heightExceeded = false; // rich text layout isn't affected by height changes.
         ensureDoc();
@@ -584,23 +617,23 @@ void QQuickTextPrivate::elideFormats(
     }
 }
 
-QString QQuickTextPrivate::elidedText(qreal lineWidth, const QTextLine &line, QTextLine *nextLine) const
+QString QQuickTextPrivate::elidedText(const QTextLayout &textLayout, qreal lineWidth, const QTextLine &line, QTextLine *nextLine) const
 {
     if (nextLine) {
-        return layout.engine()->elidedText(
+        return textLayout.engine()->elidedText(
                 Qt::TextElideMode(elideMode),
                 QFixed::fromReal(lineWidth),
                 0,
                 line.textStart(),
                 line.textLength() + nextLine->textLength());
     } else {
-        QString elideText = layout.text().mid(line.textStart(), line.textLength());
+        QString elideText = textLayout.text().mid(line.textStart(), line.textLength());
         if (!styledText) {
             // QFontMetrics won't help eliding styled text.
             elideText[elideText.length() - 1] = elideChar;
             // Appending the elide character may push the line over the maximum width
             // in which case the elided text will need to be elided.
-            QFontMetricsF metrics(layout.font());
+            QFontMetricsF metrics(textLayout.font());
             if (metrics.width(elideChar) + line.naturalTextWidth() >= lineWidth)
                 elideText = metrics.elidedText(elideText, Qt::TextElideMode(elideMode), lineWidth);
         }
@@ -646,21 +679,258 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
         return QRectF(0, 0, 0, height);
     }
 
-    bool shouldUseDesignMetrics = renderType != QQuickText::NativeRendering;
     if (extra.isAllocated())
         extra->visibleImgTags.clear();
-    layout.setCacheEnabled(true);
-    QTextOption textOption = layout.textOption();
+
+    if (isAsynchronousLayout() && extra->asyncLayout)
+        return setupAsynchronousLayout(baseline);
+    resetAsynchronousLayout();
+
+    // Plain text that neither wraps nor changes its font size is laid out the same way in every
+    // item with the same text, font and geometry, so those items share their layouts.
+    const bool shareLayout = !styledText
+            && multilengthEos == -1
+            && wrapMode == QQuickText::NoWrap
+            && fontSizeMode() == QQuickText::FixedSize
+            && !maximumLineCountValid
+            && !multilineElide
+            && !isLineLaidOutConnected();
+    if (!shareLayout) {
+        sharedLayout.reset();
+        return setupTextLayout(layout, elideLayout, baseline);
+    }
+
+    QQuickTextLayoutCache *cache = QQuickTextLayoutCache::instance();
+    QQuickTextLayoutCache::Key key = layoutCacheKey();
+    QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> entry = cache->find(key);
+    if (entry) {
+        bool wasInLayout = internalWidthUpdate;
+        internalWidthUpdate = true;
+        q->setImplicitSize(entry->implicitSize.width(), entry->implicitSize.height());
+        internalWidthUpdate = wasInLayout;
+
+        // A binding to the implicit size may have changed the geometry the entry was laid out
+        // for, in which case the text is laid out again.
+        if (isLayoutCacheKeyCurrent(key)) {
+            setSharedLayout(entry);
+
+            lineWidth = entry->lineWidth;
+            widthExceeded = entry->widthExceeded;
+            heightExceeded = false;
+            implicitWidthValid = true;
+            implicitHeightValid = true;
+
+            if (lineCount != entry->lineCount) {
+                lineCount = entry->lineCount;
+                emit q->lineCountChanged();
+            }
+            if (truncated != entry->truncated) {
+                truncated = entry->truncated;
+                emit q->truncatedChanged();
+            }
+
+            *baseline = entry->baseline;
+            return entry->textRect;
+        }
+        key = layoutCacheKey();
+    }
+
+    entry = new QQuickTextLayoutCache::Entry;
+    entry->layout.setText(layout.text());
+
+    const QRectF br = setupTextLayout(entry->layout, entry->elideLayout, baseline);
+
+    entry->textRect = br;
+    entry->implicitSize = QSizeF(implicitWidth, implicitHeight);
+    entry->baseline = *baseline;
+    entry->lineWidth = lineWidth;
+    entry->lineCount = lineCount;
+    entry->truncated = truncated;
+    entry->widthExceeded = widthExceeded;
+
+    // Only a layout that leaves the item in the geometry it started from can be reused.
+    if (!internalWidthUpdate && isLayoutCacheKeyCurrent(key))
+        cache->insert(key, entry.data());
+    setSharedLayout(entry);
+
+    return br;
+}
+
+QQuickTextLayoutCache::Key QQuickTextPrivate::layoutCacheKey() const
+{
+    Q_Q(const QQuickText);
+
+    QQuickTextLayoutCache::Key key;
+    key.text = layout.text();
+    key.font = font;
+    key.width = q->width();
+    key.availableWidth = availableWidth();
+    key.verticalPadding = q->topPadding() + q->bottomPadding();
+    key.lineHeight = lineHeight();
+    key.alignment = q->effectiveHAlign();
+    key.elideMode = elideMode;
+    key.lineHeightMode = lineHeightMode();
+    key.widthValid = q->widthValid();
+    key.implicitWidthValid = implicitWidthValid;
+    key.designMetrics = renderType != QQuickText::NativeRendering;
+
+    // Until the width is either set or known the text is laid out without a width limit.
+    if (!key.widthValid && !key.implicitWidthValid) {
+        key.width = 0;
+        key.availableWidth = 0;
+    }
+    return key;
+}
+
+// Laying out text makes the implicit width known and, unless the width is set, resizes the item
+// to it. A layout remains current for the key it was made with as long as nothing else changed.
+bool QQuickTextPrivate::isLayoutCacheKeyCurrent(const QQuickTextLayoutCache::Key &key) const
+{
+    QQuickTextLayoutCache::Key current = layoutCacheKey();
+    current.implicitWidthValid = key.implicitWidthValid;
+    if (!current.widthValid && !current.implicitWidthValid) {
+        current.width = 0;
+        current.availableWidth = 0;
+    }
+    return current == key;
+}
+
+void QQuickTextPrivate::setSharedLayout(const QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> &entry)
+{
+    layout.clearLayout();
+    delete elideLayout;
+    elideLayout = 0;
+    sharedLayout = entry;
+}
+
+// Text that is laid out in a single pass, without eliding, fitting or images, can be shaped
+// and broken into lines on a worker thread.
+bool QQuickTextPrivate::isAsynchronousLayout()
+{
+    return extra.isAllocated()
+            && extra->asynchronous
+            && !richText
+            && multilengthEos == -1
+            && elideMode == QQuickText::ElideNone
+            && fontSizeMode() == QQuickText::FixedSize
+            && !maximumLineCountValid
+            && extra->imgTags.isEmpty()
+            && !isLineLaidOutConnected()
+            && QFontDatabase::supportsThreadedFontRendering();
+}
+
+QQuickTextLayoutJob::Input QQuickTextPrivate::asynchronousLayoutInput() const
+{
+    Q_Q(const QQuickText);
+
+    QQuickTextLayoutJob::Input input;
+    input.text = layout.text();
+    input.formats = layout.formats();
+    input.font = font;
+    input.option.setAlignment(Qt::Alignment(q->effectiveHAlign()));
+    input.option.setWrapMode(QTextOption::WrapMode(wrapMode));
+    input.option.setUseDesignMetrics(renderType != QQuickText::NativeRendering);
+    input.lineWidth = q->widthValid() && availableWidth() > 0 ? availableWidth() : FLT_MAX;
+    input.lineHeight = lineHeight();
+    input.fixedLineHeight = lineHeightMode() == QQuickText::FixedHeight;
+    input.textRevision = extra->textRevision;
+    return input;
+}
+
+// Returns true if the text has been laid out for the current text and geometry, and
+// otherwise starts laying it out, unless that is already in progress.
+bool QQuickTextPrivate::updateAsynchronousLayout()
+{
+    Q_Q(QQuickText);
+
+    const QQuickTextLayoutJob::Input input = asynchronousLayoutInput();
+    if (extra->asyncLayout && extra->asyncLayoutInput == input)
+        return true;
+    if (extra->layoutJob && extra->layoutJob->input == input)
+        return false;
+
+    // A job that is no longer needed still runs to completion, but its result is ignored.
+    extra->layoutJob = new QQuickTextLayoutJob(input);
+    QObject::connect(extra->layoutJob, SIGNAL(finished(QQuickTextLayoutJob*)),
+                     q, SLOT(asyncLayoutFinished(QQuickTextLayoutJob*)));
+    QQuickTextLayoutJob::start(extra->layoutJob);
+    return false;
+}
+
+QRectF QQuickTextPrivate::setupAsynchronousLayout(qreal *const baseline)
+{
+    Q_Q(QQuickText);
+
+    // Setting the implicit size and emitting the change signals can lay the text out again,
+    // which may release the layout before this is done with it.
+    const QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> entry = extra->asyncLayout;
+    setSharedLayout(QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry>());
+
+    bool wasInLayout = internalWidthUpdate;
+    internalWidthUpdate = true;
+    q->setImplicitSize(entry->implicitSize.width() + q->leftPadding() + q->rightPadding(),
+                       entry->implicitSize.height() + q->topPadding() + q->bottomPadding());
+    internalWidthUpdate = wasInLayout;
+
+    lineWidth = entry->lineWidth;
+    widthExceeded = entry->widthExceeded;
+    heightExceeded = false;
+    implicitWidthValid = true;
+    implicitHeightValid = true;
+
+    const bool lineCountHasChanged = lineCount != entry->lineCount;
+    const bool truncatedHasChanged = truncated;
+    lineCount = entry->lineCount;
+    truncated = false;
+    if (lineCountHasChanged)
+        emit q->lineCountChanged();
+    if (truncatedHasChanged)
+        emit q->truncatedChanged();
+
+    // A handler may have changed the text or how it is laid out, in which case the layout
+    // is set up again for the new state.
+    if (extra->asyncLayout != entry)
+        return setupTextLayout(baseline);
+
+    // A binding to the implicit size may have changed the width, in which case this layout
+    // is shown until the text has been laid out again.
+    if (!internalWidthUpdate)
+        updateAsynchronousLayout();
+
+    *baseline = entry->baseline;
+    return entry->textRect;
+}
+
+void QQuickTextPrivate::resetAsynchronousLayout()
+{
+    if (extra.isAllocated()) {
+        extra->asyncLayout.reset();
+        extra->layoutJob = 0;
+    }
+}
+
+QRectF QQuickTextPrivate::setupTextLayout(QTextLayout &textLayout, QTextLayout *&textElideLayout, qreal *const baseline)
+{
+    Q_Q(QQuickText);
+
+    bool singlelineElide = elideMode != QQuickText::ElideNone && q->widthValid();
+    bool multilineElide = elideMode == QQuickText::ElideRight
+            && q->widthValid()
+            && (q->heightValid() || maximumLineCountValid);
+
+    bool shouldUseDesignMetrics = renderType != QQuickText::NativeRendering;
+    textLayout.setCacheEnabled(true);
+    QTextOption textOption = textLayout.textOption();
     if (textOption.alignment() != q->effectiveHAlign()
             || textOption.wrapMode() != QTextOption::WrapMode(wrapMode)
             || textOption.useDesignMetrics() != shouldUseDesignMetrics) {
         textOption.setAlignment(Qt::Alignment(q->effectiveHAlign()));
         textOption.setWrapMode(QTextOption::WrapMode(wrapMode));
         textOption.setUseDesignMetrics(shouldUseDesignMetrics);
-        layout.setTextOption(textOption);
+        textLayout.setTextOption(textOption);
     }
-    if (layout.font() != font)
-        layout.setFont(font);
+    if (textLayout.font() != font)
+        textLayout.setFont(font);
 
     lineWidth = (q->widthValid() || implicitWidthValid) && q->width() > 0
             ? q->width()
@@ -677,7 +947,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
             && (q->heightValid() || (maximumLineCountValid && canWrap));
 
     const bool pixelSize = font.pixelSize() != -1;
-    QString layoutText = layout.text();
+    QString layoutText = textLayout.text();
 
     int largeFont = pixelSize ? font.pixelSize() : font.pointSize();
     int smallFont = fontSizeMode() != QQuickText::FixedSize
@@ -712,11 +982,11 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
                 scaledFont.setPixelSize(scaledFontSize);
             else
                 scaledFont.setPointSize(scaledFontSize);
-            if (layout.font() != scaledFont)
-                layout.setFont(scaledFont);
+            if (textLayout.font() != scaledFont)
+                textLayout.setFont(scaledFont);
         }
 
-        layout.beginLayout();
+        textLayout.beginLayout();
 
         bool wrapped = false;
         bool truncateHeight = false;
@@ -730,7 +1000,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
         br = QRectF();
 
         QRectF unelidedRect;
-        QTextLine line = layout.createLine();
+        QTextLine line = textLayout.createLine();
         for (visibleCount = 1; ; ++visibleCount) {
             if (customLayout) {
                 setupCustomLineGeometry(line, naturalHeight);
@@ -753,10 +1023,10 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
 
                 visibleCount -= 1;
 
-                QTextLine previousLine = layout.lineAt(visibleCount - 1);
+                QTextLine previousLine = textLayout.lineAt(visibleCount - 1);
                 elideText = layoutText.at(line.textStart() - 1) != QChar::LineSeparator
-                        ? elidedText(line.width(), previousLine, &line)
-                        : elidedText(line.width(), previousLine);
+                        ? elidedText(textLayout, line.width(), previousLine, &line)
+                        : elidedText(textLayout, line.width(), previousLine);
                 elideStart = previousLine.textStart();
                 // elideEnd isn't required for right eliding.
 
@@ -765,7 +1035,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
             }
 
             const QTextLine previousLine = line;
-            line = layout.createLine();
+            line = textLayout.createLine();
             if (!line.isValid()) {
                 if (singlelineElide && visibleCount == 1 && previousLine.naturalTextWidth() > previousLine.width()) {
                     // Elide a single previousLine of  text if its width exceeds the element width.
@@ -775,7 +1045,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
                         break;
 
                     truncated = true;
-                    elideText = layout.engine()->elidedText(
+                    elideText = textLayout.engine()->elidedText(
                             Qt::TextElideMode(elideMode),
                             QFixed::fromReal(previousLine.width()),
                             0,
@@ -806,8 +1076,8 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
                         if (eos != -1)  // There's an abbreviated string available
                             break;
                         elideText = wrappedLine
-                                ? elidedText(previousLine.width(), previousLine, &line)
-                                : elidedText(previousLine.width(), previousLine);
+                                ? elidedText(textLayout, previousLine.width(), previousLine, &line)
+                                : elidedText(textLayout, previousLine.width(), previousLine);
                         elideStart = previousLine.textStart();
                         // elideEnd isn't required for right eliding.
                     } else {
@@ -832,8 +1102,8 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
             if ((requireImplicitSize) && line.isValid() && unwrappedLineCount < maxLineCount) {
                 // Layout the remainder of the wrapped lines up to maxLineCount to get the implicit
                 // height.
-                for (int lineCount = layout.lineCount(); lineCount < maxLineCount; ++lineCount) {
-                    line = layout.createLine();
+                for (int lineCount = textLayout.lineCount(); lineCount < maxLineCount; ++lineCount) {
+                    line = textLayout.createLine();
                     if (!line.isValid())
                         break;
                     if (layoutText.at(line.textStart() - 1) == QChar::LineSeparator)
@@ -847,13 +1117,13 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
                         ? line.textStart() + line.textLength()
                         : layoutText.length();
                 if (eol < layoutText.length() && layoutText.at(eol) != QChar::LineSeparator)
-                    line = layout.createLine();
+                    line = textLayout.createLine();
                 for (; line.isValid() && unwrappedLineCount <= maxLineCount; ++unwrappedLineCount)
-                    line = layout.createLine();
+                    line = textLayout.createLine();
             }
-            layout.endLayout();
+            textLayout.endLayout();
 
-            const qreal naturalWidth = layout.maximumWidth();
+            const qreal naturalWidth = textLayout.maximumWidth();
 
             bool wasInLayout = internalWidthUpdate;
             internalWidthUpdate = true;
@@ -910,14 +1180,14 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
         } else if (widthChanged) {
             widthChanged = false;
             if (line.isValid()) {
-                for (int lineCount = layout.lineCount(); lineCount < maxLineCount; ++lineCount) {
-                    line = layout.createLine();
+                for (int lineCount = textLayout.lineCount(); lineCount < maxLineCount; ++lineCount) {
+                    line = textLayout.createLine();
                     if (!line.isValid())
                         break;
                     setLineGeometry(line, lineWidth, naturalHeight);
                 }
             }
-            layout.endLayout();
+            textLayout.endLayout();
 
             bool wasInLayout = internalWidthUpdate;
             internalWidthUpdate = true;
@@ -941,7 +1211,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
                 continue;
             }
         } else {
-            layout.endLayout();
+            textLayout.endLayout();
         }
 
         // If the next needs to be elided and there's an abbreviated string available
@@ -951,7 +1221,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
             eos = text.indexOf(QLatin1Char('\x9c'),  start);
             layoutText = text.mid(start, eos != -1 ? eos - start : -1);
             layoutText.replace(QLatin1Char('\n'), QChar::LineSeparator);
-            layout.setText(layoutText);
+            textLayout.setText(layoutText);
             textHasChanged = true;
             continue;
         }
@@ -1006,9 +1276,9 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
         truncated = true;
 
     if (elide) {
-        if (!elideLayout) {
-            elideLayout = new QTextLayout;
-            elideLayout->setCacheEnabled(true);
+        if (!textElideLayout) {
+            textElideLayout = new QTextLayout;
+            textElideLayout->setCacheEnabled(true);
         }
         if (styledText) {
             QVector<QTextLayout::FormatRange> formats;
@@ -1034,35 +1304,35 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
             default:
                 break;
             }
-            elideLayout->setFormats(formats);
+            textElideLayout->setFormats(formats);
         }
 
-        elideLayout->setFont(layout.font());
-        elideLayout->setTextOption(layout.textOption());
-        elideLayout->setText(elideText);
-        elideLayout->beginLayout();
+        textElideLayout->setFont(textLayout.font());
+        textElideLayout->setTextOption(textLayout.textOption());
+        textElideLayout->setText(elideText);
+        textElideLayout->beginLayout();
 
-        QTextLine elidedLine = elideLayout->createLine();
+        QTextLine elidedLine = textElideLayout->createLine();
         elidedLine.setPosition(QPointF(0, height));
         if (customLayout) {
             setupCustomLineGeometry(elidedLine, height, visibleCount - 1);
         } else {
             setLineGeometry(elidedLine, lineWidth, height);
         }
-        elideLayout->endLayout();
+        textElideLayout->endLayout();
 
         br = br.united(elidedLine.naturalTextRect());
 
         if (visibleCount == 1)
-            layout.clearLayout();
+            textLayout.clearLayout();
     } else {
-        delete elideLayout;
-        elideLayout = 0;
+        delete textElideLayout;
+        textElideLayout = 0;
     }
 
-    QTextLine firstLine = visibleCount == 1 && elideLayout
-            ? elideLayout->lineAt(0)
-            : layout.lineAt(0);
+    QTextLine firstLine = visibleCount == 1 && textElideLayout
+            ? textElideLayout->lineAt(0)
+            : textLayout.lineAt(0);
     Q_ASSERT(firstLine.isValid());
     *baseline = firstLine.y() + firstLine.ascent();
 
@@ -2274,19 +2544,21 @@ QSGNode *QQuickText::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data
         node->addTextDocument(QPointF(dx, dy), d->extra->doc, color, d->style, styleColor, linkColor);
     } else if (d->layedOutTextRect.width() > 0) {
         const qreal dx = QQuickTextUtil::alignedX(d->lineWidth, d->availableWidth(), effectiveHAlign()) + leftPadding();
+        QTextLayout *layout = d->currentLayout();
+        QTextLayout *elideLayout = d->currentElideLayout();
         int unelidedLineCount = d->lineCount;
-        if (d->elideLayout)
+        if (elideLayout)
             unelidedLineCount -= 1;
         if (unelidedLineCount > 0) {
             node->addTextLayout(
                         QPointF(dx, dy),
-                        &d->layout,
+                        layout,
                         color, d->style, styleColor, linkColor,
                         QColor(), QColor(), -1, -1,
                         0, unelidedLineCount);
         }
-        if (d->elideLayout)
-            node->addTextLayout(QPointF(dx, dy), d->elideLayout, color, d->style, styleColor, linkColor);
+        if (elideLayout)
+            node->addTextLayout(QPointF(dx, dy), elideLayout, color, d->style, styleColor, linkColor);
 
         if (d->extra.isAllocated()) {
             foreach (QQuickStyledTextImgTag *img, d->extra->visibleImgTags) {
@@ -2783,6 +3055,14 @@ void QQuickText::invalidateFontCaches()
     } else {
         if (d->layout.engine() != 0)
             d->layout.engine()->resetFontEngineCache();
+        if (d->extra.isAllocated() && d->extra->asyncLayout && d->extra->asyncLayout->layout.engine() != 0)
+            d->extra->asyncLayout->layout.engine()->resetFontEngineCache();
+        if (d->sharedLayout) {
+            if (d->sharedLayout->layout.engine() != 0)
+                d->sharedLayout->layout.engine()->resetFontEngineCache();
+            if (d->sharedLayout->elideLayout && d->sharedLayout->elideLayout->engine() != 0)
+                d->sharedLayout->elideLayout->engine()->resetFontEngineCache();
+        }
     }
 }
 
@@ -2907,4 +3187,38 @@ void QQuickText::resetBottomPadding()
     d->setBottomPadding(0, true);
 }
 
+/*!
+    \qmlproperty bool QtQuick::Text::asynchronous
+    \since 5.7
+
+    Specifies that the text should be shaped and broken into lines in a separate thread.
+    By default, this property is \c false, and the text is laid out when it changes, which
+    can block the user interface for long texts, such as logs.
+
+    While the text is being laid out, the item keeps showing the text it was showing before,
+    and its implicit size, \l lineCount, \l contentWidth and \l contentHeight keep their
+    previous values. The implicit size is that of the text laid out at the width of the item.
+
+    Rich text, elided text, and text with a \l fontSizeMode, a \l maximumLineCount, inline
+    images or a \l lineLaidOut handler is always laid out synchronously.
+*/
+bool QQuickText::asynchronous() const
+{
+    Q_D(const QQuickText);
+    return d->extra.isAllocated() && d->extra->asynchronous;
+}
+
+void QQuickText::setAsynchronous(bool asynchronous)
+{
+    Q_D(QQuickText);
+    if (asynchronous == this->asynchronous())
+        return;
+
+    d->extra.value().asynchronous = asynchronous;
+    if (!asynchronous)
+        d->resetAsynchronousLayout();
+    d->updateSize();
+    emit asynchronousChanged();
+}
+
 QT_END_NAMESPACE
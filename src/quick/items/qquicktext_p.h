@@ -53,6 +53,7 @@ QT_BEGIN_NAMESPACE
 
 class QQuickTextPrivate;
 class QQuickTextLine;
+class QQuickTextLayoutJob;
 class Q_QUICK_PRIVATE_EXPORT QQuickText : public QQuickImplicitSizeItem
 {
     Q_OBJECT
@@ -91,6 +92,7 @@ class Q_QUICK_PRIVATE_EXPORT QQuickText : public QQuickImplicitSizeItem
     Q_PROPERTY(qreal leftPadding READ leftPadding WRITE setLeftPadding RESET resetLeftPadding NOTIFY leftPaddingChanged REVISION 6)
     Q_PROPERTY(qreal rightPadding READ rightPadding WRITE setRightPadding RESET resetRightPadding NOTIFY rightPaddingChanged REVISION 6)
     Q_PROPERTY(qreal bottomPadding READ bottomPadding WRITE setBottomPadding RESET resetBottomPadding NOTIFY bottomPaddingChanged REVISION 6)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged REVISION 7)
 
 public:
     QQuickText(QQuickItem *parent=0);
@@ -241,6 +243,9 @@ public:
     void setBottomPadding(qreal padding);
     void resetBottomPadding();
 
+    bool asynchronous() const;
+    void setAsynchronous(bool asynchronous);
+
 Q_SIGNALS:
     void textChanged(const QString &text);
     void linkActivated(const QString &link);
@@ -273,6 +278,7 @@ Q_SIGNALS:
     Q_REVISION(6) void leftPaddingChanged();
     Q_REVISION(6) void rightPaddingChanged();
     Q_REVISION(6) void bottomPaddingChanged();
+    Q_REVISION(7) void asynchronousChanged();
 
 protected:
     QQuickText(QQuickTextPrivate &dd, QQuickItem *parent = 0);
@@ -295,6 +301,7 @@ private Q_SLOTS:
     void q_updateLayout();
     void triggerPreprocess();
     void imageDownloadFinished();
+    void asyncLayoutFinished(QQuickTextLayoutJob *job);
 
 private:
     Q_DISABLE_COPY(QQuickText)
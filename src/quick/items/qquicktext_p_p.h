@@ -52,6 +52,8 @@
 #include <QtGui/qabstracttextdocumentlayout.h>
 #include <QtGui/qtextlayout.h>
 #include <private/qquickstyledtext_p.h>
+#include <private/qquicktextlayoutcache_p.h>
+#include <private/qquicktextlayoutjob_p.h>
 #include <private/qlazilyallocated_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -77,7 +79,7 @@ public:
     void setLineGeometry(QTextLine &line, qreal lineWidth, qreal &height);
 
     int lineHeightOffset() const;
-    QString elidedText(qreal lineWidth, const QTextLine &line, QTextLine *nextLine = 0) const;
+    QString elidedText(const QTextLayout &textLayout, qreal lineWidth, const QTextLine &line, QTextLine *nextLine = 0) const;
     void elideFormats(int start, int length, int offset, QVector<QTextLayout::FormatRange> *elidedFormats);
 
     void processHoverEvent(QHoverEvent *event);
@@ -110,6 +112,11 @@ public:
         QList<QQuickStyledTextImgTag*> imgTags;
         QList<QQuickStyledTextImgTag*> visibleImgTags;
         QUrl baseUrl;
+        bool asynchronous;
+        int textRevision;
+        QQuickTextLayoutJob *layoutJob;
+        QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> asyncLayout;
+        QQuickTextLayoutJob::Input asyncLayoutInput;
     };
     QLazilyAllocated<ExtraData> extra;
 
@@ -119,6 +126,7 @@ public:
 
     QTextLayout layout;
     QTextLayout *elideLayout;
+    QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> sharedLayout;
     QQuickTextLine *textLine;
 
     qreal lineWidth;
@@ -181,6 +189,15 @@ public:
     void ensureDoc();
 
     QRectF setupTextLayout(qreal * const baseline);
+    QRectF setupTextLayout(QTextLayout &textLayout, QTextLayout *&textElideLayout, qreal * const baseline);
+    QQuickTextLayoutCache::Key layoutCacheKey() const;
+    bool isLayoutCacheKeyCurrent(const QQuickTextLayoutCache::Key &key) const;
+    void setSharedLayout(const QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> &entry);
+    bool isAsynchronousLayout();
+    bool updateAsynchronousLayout();
+    QQuickTextLayoutJob::Input asynchronousLayoutInput() const;
+    QRectF setupAsynchronousLayout(qreal *const baseline);
+    void resetAsynchronousLayout();
     void setupCustomLineGeometry(QTextLine &line, qreal &height, int lineOffset = 0);
     bool isLinkActivatedConnected();
     bool isLinkHoveredConnected();
@@ -193,6 +210,17 @@ public:
     inline QQuickText::FontSizeMode fontSizeMode() const { return extra.isAllocated() ? extra->fontSizeMode : QQuickText::FixedSize; }
     inline int minimumPixelSize() const { return extra.isAllocated() ? extra->minimumPixelSize : 12; }
     inline int minimumPointSize() const { return extra.isAllocated() ? extra->minimumPointSize : 12; }
+    // The layouts the text was last laid out in, which may be shared with other items.
+    inline QTextLayout *currentLayout() {
+        if (extra.isAllocated() && extra->asyncLayout)
+            return &extra->asyncLayout->layout;
+        return sharedLayout ? &sharedLayout->layout : &layout;
+    }
+    inline QTextLayout *currentElideLayout() {
+        if (extra.isAllocated() && extra->asyncLayout)
+            return 0;
+        return sharedLayout ? sharedLayout->elideLayout : elideLayout;
+    }
     static inline QQuickTextPrivate *get(QQuickText *t) { return t->d_func(); }
 };
 
@@ -1863,23 +1863,27 @@ static inline void updateNodeTransform(QQuickTextNode* node, const QPointF &topL
     node->setMatrix(transformMatrix);
 }
 
+static inline void resetFontEngineCache(const QTextBlock &block)
+{
+    if (block.layout() != 0 && block.layout()->engine() != 0)
+        block.layout()->engine()->resetFontEngineCache();
+}
+
 /*!
  * \internal
  *
- * Invalidates font caches owned by the text objects owned by the element
+ * Invalidates font caches owned by the text blocks between \a startPos and \a endPos
  * to work around the fact that text objects cannot be used from multiple threads.
  */
-void QQuickTextEdit::invalidateFontCaches()
+void QQuickTextEdit::invalidateFontCaches(int startPos, int endPos)
 {
     Q_D(QQuickTextEdit);
-    if (d->document == 0)
+    if (d->document == 0 || startPos > endPos)
         return;
 
     QTextBlock block;
-    for (block = d->document->firstBlock(); block.isValid(); block = block.next()) {
-        if (block.layout() != 0 && block.layout()->engine() != 0)
-            block.layout()->engine()->resetFontEngineCache();
-    }
+    for (block = d->document->findBlock(startPos); block.isValid() && block.position() <= endPos; block = block.next())
+        resetFontEngineCache(block);
 }
 
 inline void resetEngine(QQuickTextNodeEngine *engine, const QColor& textColor, const QColor& selectedTextColor, const QColor& selectionColor)
@@ -1918,6 +1922,10 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
     QQuickTextNodeEngine engine;
     QQuickTextNodeEngine frameDecorationsEngine;
 
+    // The range of the document laid out on this thread, whose font caches must be reset afterwards.
+    int firstUpdatedPos = INT_MAX;
+    int lastUpdatedPos = -1;
+
     if (!oldNode || nodeIterator < d->textNodeMap.end()) {
 
         if (!oldNode)
@@ -1970,6 +1978,9 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
                 ProtectedLayoutAccessor *a = static_cast<ProtectedLayoutAccessor *>(d->document->documentLayout());
                 QTextCharFormat format = a->formatAccessor(pos);
                 QTextBlock block = textFrame->firstCursorPosition().block();
+                resetFontEngineCache(block);
+                firstUpdatedPos = qMin(firstUpdatedPos, block.position());
+                lastUpdatedPos = qMax(lastUpdatedPos, block.position());
                 engine.setCurrentLine(block.layout()->lineForTextPosition(pos - block.position()));
                 engine.addTextObject(QPointF(0, 0), format, QQuickTextNodeEngine::Unselected, d->document,
                                               pos, textFrame->frameFormat().position());
@@ -1982,12 +1993,25 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
                     frameBoundaries.append(frame->firstPosition());
                 std::sort(frameBoundaries.begin(), frameBoundaries.end());
 
+                // Without child frames all blocks of the document belong to the root frame, so we can
+                // start at the first dirty block instead of walking the frame from its beginning.
+                const bool flatDocument = textFrame == d->document->rootFrame() && frames.isEmpty();
                 QTextFrame::iterator it = textFrame->begin();
-                while (!it.atEnd()) {
-                    QTextBlock block = it.currentBlock();
-                    ++it;
-                    if (block.position() < firstDirtyPos)
-                        continue;
+                QTextBlock block = flatDocument ? d->document->findBlock(firstDirtyPos) : QTextBlock();
+                while (flatDocument ? block.isValid() : !it.atEnd()) {
+                    if (!flatDocument) {
+                        block = it.currentBlock();
+                        ++it;
+                        if (block.position() < firstDirtyPos)
+                            continue;
+                    }
+                    const QTextBlock nextBlock = block.next();
+                    const bool lastBlockInFrame = flatDocument ? !nextBlock.isValid() : it.atEnd();
+
+                    // Drop any font engines cached while the block was laid out on the GUI thread.
+                    resetFontEngineCache(block);
+                    firstUpdatedPos = qMin(firstUpdatedPos, block.position());
+                    lastUpdatedPos = qMax(lastUpdatedPos, block.position());
 
                     if (!engine.hasContents()) {
                         nodeOffset = d->document->documentLayout()->blockBoundingRect(block).topLeft();
@@ -1998,17 +2022,18 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
                     engine.addTextBlock(d->document, block, -nodeOffset, d->color, QColor(), selectionStart(), selectionEnd() - 1);
                     currentNodeSize += block.length();
 
-                    if ((it.atEnd()) || (firstCleanNode && block.next().position() >= firstCleanNode->startPos())) // last node that needed replacing or last block of the frame
+                    if (lastBlockInFrame || (firstCleanNode && nextBlock.position() >= firstCleanNode->startPos())) // last node that needed replacing or last block of the frame
                         break;
 
-                    QList<int>::const_iterator lowerBound = std::lower_bound(frameBoundaries.constBegin(), frameBoundaries.constEnd(), block.next().position());
+                    QList<int>::const_iterator lowerBound = std::lower_bound(frameBoundaries.constBegin(), frameBoundaries.constEnd(), nextBlock.position());
                     if (currentNodeSize > nodeBreakingSize || lowerBound == frameBoundaries.constEnd() || *lowerBound > nodeStart) {
                         currentNodeSize = 0;
                         d->addCurrentTextNodeToRoot(&engine, rootNode, node, nodeIterator, nodeStart);
                         node = d->createTextNode();
                         resetEngine(&engine, d->color, d->selectedTextColor, d->selectionColor);
-                        nodeStart = block.next().position();
+                        nodeStart = nextBlock.position();
                     }
+                    block = nextBlock;
                 }
             }
             d->addCurrentTextNodeToRoot(&engine, rootNode, node, nodeIterator, nodeStart);
@@ -2023,7 +2048,9 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
             QPointF oldOffset = firstCleanNode->textNode()->matrix().map(QPointF(0,0));
             QPointF currentOffset = d->document->documentLayout()->blockBoundingRect(d->document->findBlock(firstCleanNode->startPos())).topLeft();
             QPointF delta = currentOffset - oldOffset;
-            while (nodeIterator != d->textNodeMap.end()) {
+            // Edits that keep the height of the dirty blocks, like typing within a line, leave the
+            // rest of the document where it was.
+            while (!delta.isNull() && nodeIterator != d->textNodeMap.end()) {
                 QMatrix4x4 transformMatrix = (*nodeIterator)->textNode()->matrix();
                 transformMatrix.translate(delta.x(), delta.y());
                 (*nodeIterator)->textNode()->setMatrix(transformMatrix);
@@ -2033,27 +2060,29 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
         }
 
         // Since we iterate over blocks from different text frames that are potentially not sorted
-        // we need to ensure that our list of nodes is sorted again:
-        std::sort(d->textNodeMap.begin(), d->textNodeMap.end(), &comesBefore);
+        // we need to ensure that our list of nodes is sorted again. Nodes of the root frame alone
+        // are inserted in document order already.
+        if (!d->document->rootFrame()->childFrames().isEmpty())
+            std::sort(d->textNodeMap.begin(), d->textNodeMap.end(), &comesBefore);
     }
 
     if (d->cursorComponent == 0) {
         QSGRectangleNode* cursor = 0;
-        if (!isReadOnly() && d->cursorVisible && d->control->cursorOn())
+        if (!isReadOnly() && d->cursorVisible && d->control->cursorOn()) {
+            const QTextBlock cursorBlock = d->control->textCursor().block();
+            resetFontEngineCache(cursorBlock);
+            firstUpdatedPos = qMin(firstUpdatedPos, cursorBlock.position());
+            lastUpdatedPos = qMax(lastUpdatedPos, cursorBlock.position());
             cursor = d->sceneGraphContext()->createRectangleNode(d->control->cursorRect(), d->color);
+        }
         rootNode->resetCursorNode(cursor);
     }
 
-    invalidateFontCaches();
+    invalidateFontCaches(firstUpdatedPos, lastUpdatedPos);
 
     return rootNode;
 }
 
-void QQuickTextEdit::updatePolish()
-{
-    invalidateFontCaches();
-}
-
 /*!
     \qmlproperty bool QtQuick::TextEdit::canPaste
 
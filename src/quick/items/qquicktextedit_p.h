@@ -360,7 +360,7 @@ private Q_SLOTS:
 private:
     void markDirtyNodesForRange(int start, int end, int charDelta);
     void updateTotalLines();
-    void invalidateFontCaches();
+    void invalidateFontCaches(int startPos, int endPos);
 
 protected:
     QQuickTextEdit(QQuickTextEditPrivate &dd, QQuickItem *parent = 0);
@@ -387,7 +387,6 @@ protected:
     void inputMethodEvent(QInputMethodEvent *e) Q_DECL_OVERRIDE;
 #endif
     QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *updatePaintNodeData) Q_DECL_OVERRIDE;
-    void updatePolish() Q_DECL_OVERRIDE;
 
     friend class QQuickTextUtil;
     friend class QQuickTextDocument;
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qquicktextlayoutcache_p.h"
+
+#include <QtCore/qcoreapplication.h>
+
+QT_BEGIN_NAMESPACE
+
+// Number of laid out texts kept for reuse once no item uses them any more.
+// QML_TEXT_LAYOUT_CACHE_SIZE=0 disables sharing altogether.
+#define TEXT_LAYOUT_CACHE_SIZE 512
+
+QQuickTextLayoutCache::Key::Key()
+    : width(0)
+    , availableWidth(0)
+    , verticalPadding(0)
+    , lineHeight(1.0)
+    , alignment(0)
+    , elideMode(0)
+    , lineHeightMode(0)
+    , widthValid(false)
+    , implicitWidthValid(false)
+    , designMetrics(false)
+{
+}
+
+bool QQuickTextLayoutCache::Key::operator==(const Key &other) const
+{
+    return width == other.width
+            && availableWidth == other.availableWidth
+            && verticalPadding == other.verticalPadding
+            && lineHeight == other.lineHeight
+            && alignment == other.alignment
+            && elideMode == other.elideMode
+            && lineHeightMode == other.lineHeightMode
+            && widthValid == other.widthValid
+            && implicitWidthValid == other.implicitWidthValid
+            && designMetrics == other.designMetrics
+            && text == other.text
+            && font == other.font;
+}
+
+uint qHash(const QQuickTextLayoutCache::Key &key, uint seed)
+{
+    uint flags = uint(key.alignment)
+            ^ (uint(key.elideMode) << 16)
+            ^ (uint(key.lineHeightMode) << 20)
+            ^ (uint(key.widthValid) << 24)
+            ^ (uint(key.implicitWidthValid) << 25)
+            ^ (uint(key.designMetrics) << 26);
+    return qHash(key.text, seed) ^ qHash(key.font, seed) ^ qHash(key.availableWidth, seed) ^ flags;
+}
+
+QQuickTextLayoutCache::Entry::Entry()
+    : elideLayout(0)
+    , baseline(0)
+    , lineWidth(0)
+    , lineCount(0)
+    , truncated(false)
+    , widthExceeded(false)
+{
+}
+
+QQuickTextLayoutCache::Entry::~Entry()
+{
+    delete elideLayout;
+}
+
+static void qt_quick_text_layout_cache_clear();
+
+QQuickTextLayoutCache::QQuickTextLayoutCache()
+{
+    bool ok = false;
+    const int size = qEnvironmentVariableIntValue("QML_TEXT_LAYOUT_CACHE_SIZE", &ok);
+    m_entries.setMaxCost(ok && size >= 0 ? size : TEXT_LAYOUT_CACHE_SIZE);
+
+    // The layouts hold on to font engines, which must be gone before the application is.
+    qAddPostRoutine(qt_quick_text_layout_cache_clear);
+}
+
+QQuickTextLayoutCache::~QQuickTextLayoutCache()
+{
+    qRemovePostRoutine(qt_quick_text_layout_cache_clear);
+}
+
+Q_GLOBAL_STATIC(QQuickTextLayoutCache, textLayoutCache)
+
+QQuickTextLayoutCache *QQuickTextLayoutCache::instance()
+{
+    return textLayoutCache();
+}
+
+static void qt_quick_text_layout_cache_clear()
+{
+    textLayoutCache()->clear();
+}
+
+QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> QQuickTextLayoutCache::find(const Key &key)
+{
+    // QCache::object() also makes the entry the most recently used one.
+    if (QExplicitlySharedDataPointer<Entry> *entry = m_entries.object(key))
+        return *entry;
+    return QExplicitlySharedDataPointer<Entry>();
+}
+
+void QQuickTextLayoutCache::insert(const Key &key, Entry *entry)
+{
+    if (m_entries.maxCost() > 0)
+        m_entries.insert(key, new QExplicitlySharedDataPointer<Entry>(entry));
+}
+
+void QQuickTextLayoutCache::clear()
+{
+    m_entries.clear();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QQUICKTEXTLAYOUTCACHE_P_H
+#define QQUICKTEXTLAYOUTCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtquickglobal_p.h>
+
+#include <QtCore/qcache.h>
+#include <QtCore/qshareddata.h>
+#include <QtGui/qfont.h>
+#include <QtGui/qtextlayout.h>
+
+QT_BEGIN_NAMESPACE
+
+// Layouts of plain text items that neither wrap nor scale their font are a function of
+// the text, the font and the item geometry, so items showing the same label, such as the
+// delegates of a view, can share one shaped and laid out QTextLayout.
+// The cache is only used from the GUI thread, where all text items are laid out.
+class Q_QUICK_PRIVATE_EXPORT QQuickTextLayoutCache
+{
+public:
+    struct Key
+    {
+        Key();
+
+        QString text;
+        QFont font;
+        qreal width;
+        qreal availableWidth;
+        qreal verticalPadding;
+        qreal lineHeight;
+        int alignment;
+        int elideMode;
+        int lineHeightMode;
+        bool widthValid;
+        bool implicitWidthValid;
+        bool designMetrics;
+
+        bool operator==(const Key &other) const;
+        bool operator!=(const Key &other) const { return !operator==(other); }
+    };
+
+    // The result of laying out the text, including the state the layout leaves
+    // the item in, so that another item can take it over without laying out.
+    struct Entry : public QSharedData
+    {
+        Entry();
+        ~Entry();
+
+        QTextLayout layout;
+        QTextLayout *elideLayout;
+        QRectF textRect;
+        QSizeF implicitSize;
+        qreal baseline;
+        qreal lineWidth;
+        int lineCount;
+        bool truncated;
+        bool widthExceeded;
+    };
+
+    QQuickTextLayoutCache();
+    ~QQuickTextLayoutCache();
+
+    static QQuickTextLayoutCache *instance();
+
+    QExplicitlySharedDataPointer<Entry> find(const Key &key);
+    void insert(const Key &key, Entry *entry);
+    void clear();
+
+private:
+    QCache<Key, QExplicitlySharedDataPointer<Entry> > m_entries;
+};
+
+uint qHash(const QQuickTextLayoutCache::Key &key, uint seed = 0);
+
+QT_END_NAMESPACE
+
+#endif // QQUICKTEXTLAYOUTCACHE_P_H
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qquicktextlayoutjob_p.h"
+
+#include <private/qquickworkerpool_p.h>
+
+#include <float.h>
+
+QT_BEGIN_NAMESPACE
+
+QQuickTextLayoutJob::Input::Input()
+    : lineWidth(FLT_MAX)
+    , lineHeight(1.0)
+    , textRevision(0)
+    , fixedLineHeight(false)
+{
+}
+
+// The text and formats are identified by the revision, which changes whenever the item
+// sets new ones, so that long texts need not be compared.
+bool QQuickTextLayoutJob::Input::operator==(const Input &other) const
+{
+    return textRevision == other.textRevision
+            && lineWidth == other.lineWidth
+            && lineHeight == other.lineHeight
+            && fixedLineHeight == other.fixedLineHeight
+            && option.alignment() == other.option.alignment()
+            && option.wrapMode() == other.option.wrapMode()
+            && option.useDesignMetrics() == other.option.useDesignMetrics()
+            && font == other.font;
+}
+
+QQuickTextLayoutJob::QQuickTextLayoutJob(const Input &input)
+    : input(input)
+    , result(new QQuickTextLayoutCache::Entry)
+{
+    setAutoDelete(false);
+}
+
+void QQuickTextLayoutJob::start(QQuickTextLayoutJob *job)
+{
+    qquick_workerPool()->start(job);
+}
+
+qreal QQuickTextLayoutJob::layoutLines(QTextLayout *layout, qreal lineWidth)
+{
+    qreal height = 0;
+    layout->beginLayout();
+    for (QTextLine line = layout->createLine(); line.isValid(); line = layout->createLine()) {
+        line.setLineWidth(lineWidth);
+        line.setPosition(QPointF(0, height));
+        height += input.fixedLineHeight ? input.lineHeight : line.height() * input.lineHeight;
+    }
+    layout->endLayout();
+    return height;
+}
+
+void QQuickTextLayoutJob::run()
+{
+    QQuickTextLayoutCache::Entry *entry = result.data();
+    QTextLayout *layout = &entry->layout;
+
+    layout->setCacheEnabled(true);
+    layout->setFont(input.font);
+    layout->setTextOption(input.option);
+    layout->setText(input.text);
+    layout->setFormats(input.formats);
+
+    qreal height = layoutLines(layout, input.lineWidth);
+    const qreal naturalWidth = layout->maximumWidth();
+
+    // Without a width to align to, the lines are aligned within the widest one.
+    entry->lineWidth = input.lineWidth;
+    if (input.lineWidth == FLT_MAX) {
+        entry->lineWidth = naturalWidth;
+        if (layout->lineCount() > 1 && input.option.alignment() != Qt::AlignLeft)
+            height = layoutLines(layout, naturalWidth);
+    }
+
+    QRectF br;
+    bool wrapped = false;
+    for (int i = 0; i < layout->lineCount(); ++i) {
+        const QTextLine line = layout->lineAt(i);
+        br = br.united(line.naturalTextRect());
+        if (i > 0 && input.text.at(line.textStart() - 1) != QChar::LineSeparator)
+            wrapped = true;
+    }
+    br.moveTop(0);
+    br.setHeight(height);
+
+    const QTextLine firstLine = layout->lineAt(0);
+    entry->baseline = firstLine.isValid() ? firstLine.y() + firstLine.ascent() : 0;
+    entry->textRect = br;
+    entry->implicitSize = QSizeF(naturalWidth, height);
+    entry->lineCount = layout->lineCount();
+    entry->widthExceeded = wrapped;
+
+    emit finished(this);
+    deleteLater();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QQUICKTEXTLAYOUTJOB_P_H
+#define QQUICKTEXTLAYOUTJOB_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qquicktextlayoutcache_p.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qvector.h>
+#include <QtGui/qfont.h>
+#include <QtGui/qtextlayout.h>
+#include <QtGui/qtextoption.h>
+
+QT_BEGIN_NAMESPACE
+
+// Shapes and breaks text into lines on a worker thread, from a copy of everything the
+// layout depends on. The job deletes itself once the result has been delivered.
+class Q_QUICK_PRIVATE_EXPORT QQuickTextLayoutJob : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    struct Input
+    {
+        Input();
+
+        QString text;
+        QVector<QTextLayout::FormatRange> formats;
+        QFont font;
+        QTextOption option;
+        qreal lineWidth;
+        qreal lineHeight;
+        int textRevision;
+        bool fixedLineHeight;
+
+        bool operator==(const Input &other) const;
+        bool operator!=(const Input &other) const { return !operator==(other); }
+    };
+
+    explicit QQuickTextLayoutJob(const Input &input);
+
+    static void start(QQuickTextLayoutJob *job);
+
+    void run() Q_DECL_OVERRIDE;
+
+    const Input input;
+    QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> result;
+
+Q_SIGNALS:
+    void finished(QQuickTextLayoutJob *job);
+
+private:
+    qreal layoutLines(QTextLayout *layout, qreal lineWidth);
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKTEXTLAYOUTJOB_P_H
@@ -60,6 +60,7 @@
 #include <QtCore/qabstractanimation.h>
 #include <QtCore/QLibraryInfo>
 #include <QtCore/QRunnable>
+#include <QtCore/QElapsedTimer>
 #include <QtQml/qqmlincubator.h>
 
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -98,11 +99,24 @@ class QQuickWindowIncubationController : public QObject, public QQmlIncubationCo
     Q_OBJECT
 
 public:
-    QQuickWindowIncubationController(QSGRenderLoop *loop)
+    QQuickWindowIncubationController(QQuickWindow *window, QSGRenderLoop *loop)
         : m_renderLoop(loop), m_timer(0)
+        , m_lastFrameSwapped(-1)
+        , m_incubationSlices(0), m_incubatedObjects(0), m_missedDeadlines(0)
     {
+        qreal refreshRate = QGuiApplication::primaryScreen()->refreshRate();
+        m_frameInterval = refreshRate > 0 ? qMax(1, int(1000 / refreshRate)) : 16;
+
         // Allow incubation for 1/3 of a frame.
-        m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
+        m_incubation_time = qMax(1, m_frameInterval / 3);
+
+        // Keep a quarter of the frame for polishing and syncing the next one.
+        m_frameReserve = qMax(1, m_frameInterval / 4);
+
+        m_clock.start();
+
+        // With the threaded render loop, frameSwapped() is emitted on the render thread.
+        connect(window, SIGNAL(frameSwapped()), this, SLOT(frameSwapped()), Qt::DirectConnection);
 
         QAnimationDriver *animationDriver = m_renderLoop->animationDriver();
         if (animationDriver) {
@@ -127,13 +141,54 @@ protected:
         }
     }
 
+    // Returns the time left in the current frame interval, measured from the
+    // last buffer swap of the window. When the window has not swapped within
+    // the last interval, there is no frame to align to and the fixed budget
+    // is used instead.
+    int frameBudget() const
+    {
+        const qint64 lastFrameSwapped = m_lastFrameSwapped.load();
+        if (lastFrameSwapped < 0)
+            return m_incubation_time;
+
+        const qint64 sinceFrameSwapped = m_clock.elapsed() - lastFrameSwapped;
+        if (sinceFrameSwapped < 0 || sinceFrameSwapped >= m_frameInterval)
+            return m_incubation_time;
+
+        return qMax(1, m_frameInterval - int(sinceFrameSwapped) - m_frameReserve);
+    }
+
+    void incubateWithin(int msecs)
+    {
+        const int pendingBefore = incubatingObjectCount();
+
+        QElapsedTimer timer;
+        timer.start();
+        incubateFor(msecs);
+        const qint64 elapsed = timer.elapsed();
+
+        const int pending = incubatingObjectCount();
+        const int incubated = qMax(0, pendingBefore - pending);
+        ++m_incubationSlices;
+        m_incubatedObjects += incubated;
+        if (elapsed > msecs)
+            ++m_missedDeadlines;
+
+        qCDebug(QSG_LOG_TIME_INCUBATION).nospace()
+                << "incubated " << incubated << " objects in " << elapsed << "ms"
+                << ", budget=" << msecs << "ms"
+                << ", pending=" << pending
+                << ", total=" << m_incubatedObjects
+                << ", missed deadlines=" << m_missedDeadlines << "/" << m_incubationSlices;
+    }
+
 public slots:
     void incubate() {
         if (incubatingObjectCount()) {
             if (m_renderLoop->interleaveIncubation()) {
-                incubateFor(m_incubation_time);
+                incubateWithin(frameBudget());
             } else {
-                incubateFor(m_incubation_time * 2);
+                incubateWithin(m_incubation_time * 2);
                 if (incubatingObjectCount())
                     incubateAgain();
             }
@@ -142,6 +197,8 @@ public slots:
 
     void animationStopped() { incubate(); }
 
+    void frameSwapped() { m_lastFrameSwapped.store(m_clock.elapsed()); }
+
 protected:
     void incubatingObjectCountChanged(int count) Q_DECL_OVERRIDE
     {
@@ -152,7 +209,16 @@ protected:
 private:
     QSGRenderLoop *m_renderLoop;
     int m_incubation_time;
+    int m_frameInterval;
+    int m_frameReserve;
     int m_timer;
+
+    QElapsedTimer m_clock;
+    QAtomicInteger<qint64> m_lastFrameSwapped;
+
+    int m_incubationSlices;
+    qint64 m_incubatedObjects;
+    int m_missedDeadlines;
 };
 
 #include "qquickwindow.moc"
@@ -3389,6 +3455,10 @@ QImage QQuickWindow::grabWindow()
     for this window. QQuickView automatically installs this controller for you,
     otherwise you will need to install it yourself using \l{QQmlEngine::setIncubationController()}.
 
+    While animations are running, the controller incubates for the time that
+    is left of the current frame interval, measured from the last time the
+    window was swapped.
+
     The controller is owned by the window and will be destroyed when the window
     is deleted.
 */
@@ -3400,7 +3470,7 @@ QQmlIncubationController *QQuickWindow::incubationController() const
         return 0; // TODO: make sure that this is safe
 
     if (!d->incubationController)
-        d->incubationController = new QQuickWindowIncubationController(d->windowManager);
+        d->incubationController = new QQuickWindowIncubationController(const_cast<QQuickWindow *>(this), d->windowManager);
     return d->incubationController;
 }
 
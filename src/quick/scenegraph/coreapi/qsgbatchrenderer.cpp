@@ -41,6 +41,12 @@
 
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QtNumeric>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/private/qsimd_p.h>
 
 #include <QtGui/QGuiApplication>
 #include <QtGui/QOpenGLFramebufferObject>
@@ -48,7 +54,12 @@
 #include <QtGui/QOpenGLFunctions_1_0>
 #include <QtGui/QOpenGLFunctions_3_2_Core>
 
+#include <QtQuick/qsgflatcolormaterial.h>
+#include <QtQuick/qsgtexturematerial.h>
+#include <QtQuick/qsgvertexcolormaterial.h>
+
 #include <private/qquickprofiler_p.h>
+#include <private/qquickworkerpool_p.h>
 #include "qsgmaterialshader_p.h"
 
 #include <algorithm>
@@ -57,9 +68,35 @@
    #define GL_DOUBLE 0x140A
 #endif
 
+#ifndef GL_MAP_WRITE_BIT
+   #define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+   #define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+   #define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+   #define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+   #define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+   #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+   #define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_WAIT_FAILED
+   #define GL_WAIT_FAILED 0x911D
+#endif
+
 QT_BEGIN_NAMESPACE
 
 extern QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile);
+extern QByteArray qsgShaderRewriter_insertInstanceAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile);
 
 int qt_sg_envInt(const char *name, int defaultValue);
 
@@ -78,6 +115,7 @@ DECLARE_DEBUG_VAR(dump)
 DECLARE_DEBUG_VAR(noalpha)
 DECLARE_DEBUG_VAR(noopaque)
 DECLARE_DEBUG_VAR(noclip)
+DECLARE_DEBUG_VAR(noculling)
 #undef DECLARE_DEBUG_VAR
 
 static QElapsedTimer qsg_renderer_timer;
@@ -156,6 +194,8 @@ ShaderManager::Shader *ShaderManager::prepareMaterial(QSGMaterial *material)
     shader->program = s;
     shader->pos_order = i;
     shader->id_zRange = p->uniformLocation("_qt_zRange");
+    shader->pos_instanceOffset = -1;
+    shader->id_instanceMatrix = -1;
     shader->lastOpacity = 0;
 
     Q_ASSERT(shader->pos_order >= 0);
@@ -188,6 +228,8 @@ ShaderManager::Shader *ShaderManager::prepareMaterialNoRewrite(QSGMaterial *mate
     shader->program = s;
     shader->id_zRange = -1;
     shader->pos_order = -1;
+    shader->pos_instanceOffset = -1;
+    shader->id_instanceMatrix = -1;
     shader->lastOpacity = 0;
 
     stockShaders[type] = shader;
@@ -198,12 +240,71 @@ ShaderManager::Shader *ShaderManager::prepareMaterialNoRewrite(QSGMaterial *mate
     return shader;
 }
 
+/* Same as prepareMaterial(), but the vertex shader additionally takes a per
+ * instance offset which is translated by _qt_instanceMatrix, for drawing
+ * instanced batches.
+ */
+ShaderManager::Shader *ShaderManager::prepareMaterialInstanced(QSGMaterial *material)
+{
+    QSGMaterialType *type = material->type();
+    QHash<QSGMaterialType *, Shader *>::const_iterator it = instancedShaders.constFind(type);
+    if (it != instancedShaders.constEnd())
+        return it.value();
+
+    if (QSG_LOG_TIME_COMPILATION().isDebugEnabled())
+        qsg_renderer_timer.start();
+    Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphContextFrame);
+
+    QSGMaterialShader *s = material->createShader();
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    QSurfaceFormat::OpenGLContextProfile profile = ctx->format().profile();
+
+    QOpenGLShaderProgram *p = s->program();
+    char const *const *attr = s->attributeNames();
+    int i;
+    for (i = 0; attr[i]; ++i) {
+        if (*attr[i])
+            p->bindAttributeLocation(attr[i], i);
+    }
+    p->bindAttributeLocation("_qt_order", i);
+    p->bindAttributeLocation("_qt_instanceOffset", i + 1);
+    context->compile(s, material, qsgShaderRewriter_insertInstanceAttributes(s->vertexShader(), profile), 0);
+    context->initialize(s);
+    if (!p->isLinked()) {
+        // Remember the failure so the material falls back to merged batches
+        // instead of recompiling every frame.
+        delete s;
+        instancedShaders[type] = 0;
+        Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphContextFrame);
+        return 0;
+    }
+
+    Shader *shader = new Shader;
+    shader->program = s;
+    shader->pos_order = i;
+    shader->id_zRange = p->uniformLocation("_qt_zRange");
+    shader->pos_instanceOffset = i + 1;
+    shader->id_instanceMatrix = p->uniformLocation("_qt_instanceMatrix");
+    shader->lastOpacity = 0;
+
+    Q_ASSERT(shader->id_instanceMatrix >= 0);
+
+    qCDebug(QSG_LOG_TIME_COMPILATION, "shader compiled in %dms (instanced)", (int) qsg_renderer_timer.elapsed());
+
+    Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphContextFrame);
+
+    instancedShaders[type] = shader;
+    return shader;
+}
+
 void ShaderManager::invalidated()
 {
     qDeleteAll(stockShaders);
     stockShaders.clear();
     qDeleteAll(rewrittenShaders);
     rewrittenShaders.clear();
+    qDeleteAll(instancedShaders);
+    instancedShaders.clear();
     delete blitProgram;
     blitProgram = 0;
 }
@@ -753,6 +854,7 @@ Renderer::Renderer(QSGRenderContext *ctx)
     , m_elementsToDelete(64)
     , m_tmpAlphaElements(16)
     , m_tmpOpaqueElements(16)
+    , m_changedAlphaElements(16)
     , m_rebuild(FullRebuild)
     , m_zRange(0)
     , m_renderOrderRebuildLower(-1)
@@ -782,20 +884,44 @@ Renderer::Renderer(QSGRenderContext *ctx)
     }
 
     m_bufferStrategy = GL_STATIC_DRAW;
+    bool useRingBuffer = false;
     if (Q_UNLIKELY(qEnvironmentVariableIsSet("QSG_RENDERER_BUFFER_STRATEGY"))) {
         const QByteArray strategy = qgetenv("QSG_RENDERER_BUFFER_STRATEGY");
         if (strategy == "dynamic")
             m_bufferStrategy = GL_DYNAMIC_DRAW;
         else if (strategy == "stream")
             m_bufferStrategy = GL_STREAM_DRAW;
+        else if (strategy == "ring")
+            useRingBuffer = true;
     }
 
+    m_ringBuffer = 0;
+    m_ringSegmentSize = 0;
+    m_ringSegment = 0;
+    m_ringHead = 0;
+    m_ringMemory = 0;
+    for (int i=0; i<RingSegments; ++i)
+        m_ringFences[i] = 0;
+    m_ringFuncs = 0;
+    m_frame = 0;
+    m_uploadedBytes = 0;
+    m_culledElements = 0;
+    if (useRingBuffer)
+        createRingBuffer(qt_sg_envInt("QSG_RENDERER_RING_BUFFER_SIZE", 1024 * 1024));
+
     m_batchNodeThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_NODE_THRESHOLD", 64);
     m_batchVertexThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_VERTEX_THRESHOLD", 1024);
+    m_parallelUploadThreshold = QThread::idealThreadCount() > 1
+            ? qt_sg_envInt("QSG_RENDERER_PARALLEL_UPLOAD_THRESHOLD", 8192) : 0;
+    m_fillBatchesInParallel = false;
+    m_parallelUploadPoolUsed = 0;
+    m_partialUploads = qEnvironmentVariableIsEmpty("QSG_RENDERER_NO_PARTIAL_UPLOAD");
 
     if (Q_UNLIKELY(debug_build() || debug_render())) {
-        qDebug() << "Batch thresholds: nodes:" << m_batchNodeThreshold << " vertices:" << m_batchVertexThreshold;
-        qDebug() << "Using buffer strategy:" << (m_bufferStrategy == GL_STATIC_DRAW ? "static" : (m_bufferStrategy == GL_DYNAMIC_DRAW ? "dynamic" : "stream"));
+        qDebug() << "Batch thresholds: nodes:" << m_batchNodeThreshold << " vertices:" << m_batchVertexThreshold
+                 << " parallel upload vertices:" << m_parallelUploadThreshold;
+        qDebug() << "Using buffer strategy:" << (m_bufferStrategy == GL_STATIC_DRAW ? "static" : (m_bufferStrategy == GL_DYNAMIC_DRAW ? "dynamic" : "stream"))
+                 << (m_ringBuffer ? (m_ringMemory ? "+ persistent ring" : "+ ring") : "");
     }
 
     // If rendering with an OpenGL Core profile context, we need to create a VAO
@@ -807,6 +933,17 @@ Renderer::Renderer(QSGRenderContext *ctx)
 
     bool useDepth = qEnvironmentVariableIsEmpty("QSG_NO_DEPTH_BUFFER");
     m_useDepthBuffer = useDepth && ctx->openglContext()->format().depthBufferSize() > 0;
+
+    m_instancingThreshold = 0;
+    m_instancingFuncs = 0;
+    QOpenGLContext *gl = ctx->openglContext();
+    const bool hasInstancing = gl->isOpenGLES()
+            ? gl->format().majorVersion() >= 3
+            : gl->format().version() >= qMakePair(3, 3);
+    if (hasInstancing && !ctx->hasBrokenIndexBufferObjects()) {
+        m_instancingThreshold = qMax(0, qt_sg_envInt("QSG_RENDERER_INSTANCING_THRESHOLD", 16));
+        m_instancingFuncs = gl->extraFunctions();
+    }
 }
 
 static void qsg_wipeBuffer(Buffer *buffer, QOpenGLFunctions *funcs)
@@ -836,6 +973,7 @@ Renderer::~Renderer()
         for (int i=0; i<m_opaqueBatches.size(); ++i) qsg_wipeBatch(m_opaqueBatches.at(i), this);
         for (int i=0; i<m_alphaBatches.size(); ++i) qsg_wipeBatch(m_alphaBatches.at(i), this);
         for (int i=0; i<m_batchPool.size(); ++i) qsg_wipeBatch(m_batchPool.at(i), this);
+        destroyRingBuffer();
     }
 
     foreach (Node *n, m_nodes.values())
@@ -882,9 +1020,19 @@ void Renderer::map(Buffer *buffer, int byteSize, bool isIndexBuf)
                 m_vertexUploadPool;
         Q_UNUSED(isIndexBuf);
 #endif
-        if (byteSize > pool.size())
-            pool.resize(byteSize);
-        buffer->data = pool.data();
+        if (m_fillBatchesInParallel) {
+            // Batches filled concurrently cannot share the upload pool
+            if (m_parallelUploadPoolUsed == m_parallelUploadPool.size())
+                m_parallelUploadPool.append(QByteArray());
+            QByteArray &scratch = m_parallelUploadPool[m_parallelUploadPoolUsed++];
+            if (byteSize > scratch.size())
+                scratch.resize(byteSize);
+            buffer->data = scratch.data();
+        } else {
+            if (byteSize > pool.size())
+                pool.resize(byteSize);
+            buffer->data = pool.data();
+        }
     } else if (buffer->size != byteSize) {
         free(buffer->data);
         buffer->data = (char *) malloc(byteSize);
@@ -892,19 +1040,174 @@ void Renderer::map(Buffer *buffer, int byteSize, bool isIndexBuf)
     buffer->size = byteSize;
 }
 
-void Renderer::unmap(Buffer *buffer, bool isIndexBuf)
+void Renderer::unmap(Buffer *buffer, bool isIndexBuf, bool stream)
 {
-    if (buffer->id == 0)
-        glGenBuffers(1, &buffer->id);
-    GLenum target = isIndexBuf ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
-    glBindBuffer(target, buffer->id);
-    glBufferData(target, buffer->size, buffer->data, m_bufferStrategy);
+    if (!stream || !streamBuffer(buffer)) {
+        if (buffer->id == 0)
+            glGenBuffers(1, &buffer->id);
+        GLenum target = isIndexBuf ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+        glBindBuffer(target, buffer->id);
+        glBufferData(target, buffer->size, buffer->data, m_bufferStrategy);
+        buffer->ringId = 0;
+        buffer->offset = 0;
+    }
+    m_uploadedBytes += buffer->size;
 
-    if (!m_context->hasBrokenIndexBufferObjects() && m_visualizeMode == VisualizeNothing) {
+    if (!m_context->hasBrokenIndexBufferObjects() && m_visualizeMode == VisualizeNothing)
         buffer->data = 0;
+}
+
+/* The ring buffer is used for batches which are uploaded in consecutive
+ * frames, typically because they are animated. Instead of respecifying the
+ * batch's own buffer object every frame, which makes the driver orphan and
+ * reallocate its storage, the data is suballocated from the frame's segment
+ * of one large buffer. Where GL_ARB_buffer_storage / GL_EXT_buffer_storage is
+ * available, the ring is mapped once, persistently and coherently. Otherwise
+ * each range is mapped unsynchronized. In both cases the fences on the
+ * segments make sure that we never write to memory the GPU is still reading.
+ *
+ * The batches are still filled in the regular upload pool and then copied into
+ * the ring, as the mapped memory is typically uncached and the fill does a lot
+ * of read-modify-write.
+ */
+void Renderer::createRingBuffer(int segmentSize)
+{
+    QOpenGLContext *gl = QOpenGLContext::currentContext();
+    const QSurfaceFormat format = gl->format();
+    const bool hasMapBufferRange = gl->isOpenGLES()
+            ? format.majorVersion() >= 3
+            : (format.version() >= qMakePair(3, 2)
+               || (gl->hasExtension("GL_ARB_map_buffer_range") && gl->hasExtension("GL_ARB_sync")));
+    if (!hasMapBufferRange || segmentSize <= 0
+            || m_context->hasBrokenIndexBufferObjects()) {
+        qWarning("QSG_RENDERER_BUFFER_STRATEGY=ring is not supported by this OpenGL implementation");
+        return;
+    }
+
+    typedef void (QOPENGLF_APIENTRYP BufferStorage)(GLenum, GLsizeiptr, const void *, GLbitfield);
+    BufferStorage bufferStorage = 0;
+    if (gl->isOpenGLES()) {
+        if (gl->hasExtension("GL_EXT_buffer_storage"))
+            bufferStorage = reinterpret_cast<BufferStorage>(gl->getProcAddress("glBufferStorageEXT"));
+    } else if (format.version() >= qMakePair(4, 4) || gl->hasExtension("GL_ARB_buffer_storage")) {
+        bufferStorage = reinterpret_cast<BufferStorage>(gl->getProcAddress("glBufferStorage"));
+    }
+
+    m_ringFuncs = gl->extraFunctions();
+    m_ringSegmentSize = segmentSize;
+    const int size = segmentSize * RingSegments;
+
+    glGenBuffers(1, &m_ringBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_ringBuffer);
+    if (bufferStorage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(GL_ARRAY_BUFFER, size, 0, flags);
+        m_ringMemory = (char *) m_ringFuncs->glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (!m_ringMemory) {
+            // Immutable storage cannot be respecified, start over with a new buffer.
+            glDeleteBuffers(1, &m_ringBuffer);
+            glGenBuffers(1, &m_ringBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, m_ringBuffer);
+        }
+    }
+    if (!m_ringMemory)
+        glBufferData(GL_ARRAY_BUFFER, size, 0, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::destroyRingBuffer()
+{
+    if (!m_ringBuffer)
+        return;
+    for (int i=0; i<RingSegments; ++i) {
+        if (m_ringFences[i])
+            m_ringFuncs->glDeleteSync(m_ringFences[i]);
+        m_ringFences[i] = 0;
+    }
+    if (m_ringMemory) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_ringBuffer);
+        m_ringFuncs->glUnmapBuffer(GL_ARRAY_BUFFER);
+        m_ringMemory = 0;
+    }
+    glDeleteBuffers(1, &m_ringBuffer);
+    m_ringBuffer = 0;
+}
+
+/* Moves on to the next segment of the ring and decides which batches stream
+ * their data through it this frame. Batches which were streamed last frame but
+ * did not change are uploaded once more, into their own buffer, as their part
+ * of the ring is about to be reused.
+ */
+void Renderer::beginRingFrame()
+{
+    m_ringSegment = (m_ringSegment + 1) % RingSegments;
+    m_ringHead = m_ringSegment * m_ringSegmentSize;
+
+    GLsync &fence = m_ringFences[m_ringSegment];
+    if (fence) {
+        GLenum result = m_ringFuncs->glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        if (Q_UNLIKELY(result == GL_WAIT_FAILED))
+            qWarning("QSGBatchRenderer: waiting for the ring buffer fence failed");
+        m_ringFuncs->glDeleteSync(fence);
+        fence = 0;
+    }
+
+    for (int l=0; l<2; ++l) {
+        const QDataBuffer<Batch *> &batches = l == 0 ? m_opaqueBatches : m_alphaBatches;
+        for (int i=0; i<batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            bool inRing = b->vbo.ringId;
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+            inRing |= b->ibo.ringId != 0;
+#endif
+            if (inRing && !b->needsUpload) {
+                b->needsUpload = true;
+                b->dirtyElementsOnly = false;
+                b->streamed = false;
+            } else {
+                b->streamed = b->needsUpload && !b->dirtyElementsOnly
+                        && m_visualizeMode == VisualizeNothing
+                        && b->lastUploadFrame && b->lastUploadFrame + 1 == m_frame;
+            }
+        }
     }
 }
 
+void Renderer::endRingFrame()
+{
+    if (m_ringHead > m_ringSegment * m_ringSegmentSize)
+        m_ringFences[m_ringSegment] = m_ringFuncs->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/* Copies the buffer's data into the current segment of the ring. Returns false
+ * if it does not fit, in which case the caller uploads it the regular way.
+ */
+bool Renderer::streamBuffer(Buffer *buffer)
+{
+    const int segmentEnd = (m_ringSegment + 1) * m_ringSegmentSize;
+    const int offset = m_ringHead;
+    if (offset + buffer->size > segmentEnd)
+        return false;
+
+    if (m_ringMemory) {
+        memcpy(m_ringMemory + offset, buffer->data, buffer->size);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, m_ringBuffer);
+        void *dst = m_ringFuncs->glMapBufferRange(GL_ARRAY_BUFFER, offset, buffer->size,
+                                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (!dst)
+            return false;
+        memcpy(dst, buffer->data, buffer->size);
+        m_ringFuncs->glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    // Keep the next allocation aligned for any vertex attribute type.
+    m_ringHead = (offset + buffer->size + 15) & ~15;
+    buffer->ringId = m_ringBuffer;
+    buffer->offset = offset;
+    return true;
+}
+
 BatchRootInfo *Renderer::batchRootInfo(Node *node)
 {
     BatchRootInfo *info = node->rootInfo();
@@ -987,6 +1290,7 @@ void Renderer::nodeWasTransformed(Node *node, int *vertexCount)
                     invalidateBatchAndOverlappingRenderOrders(e->batch);
                 } else if (e->batch->merged) {
                     e->batch->needsUpload = true;
+                    e->batch->dirtyElementsOnly = false;
                 }
             }
         }
@@ -1050,6 +1354,7 @@ void Renderer::nodeWasRemoved(Node *node)
             }
             if (e->batch) {
                 e->batch->needsUpload = true;
+                e->batch->dirtyElementsOnly = false;
             }
 
         }
@@ -1189,14 +1494,31 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
         QSGGeometryNode *gn = static_cast<QSGGeometryNode *>(node);
         Element *e = shadowNode->element();
         if (e) {
-            e->boundsComputed = false;
             Batch *b = e->batch;
             if (b) {
-                if (!e->batch->geometryWasChanged(gn) || !e->batch->isOpaque) {
-                    invalidateBatchAndOverlappingRenderOrders(e->batch);
+                const bool wasUploaded = !b->needsUpload;
+                if (!b->geometryWasChanged(gn) || (!b->isOpaque && !e->boundsComputed)) {
+                    e->boundsComputed = false;
+                    invalidateBatchAndOverlappingRenderOrders(b);
                 } else {
                     b->needsUpload = true;
+                    // Unless something else already asked for the whole batch,
+                    // only the changed elements need to be uploaded again.
+                    if (wasUploaded)
+                        b->dirtyElementsOnly = true;
+                    e->geometryDirty = true;
+                    if (b->isOpaque) {
+                        e->boundsComputed = false;
+                    } else {
+                        // The alpha batch stays valid if the element does not grow
+                        // into its neighbours. Its new bounds depend on transforms
+                        // which are not up to date until render(), so keep the old
+                        // ones around until then.
+                        m_changedAlphaElements.add(e);
+                    }
                 }
+            } else {
+                e->boundsComputed = false;
             }
         }
     }
@@ -1440,6 +1762,31 @@ void Renderer::buildRenderListsFromScratch()
     buildRenderLists(rootNode());
 }
 
+/*
+ * Alpha batches are only kept when an element's geometry changes if the
+ * element's bounds did not grow, otherwise it may now overlap elements of
+ * other batches which are drawn in between.
+ */
+void Renderer::checkChangedAlphaElements()
+{
+    for (int i=0; i<m_changedAlphaElements.size(); ++i) {
+        Element *e = m_changedAlphaElements.at(i);
+        // Removed, or already handled by a transform change or an earlier entry.
+        if (e->removed || !e->boundsComputed)
+            continue;
+        const Rect oldBounds = e->bounds;
+        e->boundsComputed = false;
+        if (!e->batch)
+            continue;
+        e->computeBounds();
+        if (e->boundsOutsideFloatRange || !oldBounds.contains(e->bounds)) {
+            if (Q_UNLIKELY(debug_upload())) qDebug() << " - element" << e << "grew from" << oldBounds << "to" << e->bounds;
+            invalidateBatchAndOverlappingRenderOrders(e->batch);
+        }
+    }
+    m_changedAlphaElements.reset();
+}
+
 void Renderer::invalidateBatchAndOverlappingRenderOrders(Batch *batch)
 {
     Q_ASSERT(batch);
@@ -1660,6 +2007,47 @@ static inline int qsg_fixIndexCount(int iCount, GLenum drawMode) {
     }
 }
 
+static inline void qsg_rebaseIndices(quint16 *dst, const quint16 *src, int count, quint16 base)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i vbase = _mm_set1_epi16(base);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_add_epi16(v, vbase));
+    }
+#elif defined(__ARM_NEON__)
+    const uint16x8_t vbase = vdupq_n_u16(base);
+    for (; i + 8 <= count; i += 8)
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), vbase));
+#endif
+    for (; i < count; ++i)
+        dst[i] = base + src[i];
+}
+
+static inline void qsg_sequentialIndices(quint16 *dst, int count, quint16 base)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i v = _mm_add_epi16(_mm_set1_epi16(base), _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m128i step = _mm_set1_epi16(8);
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+        v = _mm_add_epi16(v, step);
+    }
+#elif defined(__ARM_NEON__)
+    static const quint16 ramp[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    uint16x8_t v = vaddq_u16(vdupq_n_u16(base), vld1q_u16(ramp));
+    const uint16x8_t step = vdupq_n_u16(8);
+    for (; i + 8 <= count; i += 8) {
+        vst1q_u16(dst + i, v);
+        v = vaddq_u16(v, step);
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = base + i;
+}
+
 /* These parameters warrant some explanation...
  *
  * vaOffset: The byte offset into the vertex data to the location of the
@@ -1719,8 +2107,7 @@ void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData,
         else
             iCount = qsg_fixIndexCount(iCount, g->drawingMode());
 
-        for (int i=0; i<iCount; ++i)
-            indices[i] = *iBase + i;
+        qsg_sequentialIndices(indices, iCount, *iBase);
     } else {
         const quint16 *srcIndices = g->indexDataAsUShort();
         if (g->drawingMode() == GL_TRIANGLE_STRIP)
@@ -1728,8 +2115,7 @@ void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData,
         else
             iCount = qsg_fixIndexCount(iCount, g->drawingMode());
 
-        for (int i=0; i<iCount; ++i)
-            indices[i] = *iBase + srcIndices[i];
+        qsg_rebaseIndices(indices, srcIndices, iCount, *iBase);
     }
     if (g->drawingMode() == GL_TRIANGLE_STRIP) {
         indices[iCount] = indices[iCount - 1];
@@ -1752,21 +2138,81 @@ static QMatrix4x4 qsg_matrixForRoot(Node *node)
 }
 
 void Renderer::uploadBatch(Batch *b)
+{
+    if (uploadDirtyElements(b))
+        return;
+    if (prepareBatchUpload(b)) {
+        fillBatch(b);
+        finishBatchUpload(b);
+    }
+}
+
+// Per instance data: x and y offset relative to the batch root, and z order.
+static const int qsg_instance_stride = 3 * sizeof(float);
+
+/* The instanced vertex shader adds the transformed offset to gl_Position,
+ * which is only correct when gl_Position is a linear function of the vertex
+ * position. Custom materials and shaders that snap to pixels or expand
+ * outlines, such as text and the antialiasing materials, are not.
+ */
+static bool qsg_isInstanceableMaterial(QSGMaterial *m)
+{
+    static QSGMaterialType *flatColorType = QSGFlatColorMaterial().type();
+    static QSGMaterialType *opaqueTextureType = QSGOpaqueTextureMaterial().type();
+    static QSGMaterialType *textureType = QSGTextureMaterial().type();
+    static QSGMaterialType *vertexColorType = QSGVertexColorMaterial().type();
+
+    QSGMaterialType *type = m->type();
+    return type == flatColorType || type == opaqueTextureType || type == textureType
+            || type == vertexColorType;
+}
+
+/* Returns the number of elements in the batch if they all draw the same
+ * geometry and differ only in their translation, otherwise 0.
+ */
+static int qsg_instanceCount(const Batch *b)
+{
+    const QSGGeometry *g = b->first->node->geometry();
+    const int vertexBytes = g->vertexCount() * g->sizeOfVertex();
+    const int indexBytes = g->indexCount() * g->sizeOfIndex();
+    int count = 0;
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (!QMatrix4x4_Accessor::isTranslate(*e->node->matrix()))
+            return 0;
+        const QSGGeometry *eg = e->node->geometry();
+        if (eg != g) {
+            if (eg->vertexCount() != g->vertexCount() || eg->indexCount() != g->indexCount()
+                    || eg->sizeOfVertex() != g->sizeOfVertex() || eg->indexType() != g->indexType()
+                    || eg->drawingMode() != g->drawingMode())
+                return 0;
+            if (memcmp(eg->vertexData(), g->vertexData(), vertexBytes) != 0
+                    || (indexBytes && memcmp(eg->indexData(), g->indexData(), indexBytes) != 0))
+                return 0;
+        }
+        ++count;
+    }
+    return count;
+}
+
+/* Works out whether the batch can be merged and how large its buffers need to
+ * be, and maps them. Returns false if there is nothing to upload.
+ */
+bool Renderer::prepareBatchUpload(Batch *b)
 {
         // Early out if nothing has changed in this batch..
         if (!b->needsUpload) {
             if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "already uploaded...";
-            return;
+            return false;
         }
 
         if (!b->first) {
             if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "is invalid...";
-            return;
+            return false;
         }
 
         if (b->isRenderNode) {
             if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch: " << b << "is a render node...";
-            return;
+            return false;
         }
 
         // Figure out if we can merge or not, if not, then just render the batch as is..
@@ -1786,6 +2232,37 @@ void Renderer::uploadBatch(Batch *b)
 
         b->merged = canMerge;
 
+        // Identical geometries are uploaded once and drawn instanced, only
+        // their offsets are uploaded per element.
+        b->instanced = false;
+        if (canMerge && m_instancingThreshold > 0 && m_visualizeMode == VisualizeNothing
+                && (flags & QSGMaterial::RequiresFullMatrixExceptTranslate) == 0
+                && qsg_isInstanceableMaterial(gn->activeMaterial())) {
+            const int instances = qsg_instanceCount(b);
+            if (instances >= m_instancingThreshold
+                    && m_shaderManager->prepareMaterialInstanced(gn->activeMaterial())) {
+                b->instanced = true;
+                b->instanceCount = instances;
+                b->vertexCount = g->vertexCount();
+                b->indexCount = g->indexCount();
+                if (b->vertexCount == 0)
+                    return false;
+
+                int bufferSize = b->vertexCount * g->sizeOfVertex() + instances * qsg_instance_stride;
+                int ibufferSize = b->indexCount * g->sizeOfIndex();
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+                map(&b->ibo, ibufferSize, true);
+#else
+                bufferSize += ibufferSize;
+#endif
+                map(&b->vbo, bufferSize);
+
+                if (Q_UNLIKELY(debug_upload())) qDebug() << " - batch" << b << " first:" << b->first << " root:"
+                                           << b->root << " instances:" << instances << " vbo:" << b->vbo.id << ":" << b->vbo.size;
+                return true;
+            }
+        }
+
         // Figure out how much memory we need...
         b->vertexCount = 0;
         b->indexCount = 0;
@@ -1810,7 +2287,7 @@ void Renderer::uploadBatch(Batch *b)
         // Abort if there are no vertices in this batch.. We abort this late as
         // this is a broken usecase which we do not care to optimize for...
         if (b->vertexCount == 0 || (b->merged && b->indexCount == 0))
-            return;
+            return false;
 
         /* Allocate memory for this batch. Merged batches are divided into three separate blocks
            1. Vertex data for all elements, as they were in the QSGGeometry object, but
@@ -1845,7 +2322,44 @@ void Renderer::uploadBatch(Batch *b)
                                    << b->root << " merged:" << b->merged << " positionAttribute" << b->positionAttribute
                                    << " vbo:" << b->vbo.id << ":" << b->vbo.size;
 
-        if (b->merged) {
+        return true;
+}
+
+/* Fills the mapped buffers of the batch with the (transformed) vertex and index
+ * data of its elements. This only touches CPU memory owned by the batch, so
+ * different batches can be filled concurrently.
+ */
+void Renderer::fillBatch(Batch *b)
+{
+        QSGGeometry *g = b->first->node->geometry();
+
+        if (b->instanced) {
+            char *vertexData = b->vbo.data;
+            memcpy(vertexData, g->vertexData(), b->vertexCount * g->sizeOfVertex());
+            char *instanceData = vertexData + b->vertexCount * g->sizeOfVertex();
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+            char *indexData = b->ibo.data;
+            const int indexOffset = 0;
+#else
+            char *indexData = instanceData + b->instanceCount * qsg_instance_stride;
+            const int indexOffset = indexData - vertexData;
+#endif
+            memcpy(indexData, g->indexData(), b->indexCount * g->sizeOfIndex());
+
+            float *instance = (float *) instanceData;
+            for (Element *e = b->first; e; e = e->nextInBatch) {
+                const QMatrix4x4_Accessor &m = (const QMatrix4x4_Accessor &) *e->node->matrix();
+                *instance++ = m.m[3][0];
+                *instance++ = m.m[3][1];
+                *instance++ = m_useDepthBuffer ? 1.0f - e->order * m_zRange : 0.0f;
+                e->geometryDirty = false;
+            }
+
+            // The single draw set points to the instance data instead of z data.
+            b->drawSets.reset();
+            b->drawSets << DrawSet(0, instanceData - vertexData, indexOffset);
+            b->drawSets.last().indexCount = b->indexCount;
+        } else if (b->merged) {
             char *vertexData = b->vbo.data;
             char *zData = vertexData + b->vertexCount * g->sizeOfVertex();
 #ifdef QSG_SEPARATE_INDEX_BUFFER
@@ -1855,7 +2369,6 @@ void Renderer::uploadBatch(Batch *b)
 #endif
 
             quint16 iOffset = 0;
-            e = b->first;
             int verticesInSet = 0;
             int indicesInSet = 0;
             b->drawSets.reset();
@@ -1865,6 +2378,7 @@ void Renderer::uploadBatch(Batch *b)
             int drawSetIndices = indexData - vertexData;
 #endif
             b->drawSets << DrawSet(0, zData - vertexData, drawSetIndices);
+            Element *e = b->first;
             while (e) {
                 verticesInSet  += e->node->geometry()->vertexCount();
                 if (verticesInSet > 0xffff) {
@@ -1885,7 +2399,18 @@ void Renderer::uploadBatch(Batch *b)
                     verticesInSet = e->node->geometry()->vertexCount();
                     indicesInSet = 0;
                 }
+                e->vertexOffset = vertexData - b->vbo.data;
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+                e->indexOffset = indexData - b->ibo.data;
+#else
+                e->indexOffset = indexData - b->vbo.data;
+#endif
+                e->indexBase = iOffset;
+                e->uploadedVertexCount = e->node->geometry()->vertexCount();
+                const int indicesBefore = indicesInSet;
                 uploadMergedElement(e, b->positionAttribute, &vertexData, &zData, &indexData, &iOffset, &indicesInSet);
+                e->uploadedIndexCount = indicesInSet - indicesBefore;
+                e->geometryDirty = false;
                 e = e->nextInBatch;
             }
             b->drawSets.last().indexCount = indicesInSet;
@@ -1913,11 +2438,17 @@ void Renderer::uploadBatch(Batch *b)
                     memcpy(iboData, g->indexData(), ibs);
                     iboData += ibs;
                 }
+                e->geometryDirty = false;
                 e = e->nextInBatch;
             }
         }
+}
+
+void Renderer::finishBatchUpload(Batch *b)
+{
 #ifndef QT_NO_DEBUG_OUTPUT
         if (Q_UNLIKELY(debug_upload())) {
+            QSGGeometry *g = b->first->node->geometry();
             const char *vd = b->vbo.data;
             qDebug() << "  -- Vertex Data, count:" << b->vertexCount << " - " << g->sizeOfVertex() << "bytes/vertex";
             for (int i=0; i<b->vertexCount; ++i) {
@@ -1941,7 +2472,7 @@ void Renderer::uploadBatch(Batch *b)
                     dump << ") ";
                     offset += attr.tupleSize * size_of_type(attr.type);
                 }
-                if (b->merged && m_useDepthBuffer) {
+                if (b->merged && !b->instanced && m_useDepthBuffer) {
                     float zorder = ((float*)(b->vbo.data + b->vertexCount * g->sizeOfVertex()))[i];
                     dump << " Z:(" << zorder << ")";
                 }
@@ -1971,19 +2502,214 @@ void Renderer::uploadBatch(Batch *b)
         }
 #endif // QT_NO_DEBUG_OUTPUT
 
-        unmap(&b->vbo);
+        unmap(&b->vbo, false, b->streamed);
 #ifdef QSG_SEPARATE_INDEX_BUFFER
-        unmap(&b->ibo, true);
+        unmap(&b->ibo, true, b->streamed);
 #endif
 
         if (Q_UNLIKELY(debug_upload())) qDebug() << "  --- vertex/index buffers unmapped, batch upload completed...";
 
         b->needsUpload = false;
+        b->dirtyElementsOnly = false;
+        b->lastUploadFrame = m_frame;
 
         if (Q_UNLIKELY(debug_render()))
             b->uploadedThisFrame = true;
 }
 
+/* Uploads only the elements of a merged batch whose geometry changed, in
+ * place, when their vertex and index counts are the same as in the last
+ * upload. Returns false if the batch needs a regular upload.
+ */
+bool Renderer::uploadDirtyElements(Batch *b)
+{
+    // Render orders and the z range only change when rebuilding, so the
+    // positions of the elements in the buffers are still valid otherwise.
+    if (!m_partialUploads || !b->needsUpload || !b->dirtyElementsOnly || !b->merged || b->instanced
+            || !b->first || b->isRenderNode || m_rebuild != 0 || b->streamed || b->vbo.ringId || !b->vbo.id
+            || m_context->hasBrokenIndexBufferObjects() || m_visualizeMode != VisualizeNothing)
+        return false;
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    if (b->ibo.ringId || !b->ibo.id)
+        return false;
+#endif
+
+    QSGGeometry *g = b->first->node->geometry();
+    int dirtyBytes = 0;
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (!e->geometryDirty)
+            continue;
+        QSGGeometry *eg = e->node->geometry();
+        if (eg->drawingMode() != g->drawingMode() || eg->indexType() != GL_UNSIGNED_SHORT)
+            return false;
+        int iCount = eg->indexCount();
+        if (iCount == 0)
+            iCount = eg->vertexCount();
+        iCount = qsg_fixIndexCount(iCount, g->drawingMode());
+        if (eg->vertexCount() != e->uploadedVertexCount || iCount != e->uploadedIndexCount)
+            return false;
+        dirtyBytes = qMax(dirtyBytes, e->uploadedVertexCount * (g->sizeOfVertex() + int(sizeof(float)))
+                                      + e->uploadedIndexCount * int(sizeof(quint16)));
+    }
+
+    if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "uploading changed elements only...";
+
+    if (dirtyBytes > m_vertexUploadPool.size())
+        m_vertexUploadPool.resize(dirtyBytes);
+
+    glBindBuffer(GL_ARRAY_BUFFER, b->vbo.id);
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, b->ibo.id);
+    const GLenum indexTarget = GL_ELEMENT_ARRAY_BUFFER;
+#else
+    const GLenum indexTarget = GL_ARRAY_BUFFER;
+#endif
+
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (!e->geometryDirty)
+            continue;
+        const int vertexBytes = e->uploadedVertexCount * g->sizeOfVertex();
+        const int zBytes = m_useDepthBuffer ? e->uploadedVertexCount * sizeof(float) : 0;
+        const int indexBytes = e->uploadedIndexCount * sizeof(quint16);
+
+        char *vertexData = m_vertexUploadPool.data();
+        char *zData = vertexData + vertexBytes;
+        char *indexData = zData + zBytes;
+        quint16 iBase = e->indexBase;
+        int indexCount = 0;
+        uploadMergedElement(e, b->positionAttribute, &vertexData, &zData, &indexData, &iBase, &indexCount);
+        Q_ASSERT(indexCount == e->uploadedIndexCount);
+
+        // The element's order did not change, so neither did its z data.
+        glBufferSubData(GL_ARRAY_BUFFER, e->vertexOffset, vertexBytes, m_vertexUploadPool.data());
+        glBufferSubData(indexTarget, e->indexOffset, indexBytes, m_vertexUploadPool.data() + vertexBytes + zBytes);
+        m_uploadedBytes += vertexBytes + indexBytes;
+
+        e->geometryDirty = false;
+    }
+
+    b->needsUpload = false;
+    b->dirtyElementsOnly = false;
+    b->lastUploadFrame = m_frame;
+
+    if (Q_UNLIKELY(debug_render()))
+        b->uploadedThisFrame = true;
+
+    return true;
+}
+
+class BatchFiller
+{
+public:
+    BatchFiller(Renderer *renderer, const QVector<Batch *> &batches)
+        : m_renderer(renderer), m_batches(batches), m_next(0)
+    { }
+
+    // Batches are claimed one at a time, so a few large batches do not leave
+    // the other threads idle.
+    void fill()
+    {
+        const int count = m_batches.size();
+        int i;
+        while ((i = m_next.fetchAndAddRelaxed(1)) < count)
+            m_renderer->fillBatch(m_batches.at(i));
+    }
+
+private:
+    Renderer *m_renderer;
+    const QVector<Batch *> &m_batches;
+    QAtomicInt m_next;
+};
+
+class BatchFillerTask : public QRunnable
+{
+public:
+    BatchFillerTask(BatchFiller *filler, QSemaphore *done)
+        : m_filler(filler), m_done(done)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_filler->fill();
+        m_done->release();
+    }
+
+private:
+    BatchFiller *m_filler;
+    QSemaphore *m_done;
+};
+
+/* Uploads all pending batches, filling their buffers on several threads when
+ * there is enough vertex data to make it worthwhile. Each batch gets its own
+ * buffer from the parallel upload pool for the duration, the GL calls in map()
+ * and unmap() stay on the render thread. Returns false if nothing was done, in
+ * which case the batches are left for the regular serial upload.
+ */
+bool Renderer::uploadBatchesInParallel()
+{
+    if (m_parallelUploadThreshold <= 0
+            || m_visualizeMode != VisualizeNothing
+            || m_context->hasBrokenIndexBufferObjects())
+        return false;
+
+    QVector<Batch *> pending;
+    int vertexCount = 0;
+    for (int l=0; l<2; ++l) {
+        const QDataBuffer<Batch *> &batches = l == 0 ? m_opaqueBatches : m_alphaBatches;
+        for (int i=0; i<batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            if (!b->needsUpload || !b->first || b->isRenderNode || uploadDirtyElements(b))
+                continue;
+            for (Element *e = b->first; e; e = e->nextInBatch)
+                vertexCount += e->node->geometry()->vertexCount();
+            pending << b;
+        }
+    }
+
+    if (pending.size() < 2 || vertexCount < m_parallelUploadThreshold)
+        return false;
+
+    m_fillBatchesInParallel = true;
+
+    QVector<Batch *> mapped;
+    mapped.reserve(pending.size());
+    for (int i=0; i<pending.size(); ++i) {
+        if (prepareBatchUpload(pending.at(i)))
+            mapped << pending.at(i);
+    }
+
+    BatchFiller filler(this, mapped);
+    QThreadPool *pool = qquick_workerPool();
+    const int maxWorkers = qMin(pool->maxThreadCount(), mapped.size() - 1);
+    QSemaphore done;
+    int workers = 0;
+    while (workers < maxWorkers) {
+        BatchFillerTask *task = new BatchFillerTask(&filler, &done);
+        if (!pool->tryStart(task)) {
+            delete task;
+            break;
+        }
+        ++workers;
+    }
+    filler.fill();
+    done.acquire(workers);
+
+    for (int i=0; i<mapped.size(); ++i)
+        finishBatchUpload(mapped.at(i));
+
+    m_fillBatchesInParallel = false;
+    // Like the upload pools, only shrink when far larger than needed
+    if (m_parallelUploadPool.size() > m_parallelUploadPoolUsed * 2)
+        m_parallelUploadPool.resize(m_parallelUploadPoolUsed);
+    m_parallelUploadPoolUsed = 0;
+    m_parallelUploadPoolUsed = 0;
+
+    if (Q_UNLIKELY(debug_upload()))
+        qDebug() << "Filled" << mapped.size() << "batches," << vertexCount << "vertices, using" << (workers + 1) << "threads";
+
+    return true;
+}
+
 /*!
  * Convenience function to set up the stencil buffer for clipping based on \a clip.
  *
@@ -2226,7 +2952,7 @@ void Renderer::renderMergedBatch(const Batch *batch)
     // updateClip() uses m_current_projection_matrix.
     updateClip(gn->clipList(), batch);
 
-    glBindBuffer(GL_ARRAY_BUFFER, batch->vbo.id);
+    glBindBuffer(GL_ARRAY_BUFFER, batch->vbo.bufferId());
 
     char *indexBase = 0;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
@@ -2238,7 +2964,8 @@ void Renderer::renderMergedBatch(const Batch *batch)
         indexBase = indexBuf->data;
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     } else {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf->id);
+        indexBase = (char *) (qintptr) indexBuf->offset;
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf->bufferId());
     }
 
 
@@ -2285,16 +3012,119 @@ void Renderer::renderMergedBatch(const Batch *batch)
                 continue;
             const QSGGeometry::Attribute &a = g->attributes()[j];
             GLboolean normalize = a.type != GL_FLOAT && a.type != GL_DOUBLE;
-            glVertexAttribPointer(a.position, a.tupleSize, a.type, normalize, g->sizeOfVertex(), (void *) (qintptr) (offset + draw.vertices));
+            glVertexAttribPointer(a.position, a.tupleSize, a.type, normalize, g->sizeOfVertex(), (void *) (qintptr) (offset + draw.vertices + batch->vbo.offset));
             offset += a.tupleSize * size_of_type(a.type);
         }
         if (m_useDepthBuffer)
-            glVertexAttribPointer(sms->pos_order, 1, GL_FLOAT, false, 0, (void *) (qintptr) (draw.zorders));
+            glVertexAttribPointer(sms->pos_order, 1, GL_FLOAT, false, 0, (void *) (qintptr) (draw.zorders + batch->vbo.offset));
 
         glDrawElements(g->drawingMode(), draw.indexCount, GL_UNSIGNED_SHORT, (void *) (qintptr) (indexBase + draw.indices));
     }
 }
 
+/* Draws a batch whose elements all share the same geometry. The geometry is
+ * stored once, followed by an x, y offset and z order per element, which are
+ * fed to the rewritten vertex shader as instanced attributes.
+ */
+void Renderer::renderInstancedBatch(const Batch *batch)
+{
+    if (batch->vertexCount == 0 || batch->instanceCount == 0)
+        return;
+
+    Element *e = batch->first;
+    Q_ASSERT(e);
+
+    if (Q_UNLIKELY(debug_render())) {
+        qDebug() << " -"
+                 << batch
+                 << (batch->uploadedThisFrame ? "[  upload]" : "[retained]")
+                 << (e->node->clipList() ? "[  clip]" : "[noclip]")
+                 << (batch->isOpaque ? "[opaque]" : "[ alpha]")
+                 << "[instanced]"
+                 << " Nodes:" << QString::fromLatin1("%1").arg(batch->instanceCount, 4).toLatin1().constData()
+                 << " Vertices:" << QString::fromLatin1("%1").arg(batch->vertexCount, 5).toLatin1().constData()
+                 << " Indices:" << QString::fromLatin1("%1").arg(batch->indexCount, 5).toLatin1().constData()
+                 << " root:" << batch->root;
+        batch->uploadedThisFrame = false;
+    }
+
+    QSGGeometryNode *gn = e->node;
+
+    QSGMaterialShader::RenderState::DirtyStates dirty = QSGMaterialShader::RenderState::DirtyMatrix;
+    if (batch->root)
+        m_current_model_view_matrix = qsg_matrixForRoot(batch->root);
+    else
+        m_current_model_view_matrix.setToIdentity();
+    m_current_determinant = m_current_model_view_matrix.determinant();
+    m_current_projection_matrix = projectionMatrix();
+
+    updateClip(gn->clipList(), batch);
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch->vbo.bufferId());
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    const Buffer *indexBuf = &batch->ibo;
+#else
+    const Buffer *indexBuf = &batch->vbo;
+#endif
+    if (batch->indexCount)
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf->bufferId());
+
+    QSGMaterial *material = gn->activeMaterial();
+    ShaderManager::Shader *sms = m_shaderManager->prepareMaterialInstanced(material);
+    if (!sms)
+        return;
+    QSGMaterialShader *program = sms->program;
+
+    if (m_currentShader != sms)
+        setActiveShader(program, sms);
+
+    m_current_opacity = gn->inheritedOpacity();
+    if (sms->lastOpacity != m_current_opacity) {
+        dirty |= QSGMaterialShader::RenderState::DirtyOpacity;
+        sms->lastOpacity = m_current_opacity;
+    }
+
+    program->updateState(state(dirty), material, m_currentMaterial);
+    program->program()->setUniformValue(sms->id_instanceMatrix, m_current_projection_matrix * m_current_model_view_matrix);
+
+    m_currentMaterial = material;
+
+    const DrawSet &draw = batch->drawSets.at(0);
+    QSGGeometry *g = gn->geometry();
+    updateLineWidth(g);
+    char const *const *attrNames = program->attributeNames();
+    int offset = 0;
+    for (int j = 0; attrNames[j]; ++j) {
+        if (!*attrNames[j])
+            continue;
+        const QSGGeometry::Attribute &a = g->attributes()[j];
+        GLboolean normalize = a.type != GL_FLOAT && a.type != GL_DOUBLE;
+        glVertexAttribPointer(a.position, a.tupleSize, a.type, normalize, g->sizeOfVertex(), (void *) (qintptr) (offset + draw.vertices + batch->vbo.offset));
+        offset += a.tupleSize * size_of_type(a.type);
+    }
+
+    const qintptr instanceData = draw.zorders + batch->vbo.offset;
+    glEnableVertexAttribArray(sms->pos_instanceOffset);
+    glVertexAttribPointer(sms->pos_instanceOffset, 2, GL_FLOAT, false, qsg_instance_stride, (void *) instanceData);
+    glVertexAttribPointer(sms->pos_order, 1, GL_FLOAT, false, qsg_instance_stride, (void *) (instanceData + 2 * sizeof(float)));
+    m_instancingFuncs->glVertexAttribDivisor(sms->pos_instanceOffset, 1);
+    m_instancingFuncs->glVertexAttribDivisor(sms->pos_order, 1);
+
+    if (batch->indexCount) {
+        m_instancingFuncs->glDrawElementsInstanced(g->drawingMode(), batch->indexCount, g->indexType(),
+                                                   (void *) (qintptr) (draw.indices + indexBuf->offset),
+                                                   batch->instanceCount);
+    } else {
+        m_instancingFuncs->glDrawArraysInstanced(g->drawingMode(), 0, batch->vertexCount, batch->instanceCount);
+    }
+
+    // The attribute locations are shared with the other shaders, which do
+    // not expect any divisors.
+    m_instancingFuncs->glVertexAttribDivisor(sms->pos_order, 0);
+    m_instancingFuncs->glVertexAttribDivisor(sms->pos_instanceOffset, 0);
+    glDisableVertexAttribArray(sms->pos_instanceOffset);
+}
+
 void Renderer::renderUnmergedBatch(const Batch *batch)
 {
     if (batch->vertexCount == 0)
@@ -2323,7 +3153,7 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
     m_current_projection_matrix = projectionMatrix();
     updateClip(gn->clipList(), batch);
 
-    glBindBuffer(GL_ARRAY_BUFFER, batch->vbo.id);
+    glBindBuffer(GL_ARRAY_BUFFER, batch->vbo.bufferId());
     char *indexBase = 0;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
     const Buffer *indexBuf = &batch->ibo;
@@ -2335,7 +3165,8 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
             indexBase = indexBuf->data;
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         } else {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf->id);
+            indexBase = (char *) (qintptr) indexBuf->offset;
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf->bufferId());
         }
     }
 
@@ -2357,7 +3188,7 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
         sms->lastOpacity = m_current_opacity;
     }
 
-    int vOffset = 0;
+    int vOffset = batch->vbo.offset;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
     char *iOffset = indexBase;
 #else
@@ -2369,6 +3200,14 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
     while (e) {
         gn = e->node;
 
+        if (e->culled) {
+            QSGGeometry *g = gn->geometry();
+            vOffset += g->sizeOfVertex() * g->vertexCount();
+            iOffset += g->indexCount() * g->sizeOfIndex();
+            e = e->nextInBatch;
+            continue;
+        }
+
         m_current_model_view_matrix = rootMatrix * *gn->matrix();
         m_current_determinant = m_current_model_view_matrix.determinant();
 
@@ -2443,6 +3282,198 @@ void Renderer::updateLineWidth(QSGGeometry *g)
 #endif
 }
 
+static const int qsg_max_occluders = 16;
+
+struct Occluder
+{
+    Rect rect;
+    int order;
+};
+
+/* A material without the Blending flag may still discard fragments, e.g. a
+ * ShaderEffect with blending set to false, so only the built-in materials
+ * known to write every covered pixel are trusted.
+ */
+static bool qsg_hasFullCoverageMaterial(QSGMaterial *m)
+{
+    static QSGMaterialType *flatColorType = QSGFlatColorMaterial().type();
+    static QSGMaterialType *opaqueTextureType = QSGOpaqueTextureMaterial().type();
+    static QSGMaterialType *vertexColorType = QSGVertexColorMaterial().type();
+
+    if (m->flags() & (QSGMaterial::Blending | QSGMaterial::CustomCompileStep))
+        return false;
+    QSGMaterialType *type = m->type();
+    return type == flatColorType || type == opaqueTextureType || type == vertexColorType;
+}
+
+/* Only an opaque, unclipped, axis aligned rectangle drawn as the usual four
+ * vertex triangle strip is guaranteed to cover everything inside its bounds.
+ */
+static bool qsg_isOccluder(const Element *e)
+{
+    const QSGGeometryNode *gn = e->node;
+    if (gn->clipList() || gn->inheritedOpacity() <= OPAQUE_LIMIT
+            || !qsg_hasFullCoverageMaterial(gn->activeMaterial())
+            || !QMatrix4x4_Accessor::isScale(*gn->matrix()))
+        return false;
+
+    const QSGGeometry *g = gn->geometry();
+    if (g->drawingMode() != GL_TRIANGLE_STRIP || g->vertexCount() != 4 || g->indexCount() != 0)
+        return false;
+    const int offset = qsg_positionAttribute(const_cast<QSGGeometry *>(g));
+    if (offset < 0)
+        return false;
+    const char *vd = (const char *) g->vertexData() + offset;
+    const int stride = g->sizeOfVertex();
+    const Pt &p0 = *(const Pt *) vd;
+    const Pt &p1 = *(const Pt *) (vd + stride);
+    const Pt &p2 = *(const Pt *) (vd + 2 * stride);
+    const Pt &p3 = *(const Pt *) (vd + 3 * stride);
+    // The layout of QSGGeometry::updateRectGeometry(): tl, bl, tr, br
+    return p0.x == p1.x && p2.x == p3.x && p0.y == p2.y && p1.y == p3.y;
+}
+
+/* Only the built-in materials are known to draw inside the bounds of their
+ * vertices. A custom vertex shader, such as the one of a ShaderEffect, and the
+ * antialiasing materials, which push their vertices outward, may draw outside.
+ */
+static bool qsg_hasBoundedMaterial(QSGMaterial *m)
+{
+    static QSGMaterialType *flatColorType = QSGFlatColorMaterial().type();
+    static QSGMaterialType *opaqueTextureType = QSGOpaqueTextureMaterial().type();
+    static QSGMaterialType *textureType = QSGTextureMaterial().type();
+    static QSGMaterialType *vertexColorType = QSGVertexColorMaterial().type();
+
+    if (m->flags() & QSGMaterial::CustomCompileStep)
+        return false;
+    QSGMaterialType *type = m->type();
+    return type == flatColorType || type == opaqueTextureType || type == textureType
+            || type == vertexColorType;
+}
+
+/* Points and lines are drawn wider than their vertices, so their bounds cannot
+ * be trusted either.
+ */
+static inline bool qsg_isCullable(const Element *e)
+{
+    const QSGGeometry *g = e->node->geometry();
+    const GLenum mode = g->drawingMode();
+    return mode != GL_POINTS && mode != GL_LINES && mode != GL_LINE_STRIP && mode != GL_LINE_LOOP
+            && qsg_hasBoundedMaterial(e->node->activeMaterial())
+            && !e->boundsOutsideFloatRange;
+}
+
+/*
+ * Marks the batches, and the elements of unmerged batches, which do not need
+ * to be drawn this frame because they are outside the viewport or entirely
+ * behind an opaque rectangle which is drawn on top of them. All tests are done
+ * on bounding rectangles in normalized device coordinates.
+ */
+void Renderer::cullBatches()
+{
+    m_culledElements = 0;
+    for (int l=0; l<2; ++l) {
+        const QDataBuffer<Batch *> &batches = l == 0 ? m_opaqueBatches : m_alphaBatches;
+        for (int i=0; i<batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            b->culled = false;
+            for (Element *e = b->first; e; e = e->nextInBatch)
+                e->culled = false;
+        }
+    }
+
+    const QMatrix4x4 &projection = projectionMatrix();
+    if (debug_noculling() || m_visualizeMode != VisualizeNothing || !QMatrix4x4_Accessor::is2DSafe(projection))
+        return;
+
+    // Collect the largest occluders, in device coordinates.
+    QVarLengthArray<Occluder, qsg_max_occluders> occluders;
+    for (int l=0; l<2; ++l) {
+        const QDataBuffer<Batch *> &batches = l == 0 ? m_opaqueBatches : m_alphaBatches;
+        for (int i=0; i<batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            if (b->isRenderNode || !b->first)
+                continue;
+            QMatrix4x4 m = b->root ? projection * qsg_matrixForRoot(b->root) : projection;
+            if (!QMatrix4x4_Accessor::isScale(m))
+                continue;
+            for (Element *e = b->first; e; e = e->nextInBatch) {
+                if (e->removed || !qsg_isOccluder(e))
+                    continue;
+                e->ensureBoundsValid();
+                if (e->boundsOutsideFloatRange)
+                    continue;
+                Occluder o = { e->bounds, e->order };
+                o.rect.map(m);
+                const float area = (o.rect.br.x - o.rect.tl.x) * (o.rect.br.y - o.rect.tl.y);
+                if (occluders.size() < qsg_max_occluders) {
+                    occluders.append(o);
+                } else {
+                    int smallest = 0;
+                    float smallestArea = FLT_MAX;
+                    for (int j=0; j<occluders.size(); ++j) {
+                        const Rect &r = occluders.at(j).rect;
+                        const float a = (r.br.x - r.tl.x) * (r.br.y - r.tl.y);
+                        if (a < smallestArea) {
+                            smallestArea = a;
+                            smallest = j;
+                        }
+                    }
+                    if (area > smallestArea)
+                        occluders[smallest] = o;
+                }
+            }
+        }
+    }
+
+    for (int l=0; l<2; ++l) {
+        const QDataBuffer<Batch *> &batches = l == 0 ? m_opaqueBatches : m_alphaBatches;
+        for (int i=0; i<batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            if (b->isRenderNode || !b->first)
+                continue;
+            QMatrix4x4 m = b->root ? projection * qsg_matrixForRoot(b->root) : projection;
+            if (!QMatrix4x4_Accessor::is2DSafe(m))
+                continue;
+
+            bool allCulled = true;
+            int culled = 0;
+            for (Element *e = b->first; e; e = e->nextInBatch) {
+                if (e->removed) {
+                    continue;
+                }
+                e->ensureBoundsValid();
+                if (!qsg_isCullable(e)) {
+                    allCulled = false;
+                    continue;
+                }
+                Rect r = e->bounds;
+                r.map(m);
+                bool hidden = r.br.x < -1 || r.tl.x > 1 || r.br.y < -1 || r.tl.y > 1;
+                for (int j=0; !hidden && j<occluders.size(); ++j) {
+                    const Occluder &o = occluders.at(j);
+                    hidden = o.order > e->order && o.rect.contains(r);
+                }
+                if (hidden) {
+                    e->culled = true;
+                    ++culled;
+                } else {
+                    allCulled = false;
+                }
+            }
+
+            // Merged batches are drawn with a single call, so they are either
+            // skipped as a whole or drawn as a whole.
+            b->culled = allCulled;
+            if (allCulled || !b->merged)
+                m_culledElements += culled;
+        }
+    }
+
+    if (Q_UNLIKELY(debug_render()))
+        qDebug() << " -> culled" << m_culledElements << "elements using" << occluders.size() << "occluders";
+}
+
 void Renderer::renderBatches()
 {
     if (Q_UNLIKELY(debug_render())) {
@@ -2484,7 +3515,11 @@ void Renderer::renderBatches()
     if (Q_LIKELY(renderOpaque)) {
         for (int i=0; i<m_opaqueBatches.size(); ++i) {
             Batch *b = m_opaqueBatches.at(i);
-            if (b->merged)
+            if (b->culled)
+                continue;
+            if (b->instanced)
+                renderInstancedBatch(b);
+            else if (b->merged)
                 renderMergedBatch(b);
             else
                 renderUnmergedBatch(b);
@@ -2499,7 +3534,11 @@ void Renderer::renderBatches()
     if (Q_LIKELY(renderAlpha)) {
         for (int i=0; i<m_alphaBatches.size(); ++i) {
             Batch *b = m_alphaBatches.at(i);
-            if (b->merged)
+            if (b->culled)
+                continue;
+            if (b->instanced)
+                renderInstancedBatch(b);
+            else if (b->merged)
                 renderMergedBatch(b);
             else if (b->isRenderNode)
                 renderRenderNode(b);
@@ -2557,6 +3596,10 @@ void Renderer::render()
     quint64 timeUploadOpaque = 0;
     quint64 timeUploadAlpha = 0;
 
+    const bool profileFrame = debug_render() || QSG_LOG_TIME_RENDERER().isDebugEnabled();
+    if (Q_UNLIKELY(profileFrame))
+        timer.start();
+
     if (Q_UNLIKELY(debug_render() || debug_build())) {
         QByteArray type("rebuild:");
         if (m_rebuild == 0)
@@ -2579,6 +3622,10 @@ void Renderer::render()
     if (m_vao)
         m_vao->bind();
 
+    m_uploadedBytes = 0;
+    if (m_changedAlphaElements.size())
+        checkChangedAlphaElements();
+
     if (m_rebuild & (BuildRenderLists | BuildRenderListsForTaggedRoots)) {
         bool complete = (m_rebuild & BuildRenderLists) != 0;
         if (complete)
@@ -2600,7 +3647,7 @@ void Renderer::render()
             }
         }
     }
-    if (Q_UNLIKELY(debug_render())) timeRenderLists = timer.restart();
+    if (Q_UNLIKELY(profileFrame)) timeRenderLists = timer.restart();
 
     for (int i=0; i<m_opaqueBatches.size(); ++i)
         m_opaqueBatches.at(i)->cleanupRemovedElements();
@@ -2613,9 +3660,9 @@ void Renderer::render()
 
     if (m_rebuild & BuildBatches) {
         prepareOpaqueBatches();
-        if (Q_UNLIKELY(debug_render())) timePrepareOpaque = timer.restart();
+        if (Q_UNLIKELY(profileFrame)) timePrepareOpaque = timer.restart();
         prepareAlphaBatches();
-        if (Q_UNLIKELY(debug_render())) timePrepareAlpha = timer.restart();
+        if (Q_UNLIKELY(profileFrame)) timePrepareAlpha = timer.restart();
 
         if (Q_UNLIKELY(debug_build())) {
             qDebug() << "Opaque Batches:";
@@ -2636,7 +3683,7 @@ void Renderer::render()
             }
         }
     } else {
-        if (Q_UNLIKELY(debug_render())) timePrepareOpaque = timePrepareAlpha = timer.restart();
+        if (Q_UNLIKELY(profileFrame)) timePrepareOpaque = timePrepareAlpha = timer.restart();
     }
 
 
@@ -2657,13 +3704,19 @@ void Renderer::render()
                  : 0;
     }
 
-    if (Q_UNLIKELY(debug_render())) timeSorting = timer.restart();
+    if (Q_UNLIKELY(profileFrame)) timeSorting = timer.restart();
 
     int largestVBO = 0;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
     int largestIBO = 0;
 #endif
 
+    ++m_frame;
+    if (m_ringBuffer)
+        beginRingFrame();
+
+    bool uploadedInParallel = uploadBatchesInParallel();
+
     if (Q_UNLIKELY(debug_upload())) qDebug() << "Uploading Opaque Batches:";
     for (int i=0; i<m_opaqueBatches.size(); ++i) {
         Batch *b = m_opaqueBatches.at(i);
@@ -2673,7 +3726,7 @@ void Renderer::render()
 #endif
         uploadBatch(b);
     }
-    if (Q_UNLIKELY(debug_render())) timeUploadOpaque = timer.restart();
+    if (Q_UNLIKELY(profileFrame)) timeUploadOpaque = timer.restart();
 
 
     if (Q_UNLIKELY(debug_upload())) qDebug() << "Uploading Alpha Batches:";
@@ -2685,7 +3738,7 @@ void Renderer::render()
         largestIBO = qMax(b->ibo.size, largestIBO);
 #endif
     }
-    if (Q_UNLIKELY(debug_render())) timeUploadAlpha = timer.restart();
+    if (Q_UNLIKELY(profileFrame)) timeUploadAlpha = timer.restart();
 
     if (largestVBO * 2 < m_vertexUploadPool.size())
         m_vertexUploadPool.resize(largestVBO * 2);
@@ -2694,15 +3747,31 @@ void Renderer::render()
         m_indexUploadPool.resize(largestIBO * 2);
 #endif
 
+    cullBatches();
     renderBatches();
 
+    if (m_ringBuffer)
+        endRingFrame();
+
     if (Q_UNLIKELY(debug_render())) {
-        qDebug(" -> times: build: %d, prepare(opaque/alpha): %d/%d, sorting: %d, upload(opaque/alpha): %d/%d, render: %d",
+        qDebug(" -> times: build: %d, prepare(opaque/alpha): %d/%d, sorting: %d, upload(opaque/alpha): %d/%d%s, render: %d, uploaded: %d bytes, culled: %d elements",
                (int) timeRenderLists,
                (int) timePrepareOpaque, (int) timePrepareAlpha,
                (int) timeSorting,
                (int) timeUploadOpaque, (int) timeUploadAlpha,
-               (int) timer.elapsed());
+               uploadedInParallel ? " (parallel)" : "",
+               (int) timer.elapsed(),
+               m_uploadedBytes, m_culledElements);
+    } else if (Q_UNLIKELY(profileFrame)) {
+        qCDebug(QSG_LOG_TIME_RENDERER,
+                "batch renderer: build=%d, prepare=%d, sort=%d, upload=%d%s, render=%d, uploaded=%d bytes, culled=%d elements",
+                (int) timeRenderLists,
+                (int) (timePrepareOpaque + timePrepareAlpha),
+                (int) timeSorting,
+                (int) (timeUploadOpaque + timeUploadAlpha),
+                uploadedInParallel ? " (parallel)" : "",
+                (int) timer.elapsed(),
+                m_uploadedBytes, m_culledElements);
     }
 
     m_rebuild = 0;
@@ -53,6 +53,8 @@
 
 #include <QtCore/QBitArray>
 
+#include <QtGui/QOpenGLExtraFunctions>
+
 QT_BEGIN_NAMESPACE
 
 class QOpenGLVertexArrayObject;
@@ -69,6 +71,7 @@ struct Chunk;
 struct Batch;
 struct Node;
 class Updater;
+class BatchFiller;
 class Renderer;
 class ShaderManager;
 
@@ -261,6 +264,10 @@ struct Rect {
         br.set(right, bottom);
     }
 
+    bool contains(const Rect &r) const {
+        return r.tl.x >= tl.x && r.tl.y >= tl.y && r.br.x <= br.x && r.br.y <= br.y;
+    }
+
     bool intersects(const Rect &r) {
         bool xOverlap = r.tl.x < br.x && r.br.x > tl.x;
         bool yOverlap = r.tl.y < br.y && r.br.y > tl.y;
@@ -286,6 +293,12 @@ struct Buffer {
     // Data is only valid while preparing the upload. Exception is if we are using the
     // broken IBO workaround or we are using a visualization mode.
     char *data;
+    // When the contents were streamed into the renderer's ring buffer, this is
+    // the ring's id and offset is where the contents start inside of it.
+    GLuint ringId;
+    int offset;
+
+    GLuint bufferId() const { return ringId ? ringId : id; }
 };
 
 struct Element {
@@ -296,6 +309,11 @@ struct Element {
         , nextInBatch(0)
         , root(0)
         , order(0)
+        , vertexOffset(0)
+        , indexOffset(0)
+        , uploadedVertexCount(0)
+        , uploadedIndexCount(0)
+        , indexBase(0)
         , boundsComputed(false)
         , boundsOutsideFloatRange(false)
         , translateOnlyToRoot(false)
@@ -303,6 +321,8 @@ struct Element {
         , orphaned(false)
         , isRenderNode(false)
         , isMaterialBlended(false)
+        , geometryDirty(false)
+        , culled(false)
     {
     }
 
@@ -326,6 +346,14 @@ struct Element {
 
     int order;
 
+    // Where the element ended up in the last upload of its merged batch, so
+    // that it can be uploaded on its own when only its geometry changes.
+    int vertexOffset;
+    int indexOffset;
+    int uploadedVertexCount;
+    int uploadedIndexCount;
+    quint16 indexBase;
+
     uint boundsComputed : 1;
     uint boundsOutsideFloatRange : 1;
     uint translateOnlyToRoot : 1;
@@ -333,6 +361,8 @@ struct Element {
     uint orphaned : 1;
     uint isRenderNode : 1;
     uint isMaterialBlended : 1;
+    uint geometryDirty : 1;
+    uint culled : 1; // not drawn this frame, only used in unmerged batches
 };
 
 struct RenderNodeElement : public Element {
@@ -405,6 +435,12 @@ struct Batch
         positionAttribute = -1;
         uploadedThisFrame = false;
         isRenderNode = false;
+        streamed = false;
+        dirtyElementsOnly = false;
+        culled = false;
+        instanced = false;
+        instanceCount = 0;
+        lastUploadFrame = 0;
     }
 
     Element *first;
@@ -414,13 +450,20 @@ struct Batch
 
     int vertexCount;
     int indexCount;
+    int instanceCount;
 
     int lastOrderInBatch;
 
+    uint lastUploadFrame;
+
     uint isOpaque : 1;
     uint needsUpload : 1;
     uint merged : 1;
     uint isRenderNode : 1;
+    uint streamed : 1; // upload goes into the ring buffer this frame
+    uint dirtyElementsOnly : 1; // only elements with geometryDirty need to be uploaded
+    uint culled : 1; // nothing in the batch is visible this frame
+    uint instanced : 1; // all elements share one geometry, see renderInstancedBatch()
 
     mutable uint uploadedThisFrame : 1; // solely for debugging purposes
 
@@ -516,6 +559,8 @@ public:
         ~Shader() { delete program; }
         int id_zRange;
         int pos_order;
+        int id_instanceMatrix;
+        int pos_instanceOffset;
         QSGMaterialShader *program;
 
         float lastOpacity;
@@ -525,6 +570,7 @@ public:
     ~ShaderManager() {
         qDeleteAll(rewrittenShaders);
         qDeleteAll(stockShaders);
+        qDeleteAll(instancedShaders);
     }
 
 public Q_SLOTS:
@@ -533,12 +579,14 @@ public Q_SLOTS:
 public:
     Shader *prepareMaterial(QSGMaterial *material);
     Shader *prepareMaterialNoRewrite(QSGMaterial *material);
+    Shader *prepareMaterialInstanced(QSGMaterial *material);
 
     QOpenGLShaderProgram *visualizeProgram;
 
 private:
     QHash<QSGMaterialType *, Shader *> rewrittenShaders;
     QHash<QSGMaterialType *, Shader *> stockShaders;
+    QHash<QSGMaterialType *, Shader *> instancedShaders;
 
     QOpenGLShaderProgram *blitProgram;
     QSGRenderContext *context;
@@ -579,9 +627,17 @@ private:
     };
 
     friend class Updater;
+    friend class BatchFiller;
 
     void map(Buffer *buffer, int size, bool isIndexBuf = false);
-    void unmap(Buffer *buffer, bool isIndexBuf = false);
+    void unmap(Buffer *buffer, bool isIndexBuf = false, bool stream = false);
+
+    enum { RingSegments = 3 };
+    void createRingBuffer(int segmentSize);
+    void destroyRingBuffer();
+    void beginRingFrame();
+    void endRingFrame();
+    bool streamBuffer(Buffer *buffer);
 
     void buildRenderListsFromScratch();
     void buildRenderListsForTaggedRoots();
@@ -596,10 +652,18 @@ private:
     void invalidateBatchAndOverlappingRenderOrders(Batch *batch);
 
     void uploadBatch(Batch *b);
+    bool prepareBatchUpload(Batch *b);
+    void fillBatch(Batch *b);
+    void finishBatchUpload(Batch *b);
+    bool uploadBatchesInParallel();
+    bool uploadDirtyElements(Batch *b);
+    void checkChangedAlphaElements();
     void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint16 *iBase, int *indexCount);
 
+    void cullBatches();
     void renderBatches();
     void renderMergedBatch(const Batch *batch);
+    void renderInstancedBatch(const Batch *batch);
     void renderUnmergedBatch(const Batch *batch);
     ClipType updateStencilClip(const QSGClipNode *clip);
     void updateClip(const QSGClipNode *clipList, const Batch *batch);
@@ -649,6 +713,7 @@ private:
     QDataBuffer<Element *> m_elementsToDelete;
     QDataBuffer<Element *> m_tmpAlphaElements;
     QDataBuffer<Element *> m_tmpOpaqueElements;
+    QDataBuffer<Element *> m_changedAlphaElements;
 
     uint m_rebuild;
     qreal m_zRange;
@@ -658,6 +723,30 @@ private:
     GLuint m_bufferStrategy;
     int m_batchNodeThreshold;
     int m_batchVertexThreshold;
+    int m_parallelUploadThreshold;
+    bool m_partialUploads;
+    bool m_fillBatchesInParallel;
+    // Upload memory of the batches filled in parallel, one buffer per mapped
+    // Buffer, kept from frame to frame.
+    QVector<QByteArray> m_parallelUploadPool;
+    int m_parallelUploadPoolUsed;
+
+    // Ring buffer for batches that are uploaded every frame. It is split in
+    // RingSegments parts which are used round-robin, one per frame, and
+    // fenced so that a part is only rewritten once the GPU is done with it.
+    GLuint m_ringBuffer;
+    int m_ringSegmentSize;
+    int m_ringSegment;
+    int m_ringHead;
+    char *m_ringMemory; // persistently mapped ring, or 0
+    GLsync m_ringFences[RingSegments];
+    QOpenGLExtraFunctions *m_ringFuncs;
+    uint m_frame;
+    int m_uploadedBytes;
+    int m_culledElements;
+
+    int m_instancingThreshold; // 0 when instanced drawing is not available
+    QOpenGLExtraFunctions *m_instancingFuncs;
 
     // Stuff used during rendering only...
     ShaderManager *m_shaderManager;
@@ -34,6 +34,7 @@
 #include "qsgmaterial.h"
 #include "qsgrenderer_p.h"
 #include "qsgmaterialshader_p.h"
+#include <private/qsgshaderdiskcache_p.h>
 #include <private/qsgshadersourcebuilder_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -350,9 +351,6 @@ void QSGMaterialShader::compile()
 {
     Q_ASSERT_X(!m_program.isLinked(), "QSGSMaterialShader::compile()", "Compile called multiple times!");
 
-    program()->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader());
-    program()->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShader());
-
     char const *const *attr = attributeNames();
 #ifndef QT_NO_DEBUG
     int maxVertexAttribs = 0;
@@ -376,7 +374,8 @@ void QSGMaterialShader::compile()
     }
 #endif
 
-    if (!program()->link()) {
+    QSGShaderDiskCache cache(QOpenGLContext::currentContext());
+    if (!cache.link(program(), vertexShader(), fragmentShader(), attr)) {
         qWarning("QSGMaterialShader: Shader compilation failed:");
         qWarning() << program()->log();
     }
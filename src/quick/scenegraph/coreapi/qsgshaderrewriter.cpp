@@ -164,7 +164,7 @@ Tokenizer::Token Tokenizer::next()
 
 using namespace QSGShaderRewriter;
 
-QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile)
+static QByteArray qsgShaderRewriter_rewrite(const char *input, QSurfaceFormat::OpenGLContextProfile profile, bool instanced)
 {
     Tokenizer tok;
     tok.initialize(input);
@@ -192,11 +192,19 @@ QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat
     case QSurfaceFormat::CompatibilityProfile:
         result += QByteArrayLiteral("attribute highp float _qt_order;\n");
         result += QByteArrayLiteral("uniform highp float _qt_zRange;\n");
+        if (instanced) {
+            result += QByteArrayLiteral("attribute highp vec2 _qt_instanceOffset;\n");
+            result += QByteArrayLiteral("uniform highp mat4 _qt_instanceMatrix;\n");
+        }
         break;
 
     case QSurfaceFormat::CoreProfile:
         result += QByteArrayLiteral("in float _qt_order;\n");
         result += QByteArrayLiteral("uniform float _qt_zRange;\n");
+        if (instanced) {
+            result += QByteArrayLiteral("in vec2 _qt_instanceOffset;\n");
+            result += QByteArrayLiteral("uniform mat4 _qt_instanceMatrix;\n");
+        }
         break;
     }
 
@@ -212,6 +220,11 @@ QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat
             braceDepth--;
             if (braceDepth == 0) {
                 result += QByteArray::fromRawData(voidPos, tok.pos - 1 - voidPos);
+                // Translating the instance is the same as adding the transformed
+                // offset only when gl_Position is linear in the vertex position,
+                // so the renderer only instances materials known to be.
+                if (instanced)
+                    result += QByteArrayLiteral("    gl_Position += _qt_instanceMatrix * vec4(_qt_instanceOffset, 0.0, 0.0);\n");
                 result += QByteArrayLiteral("    gl_Position.z = (gl_Position.z * _qt_zRange + _qt_order) * gl_Position.w;\n");
                 result += QByteArray(tok.pos - 1);
                 return result;
@@ -228,6 +241,16 @@ QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat
     return QByteArray();
 }
 
+QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile)
+{
+    return qsgShaderRewriter_rewrite(input, profile, false);
+}
+
+QByteArray qsgShaderRewriter_insertInstanceAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile)
+{
+    return qsgShaderRewriter_rewrite(input, profile, true);
+}
+
 #ifdef QSGSHADERREWRITER_STANDALONE
 
 const char *selftest =
@@ -42,12 +42,92 @@
 #include <qdir.h>
 
 #include <private/qquickprofiler_p.h>
+#include <private/qquickworkerpool_p.h>
 #include <QElapsedTimer>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
 
 QT_BEGIN_NAMESPACE
 
 static QElapsedTimer qsg_render_timer;
 
+// Below this many glyphs the distance fields are generated on the calling thread only.
+static const int qsg_distancefield_parallel_threshold = 8;
+
+class QSGDistanceFieldGenerator
+{
+public:
+    QSGDistanceFieldGenerator(const QVector<QPainterPath> &paths, const QVector<glyph_t> &glyphs,
+                              QVector<QDistanceField> *fields, bool doubleGlyphResolution)
+        : m_paths(paths), m_glyphs(glyphs), m_fields(fields->data())
+        , m_doubleGlyphResolution(doubleGlyphResolution), m_next(0)
+    { }
+
+    // Claims glyphs one at a time so that the render thread and the workers
+    // share the load regardless of how complex the individual glyphs are.
+    void generate()
+    {
+        const int count = m_glyphs.size();
+        int i;
+        while ((i = m_next.fetchAndAddRelaxed(1)) < count)
+            m_fields[i] = QDistanceField(m_paths.at(i), m_glyphs.at(i), m_doubleGlyphResolution);
+    }
+
+private:
+    const QVector<QPainterPath> &m_paths;
+    const QVector<glyph_t> &m_glyphs;
+    QDistanceField *m_fields;
+    bool m_doubleGlyphResolution;
+    QAtomicInt m_next;
+};
+
+class QSGDistanceFieldGeneratorTask : public QRunnable
+{
+public:
+    QSGDistanceFieldGeneratorTask(QSGDistanceFieldGenerator *generator, QSemaphore *done)
+        : m_generator(generator), m_done(done)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_generator->generate();
+        m_done->release();
+    }
+
+private:
+    QSGDistanceFieldGenerator *m_generator;
+    QSemaphore *m_done;
+};
+
+// Generates the distance fields for \a glyphs, spreading the work over the idle
+// threads of the worker pool.
+static void qsg_generateDistanceFields(const QVector<QPainterPath> &paths, const QVector<glyph_t> &glyphs,
+                                      QVector<QDistanceField> *fields, bool doubleGlyphResolution)
+{
+    QSGDistanceFieldGenerator generator(paths, glyphs, fields, doubleGlyphResolution);
+
+    // Only use threads that are free right now; never wait for a busy pool.
+    int workers = 0;
+    if (glyphs.size() >= qsg_distancefield_parallel_threshold) {
+        QThreadPool *pool = qquick_workerPool();
+        const int maxWorkers = qMin(pool->maxThreadCount(), glyphs.size() / qsg_distancefield_parallel_threshold);
+        QSemaphore done;
+        while (workers < maxWorkers) {
+            QSGDistanceFieldGeneratorTask *task = new QSGDistanceFieldGeneratorTask(&generator, &done);
+            if (!pool->tryStart(task)) {
+                delete task;
+                break;
+            }
+            ++workers;
+        }
+        generator.generate();
+        done.acquire(workers);
+    } else {
+        generator.generate();
+    }
+}
+
 QSGDistanceFieldGlyphCache::Texture QSGDistanceFieldGlyphCache::s_emptyTexture;
 
 QSGDistanceFieldGlyphCache::QSGDistanceFieldGlyphCache(QSGDistanceFieldGlyphCacheManager *man, QOpenGLContext *c, const QRawFont &font)
@@ -74,35 +154,29 @@ QSGDistanceFieldGlyphCache::~QSGDistanceFieldGlyphCache()
 {
 }
 
-QSGDistanceFieldGlyphCache::GlyphData &QSGDistanceFieldGlyphCache::glyphData(glyph_t glyph)
+QSGDistanceFieldGlyphCache::GlyphData &QSGDistanceFieldGlyphCache::createGlyphData(glyph_t glyph)
 {
-    QHash<glyph_t, GlyphData>::iterator data = m_glyphsData.find(glyph);
-    if (data == m_glyphsData.end()) {
-        GlyphData gd;
-        gd.texture = &s_emptyTexture;
-        gd.path = m_referenceFont.pathForGlyph(glyph);
-        // need bounding rect in base font size scale
-        qreal scaleFactor = qreal(1) / QT_DISTANCEFIELD_SCALE(m_doubleGlyphResolution);
-        QTransform scaleDown;
-        scaleDown.scale(scaleFactor, scaleFactor);
-        gd.boundingRect = scaleDown.mapRect(gd.path.boundingRect());
-        data = m_glyphsData.insert(glyph, gd);
+    // Glyphs the font doesn't have are never populated, they all share one blank entry.
+    if (glyph >= glyph_t(m_glyphCount)) {
+        m_missingGlyphData = GlyphData();
+        m_missingGlyphData.texture = &s_emptyTexture;
+        return m_missingGlyphData;
     }
-    return data.value();
-}
-
-QSGDistanceFieldGlyphCache::Metrics QSGDistanceFieldGlyphCache::glyphMetrics(glyph_t glyph, qreal pixelSize)
-{
-    GlyphData &gd = glyphData(glyph);
-    qreal scale = fontScale(pixelSize);
 
-    Metrics m;
-    m.width = gd.boundingRect.width() * scale;
-    m.height = gd.boundingRect.height() * scale;
-    m.baselineX = gd.boundingRect.x() * scale;
-    m.baselineY = -gd.boundingRect.y() * scale;
-
-    return m;
+    if (glyph >= glyph_t(m_glyphsDataIndex.size()))
+        m_glyphsDataIndex.resize(glyph + 1);
+
+    GlyphData gd;
+    gd.texture = &s_emptyTexture;
+    gd.path = m_referenceFont.pathForGlyph(glyph);
+    // need bounding rect in base font size scale
+    qreal scaleFactor = qreal(1) / QT_DISTANCEFIELD_SCALE(m_doubleGlyphResolution);
+    QTransform scaleDown;
+    scaleDown.scale(scaleFactor, scaleFactor);
+    gd.boundingRect = scaleDown.mapRect(gd.path.boundingRect());
+    m_glyphsData.append(gd);
+    m_glyphsDataIndex[glyph] = m_glyphsData.size();
+    return m_glyphsData.last();
 }
 
 void QSGDistanceFieldGlyphCache::populate(const QVector<glyph_t> &glyphs)
@@ -164,17 +238,25 @@ void QSGDistanceFieldGlyphCache::update()
         qsg_render_timer.start();
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphAdaptationLayerFrame);
 
-    QList<QDistanceField> distanceFields;
     const int pendingGlyphsSize = m_pendingGlyphs.size();
-    distanceFields.reserve(pendingGlyphsSize);
+    QVector<glyph_t> glyphs(pendingGlyphsSize);
+    QVector<QPainterPath> paths(pendingGlyphsSize);
     for (int i = 0; i < pendingGlyphsSize; ++i) {
-        GlyphData &gd = glyphData(m_pendingGlyphs.at(i));
-        distanceFields.append(QDistanceField(gd.path,
-                                             m_pendingGlyphs.at(i),
-                                             m_doubleGlyphResolution));
+        glyphs[i] = m_pendingGlyphs.at(i);
+        GlyphData &gd = glyphData(glyphs.at(i));
+        paths[i] = gd.path;
         gd.path = QPainterPath(); // no longer needed, so release memory used by the painter path
     }
 
+    QVector<QDistanceField> fields(pendingGlyphsSize);
+    qsg_generateDistanceFields(paths, glyphs, &fields, m_doubleGlyphResolution);
+    paths.clear();
+
+    QList<QDistanceField> distanceFields;
+    distanceFields.reserve(pendingGlyphsSize);
+    for (int i = 0; i < pendingGlyphsSize; ++i)
+        distanceFields.append(fields.at(i));
+
     qint64 renderTime = 0;
     int count = m_pendingGlyphs.size();
     if (profileFrames)
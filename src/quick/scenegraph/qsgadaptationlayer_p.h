@@ -311,7 +311,7 @@ public:
     int glyphCount() const { return m_glyphCount; }
     bool doubleGlyphResolution() const { return m_doubleGlyphResolution; }
 
-    Metrics glyphMetrics(glyph_t glyph, qreal pixelSize);
+    inline Metrics glyphMetrics(glyph_t glyph, qreal pixelSize);
     inline TexCoord glyphTexCoord(glyph_t glyph);
     inline const Texture *glyphTexture(glyph_t glyph);
 
@@ -358,7 +358,8 @@ protected:
     inline bool containsGlyph(glyph_t glyph);
     GLuint textureIdForGlyph(glyph_t glyph) const;
 
-    GlyphData &glyphData(glyph_t glyph);
+    inline GlyphData &glyphData(glyph_t glyph);
+    GlyphData &createGlyphData(glyph_t glyph);
 
 #if defined(QSG_DISTANCEFIELD_CACHE_DEBUG)
     void saveTexture(GLuint textureId, int width, int height) const;
@@ -376,7 +377,11 @@ private:
     bool m_coreProfile;
 
     QList<Texture> m_textures;
-    QHash<glyph_t, GlyphData> m_glyphsData;
+    // Glyph data is looked up for every glyph of every run when building geometry, so
+    // it is kept in a flat array indexed by glyph (offset by one, zero meaning none yet).
+    QVector<GlyphData> m_glyphsData;
+    QVector<int> m_glyphsDataIndex;
+    GlyphData m_missingGlyphData;
     QDataBuffer<glyph_t> m_pendingGlyphs;
     QSet<glyph_t> m_populatingGlyphs;
     QLinkedList<QSGDistanceFieldGlyphConsumer*> m_registeredNodes;
@@ -384,6 +389,30 @@ private:
     static Texture s_emptyTexture;
 };
 
+inline QSGDistanceFieldGlyphCache::GlyphData &QSGDistanceFieldGlyphCache::glyphData(glyph_t glyph)
+{
+    if (glyph < glyph_t(m_glyphsDataIndex.size())) {
+        const int index = m_glyphsDataIndex.at(glyph);
+        if (index)
+            return m_glyphsData[index - 1];
+    }
+    return createGlyphData(glyph);
+}
+
+inline QSGDistanceFieldGlyphCache::Metrics QSGDistanceFieldGlyphCache::glyphMetrics(glyph_t glyph, qreal pixelSize)
+{
+    const GlyphData &gd = glyphData(glyph);
+    qreal scale = fontScale(pixelSize);
+
+    Metrics m;
+    m.width = gd.boundingRect.width() * scale;
+    m.height = gd.boundingRect.height() * scale;
+    m.baselineX = gd.boundingRect.x() * scale;
+    m.baselineY = -gd.boundingRect.y() * scale;
+
+    return m;
+}
+
 inline QSGDistanceFieldGlyphCache::TexCoord QSGDistanceFieldGlyphCache::glyphTexCoord(glyph_t glyph)
 {
     return glyphData(glyph).texCoord;
@@ -44,6 +44,7 @@
 #include <QtQuick/private/qsgatlastexture_p.h>
 #include <QtQuick/private/qsgrenderloop_p.h>
 #include <QtQuick/private/qsgdefaultlayer_p.h>
+#include <QtQuick/private/qsgshaderdiskcache_p.h>
 
 #include <QtQuick/private/qsgtexture_p.h>
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -108,6 +109,9 @@ Q_LOGGING_CATEGORY(QSG_LOG_TIME_GLYPH,          "qt.scenegraph.time.glyph")
 // Timing inside the renderer base class
 Q_LOGGING_CATEGORY(QSG_LOG_TIME_RENDERER,       "qt.scenegraph.time.renderer")
 
+// Incubation slices spliced between frames by the window's incubation controller
+Q_LOGGING_CATEGORY(QSG_LOG_TIME_INCUBATION,     "qt.scenegraph.time.incubation")
+
 class QSGContextPrivate : public QObjectPrivate
 {
 public:
@@ -554,6 +558,9 @@ void QSGRenderContext::renderNextFrame(QSGRenderer *renderer, GLuint fboId)
 
     renderer->renderScene(fboId);
 
+    if (m_atlasManager)
+        m_atlasManager->endFrame();
+
     if (m_serializedRender)
         qsg_framerender_mutex.unlock();
 
@@ -647,6 +654,8 @@ void QSGRenderContext::invalidate()
 
     qDeleteAll(m_textures);
     m_textures.clear();
+    qDeleteAll(m_asyncTextures);
+    m_asyncTextures.clear();
 
     /* The cleanup of the atlas textures is a bit intriguing.
        As part of the cleanup in the threaded render loop, we
@@ -781,19 +790,70 @@ QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, Q
     if (!texture) {
         texture = factory->createTexture(window);
 
+        // Textures for factories are only used by image nodes, which follow
+        // them when their atlas is repacked, and by texture providers, which
+        // pin them.
+        if (QSGAtlasTexture::Texture *atlasTexture = qobject_cast<QSGAtlasTexture::Texture *>(texture))
+            atlasTexture->setRelocatable(true);
+
         m_mutex.lock();
         m_textures.insert(factory, texture);
         m_mutex.unlock();
 
-        connect(factory, SIGNAL(destroyed(QObject*)), this, SLOT(textureFactoryDestroyed(QObject*)), Qt::DirectConnection);
+        connect(factory, SIGNAL(destroyed(QObject*)), this, SLOT(textureFactoryDestroyed(QObject*)),
+                Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
     }
     return texture;
 }
 
+/*
+    Returns a texture for \a factory that may upload its image on a worker
+    thread and show a placeholder until then. It is only shared with other
+    asynchronous users of the factory, so users of textureForFactory() never
+    see the placeholder. When the factory already has a synchronous texture,
+    or does not create a plain texture, the shared texture is returned.
+ */
+QSGTexture *QSGRenderContext::asynchronousTextureForFactory(QQuickTextureFactory *factory, QQuickWindow *window)
+{
+    if (!factory)
+        return 0;
+
+    m_mutex.lock();
+    QSGTexture *texture = m_asyncTextures.value(factory);
+    if (!texture)
+        texture = m_textures.value(factory);
+    m_mutex.unlock();
+    if (texture)
+        return texture;
+
+    texture = factory->createTexture(window);
+    QSGPlainTexture *plainTexture = qobject_cast<QSGPlainTexture *>(texture);
+    if (plainTexture) {
+        plainTexture->setAsynchronousUpload(true);
+    } else if (QSGAtlasTexture::Texture *atlasTexture = qobject_cast<QSGAtlasTexture::Texture *>(texture)) {
+        atlasTexture->setRelocatable(true);
+    }
+
+    m_mutex.lock();
+    if (plainTexture)
+        m_asyncTextures.insert(factory, texture);
+    else
+        m_textures.insert(factory, texture);
+    m_mutex.unlock();
+
+    connect(factory, SIGNAL(destroyed(QObject*)), this, SLOT(textureFactoryDestroyed(QObject*)),
+            Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+    return texture;
+}
+
 void QSGRenderContext::textureFactoryDestroyed(QObject *o)
 {
+    QQuickTextureFactory *factory = static_cast<QQuickTextureFactory *>(o);
     m_mutex.lock();
-    m_texturesToDelete << m_textures.take(static_cast<QQuickTextureFactory *>(o));
+    if (QSGTexture *texture = m_textures.take(factory))
+        m_texturesToDelete << texture;
+    if (QSGTexture *texture = m_asyncTextures.take(factory))
+        m_texturesToDelete << texture;
     m_mutex.unlock();
 }
 
@@ -816,11 +876,12 @@ void QSGRenderContext::compile(QSGMaterialShader *shader, QSGMaterial *material,
                    "QSGRenderContext::compile()",
                    "materials with custom compile step cannot have custom vertex/fragment code");
         QOpenGLShaderProgram *p = shader->program();
-        p->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode ? vertexCode : shader->vertexShader());
-        p->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentCode ? fragmentCode : shader->fragmentShader());
-        p->link();
-        if (!p->isLinked())
+        QSGShaderDiskCache cache(m_gl);
+        if (!cache.link(p, vertexCode ? vertexCode : shader->vertexShader(),
+                        fragmentCode ? fragmentCode : shader->fragmentShader(),
+                        shader->attributeNames())) {
             qWarning() << "shader compilation failed:" << endl << p->log();
+        }
     } else {
         shader->compile();
     }
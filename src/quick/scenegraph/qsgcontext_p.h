@@ -91,6 +91,7 @@ Q_DECLARE_LOGGING_CATEGORY(QSG_LOG_TIME_COMPILATION)
 Q_DECLARE_LOGGING_CATEGORY(QSG_LOG_TIME_TEXTURE)
 Q_DECLARE_LOGGING_CATEGORY(QSG_LOG_TIME_GLYPH)
 Q_DECLARE_LOGGING_CATEGORY(QSG_LOG_TIME_RENDERER)
+Q_DECLARE_LOGGING_CATEGORY(QSG_LOG_TIME_INCUBATION)
 
 Q_DECLARE_LOGGING_CATEGORY(QSG_LOG_INFO)
 Q_DECLARE_LOGGING_CATEGORY(QSG_LOG_RENDERLOOP)
@@ -123,6 +124,7 @@ public:
 
     virtual QSGDistanceFieldGlyphCache *distanceFieldGlyphCache(const QRawFont &font);
     QSGTexture *textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window);
+    QSGTexture *asynchronousTextureForFactory(QQuickTextureFactory *factory, QQuickWindow *window);
 
     virtual QSGTexture *createTexture(const QImage &image, uint flags = CreateTexture_Alpha) const;
 
@@ -152,6 +154,7 @@ protected:
 
     QMutex m_mutex;
     QHash<QQuickTextureFactory *, QSGTexture *> m_textures;
+    QHash<QQuickTextureFactory *, QSGTexture *> m_asyncTextures;
     QSet<QSGTexture *> m_texturesToDelete;
     QSGAtlasTexture::Manager *m_atlasManager;
 
@@ -50,14 +50,11 @@ QT_BEGIN_NAMESPACE
 DEFINE_BOOL_CONFIG_OPTION(qmlUseGlyphCacheWorkaround, QML_USE_GLYPHCACHE_WORKAROUND)
 DEFINE_BOOL_CONFIG_OPTION(qsgPreferFullSizeGlyphCacheTextures, QSG_PREFER_FULLSIZE_GLYPHCACHE_TEXTURES)
 
-#if !defined(QSG_DEFAULT_DISTANCEFIELD_GLYPH_CACHE_PADDING)
-#  define QSG_DEFAULT_DISTANCEFIELD_GLYPH_CACHE_PADDING 2
-#endif
-
 QSGDefaultDistanceFieldGlyphCache::QSGDefaultDistanceFieldGlyphCache(QSGDistanceFieldGlyphCacheManager *man, QOpenGLContext *c, const QRawFont &font)
     : QSGDistanceFieldGlyphCache(man, c, font)
     , m_maxTextureSize(0)
     , m_maxTextureCount(3)
+    , m_diskCache(0)
     , m_blitProgram(0)
     , m_blitBuffer(QOpenGLBuffer::VertexBuffer)
     , m_fboGuard(0)
@@ -74,6 +71,12 @@ QSGDefaultDistanceFieldGlyphCache::QSGDefaultDistanceFieldGlyphCache(QSGDistance
     m_blitBuffer.release();
 
     m_areaAllocator = new QSGAreaAllocator(QSize(maxTextureSize(), m_maxTextureCount * maxTextureSize()));
+
+    const QString diskCacheDir = QSGDistanceFieldDiskCache::defaultDirectory();
+    if (!diskCacheDir.isEmpty()) {
+        m_diskCache = new QSGDistanceFieldDiskCache(diskCacheDir, font, doubleGlyphResolution(),
+                                                    QSG_DEFAULT_DISTANCEFIELD_GLYPH_CACHE_PADDING);
+    }
 }
 
 QSGDefaultDistanceFieldGlyphCache::~QSGDefaultDistanceFieldGlyphCache()
@@ -86,6 +89,7 @@ QSGDefaultDistanceFieldGlyphCache::~QSGDefaultDistanceFieldGlyphCache()
 
     delete m_blitProgram;
     delete m_areaAllocator;
+    delete m_diskCache;
 }
 
 void QSGDefaultDistanceFieldGlyphCache::requestGlyphs(const QSet<glyph_t> &glyphs)
@@ -142,6 +146,8 @@ void QSGDefaultDistanceFieldGlyphCache::requestGlyphs(const QSet<glyph_t> &glyph
     }
 
     setGlyphsPosition(glyphPositions);
+    if (m_diskCache && !glyphsToRender.isEmpty())
+        glyphsToRender = storeCachedGlyphs(glyphsToRender);
     markGlyphsToRender(glyphsToRender);
 }
 
@@ -151,6 +157,9 @@ void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField>
     typedef GlyphTextureHash::const_iterator GlyphTextureHashConstIt;
 
     GlyphTextureHash glyphTextures;
+    QSGDistanceFieldDiskCache::TileList tilesToStore;
+    if (m_diskCache)
+        tilesToStore.reserve(glyphs.size());
 
     GLint alignment = 4; // default value
     m_funcs->glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
@@ -164,9 +173,6 @@ void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField>
         TexCoord c = glyphTexCoord(glyphIndex);
         TextureInfo *texInfo = m_glyphsTexture.value(glyphIndex);
 
-        resizeTexture(texInfo, texInfo->allocatedArea.width(), texInfo->allocatedArea.height());
-        m_funcs->glBindTexture(GL_TEXTURE_2D, texInfo->texture);
-
         glyphTextures[texInfo].append(glyphIndex);
 
         int padding = texInfo->padding;
@@ -174,39 +180,18 @@ void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField>
         glyph = glyph.copy(-padding, -padding,
                            expectedWidth + padding  * 2, glyph.height() + padding * 2);
 
-        if (useTextureResizeWorkaround()) {
-            uchar *inBits = glyph.scanLine(0);
-            uchar *outBits = texInfo->image.scanLine(int(c.y) - padding) + int(c.x) - padding;
-            for (int y = 0; y < glyph.height(); ++y) {
-                memcpy(outBits, inBits, glyph.width());
-                inBits += glyph.width();
-                outBits += texInfo->image.width();
-            }
-        }
+        uploadTile(texInfo, c.x - padding, c.y - padding, glyph.width(), glyph.height(), glyph.constBits());
 
-#if !defined(QT_OPENGL_ES_2)
-        const GLenum format = isCoreProfile() ? GL_RED : GL_ALPHA;
-#else
-        const GLenum format = GL_ALPHA;
-#endif
-        if (useTextureUploadWorkaround()) {
-            for (int i = 0; i < glyph.height(); ++i) {
-                m_funcs->glTexSubImage2D(GL_TEXTURE_2D, 0,
-                                         c.x - padding, c.y + i - padding, glyph.width(),1,
-                                         format, GL_UNSIGNED_BYTE,
-                                         glyph.scanLine(i));
-            }
-        } else {
-            m_funcs->glTexSubImage2D(GL_TEXTURE_2D, 0,
-                                     c.x - padding, c.y - padding, glyph.width(), glyph.height(),
-                                     format, GL_UNSIGNED_BYTE,
-                                     glyph.constBits());
-        }
+        if (m_diskCache)
+            tilesToStore.append(qMakePair(glyphIndex, glyph));
     }
 
     // restore to previous alignment
     m_funcs->glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
 
+    if (m_diskCache)
+        m_diskCache->storeLater(tilesToStore);
+
     for (GlyphTextureHashConstIt i = glyphTextures.constBegin(), cend = glyphTextures.constEnd(); i != cend; ++i) {
         Texture t;
         t.textureId = i.key()->texture;
@@ -215,6 +200,92 @@ void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField>
     }
 }
 
+/*
+    Uploads the glyphs found in the disk cache straight from the mapped tile
+    files and returns the ones that still need to be rendered.
+ */
+QVector<glyph_t> QSGDefaultDistanceFieldGlyphCache::storeCachedGlyphs(const QVector<glyph_t> &glyphs)
+{
+    typedef QHash<TextureInfo *, QVector<glyph_t> > GlyphTextureHash;
+    typedef GlyphTextureHash::const_iterator GlyphTextureHashConstIt;
+
+    GlyphTextureHash glyphTextures;
+    QVector<glyph_t> missingGlyphs;
+
+    GLint alignment = 4; // default value
+    m_funcs->glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    m_funcs->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (int i = 0; i < glyphs.size(); ++i) {
+        glyph_t glyphIndex = glyphs.at(i);
+        TexCoord c = glyphTexCoord(glyphIndex);
+        TextureInfo *texInfo = m_glyphsTexture.value(glyphIndex);
+
+        int padding = texInfo->padding;
+        int expectedWidth = qCeil(c.width + c.xMargin * 2) + padding * 2;
+        int expectedHeight = QT_DISTANCEFIELD_TILESIZE(doubleGlyphResolution()) + padding * 2;
+
+        QSGDistanceFieldDiskCache::Tile tile;
+        if (!m_diskCache->load(glyphIndex, &tile)
+                || tile.width != expectedWidth || tile.height != expectedHeight) {
+            missingGlyphs.append(glyphIndex);
+            continue;
+        }
+
+        uploadTile(texInfo, c.x - padding, c.y - padding, tile.width, tile.height, tile.bits);
+        glyphTextures[texInfo].append(glyphIndex);
+
+        // no longer needed, so release memory used by the painter path
+        glyphData(glyphIndex).path = QPainterPath();
+    }
+
+    m_funcs->glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    for (GlyphTextureHashConstIt i = glyphTextures.constBegin(), cend = glyphTextures.constEnd(); i != cend; ++i) {
+        Texture t;
+        t.textureId = i.key()->texture;
+        t.size = i.key()->size;
+        setGlyphsTexture(i.value(), t);
+    }
+
+    return missingGlyphs;
+}
+
+void QSGDefaultDistanceFieldGlyphCache::uploadTile(TextureInfo *texInfo, int x, int y, int width, int height, const uchar *bits)
+{
+    resizeTexture(texInfo, texInfo->allocatedArea.width(), texInfo->allocatedArea.height());
+    m_funcs->glBindTexture(GL_TEXTURE_2D, texInfo->texture);
+
+    if (useTextureResizeWorkaround()) {
+        const uchar *inBits = bits;
+        uchar *outBits = texInfo->image.scanLine(y) + x;
+        for (int i = 0; i < height; ++i) {
+            memcpy(outBits, inBits, width);
+            inBits += width;
+            outBits += texInfo->image.width();
+        }
+    }
+
+#if !defined(QT_OPENGL_ES_2)
+    const GLenum format = isCoreProfile() ? GL_RED : GL_ALPHA;
+#else
+    const GLenum format = GL_ALPHA;
+#endif
+    if (useTextureUploadWorkaround()) {
+        for (int i = 0; i < height; ++i) {
+            m_funcs->glTexSubImage2D(GL_TEXTURE_2D, 0,
+                                     x, y + i, width, 1,
+                                     format, GL_UNSIGNED_BYTE,
+                                     bits + i * width);
+        }
+    } else {
+        m_funcs->glTexSubImage2D(GL_TEXTURE_2D, 0,
+                                 x, y, width, height,
+                                 format, GL_UNSIGNED_BYTE,
+                                 bits);
+    }
+}
+
 void QSGDefaultDistanceFieldGlyphCache::referenceGlyphs(const QSet<glyph_t> &glyphs)
 {
     m_unusedGlyphs -= glyphs;
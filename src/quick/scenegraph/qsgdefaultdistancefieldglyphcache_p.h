@@ -52,9 +52,14 @@
 #include <qopenglvertexarrayobject.h>
 #include <QtGui/private/qopenglengineshadersource_p.h>
 #include <private/qsgareaallocator_p.h>
+#include <private/qsgdistancefielddiskcache_p.h>
 
 QT_BEGIN_NAMESPACE
 
+#if !defined(QSG_DEFAULT_DISTANCEFIELD_GLYPH_CACHE_PADDING)
+#  define QSG_DEFAULT_DISTANCEFIELD_GLYPH_CACHE_PADDING 2
+#endif
+
 class QOpenGLSharedResourceGuard;
 #if !defined(QT_OPENGL_ES_2)
 class QOpenGLFunctions_3_2_Core;
@@ -93,6 +98,8 @@ private:
 
     void createTexture(TextureInfo * texInfo, int width, int height);
     void resizeTexture(TextureInfo * texInfo, int width, int height);
+    void uploadTile(TextureInfo *texInfo, int x, int y, int width, int height, const uchar *bits);
+    QVector<glyph_t> storeCachedGlyphs(const QVector<glyph_t> &glyphs);
 
     TextureInfo *textureInfo(int index)
     {
@@ -137,6 +144,8 @@ private:
     mutable int m_maxTextureSize;
     int m_maxTextureCount;
 
+    QSGDistanceFieldDiskCache *m_diskCache;
+
     QList<TextureInfo> m_textures;
     QHash<glyph_t, TextureInfo *> m_glyphsTexture;
     QSet<glyph_t> m_unusedGlyphs;
@@ -40,6 +40,7 @@
 
 #include <qsgtexturematerial.h>
 #include <private/qsgtexturematerial_p.h>
+#include <private/qsgatlastexture_p.h>
 #include <qsgmaterial.h>
 
 QT_BEGIN_NAMESPACE
@@ -140,6 +141,7 @@ void SmoothTextureMaterialShader::initialize()
 QSGDefaultImageNode::QSGDefaultImageNode()
     : m_innerSourceRect(0, 0, 1, 1)
     , m_subSourceRect(0, 0, 1, 1)
+    , m_atlasGeneration(0)
     , m_antialiasing(false)
     , m_mirror(false)
     , m_dirtyGeometry(false)
@@ -245,6 +247,11 @@ void QSGDefaultImageNode::setTexture(QSGTexture *texture)
 
     // Because the texture can be a different part of the atlas, we need to update it...
     m_dirtyGeometry = true;
+
+    // ... and follow it when it is moved while its atlas is repacked.
+    QSGAtlasTexture::Texture *atlasTexture = qobject_cast<QSGAtlasTexture::Texture *>(texture);
+    if (atlasTexture && atlasTexture->isRelocatable())
+        setFlag(UsePreprocess);
 }
 
 void QSGDefaultImageNode::setAntialiasing(bool antialiasing)
@@ -290,6 +297,11 @@ void QSGDefaultImageNode::preprocess()
         if (doDirty)
             updateGeometry();
     }
+    QSGAtlasTexture::Texture *atlasTexture = qobject_cast<QSGAtlasTexture::Texture *>(m_material.texture());
+    if (atlasTexture && atlasTexture->generation() != m_atlasGeneration && !m_targetRect.isEmpty()) {
+        updateGeometry();
+        doDirty = true;
+    }
     bool alpha = m_material.flags() & QSGMaterial::Blending;
     if (m_material.texture() && alpha != m_material.texture()->hasAlphaChannel()) {
         m_material.setFlag(QSGMaterial::Blending, !alpha);
@@ -333,6 +345,8 @@ void QSGDefaultImageNode::updateGeometry()
         memset(g->vertexData(), 0, g->sizeOfVertex() * 4);
     } else {
         QRectF sourceRect = t->normalizedTextureSubRect();
+        if (const QSGAtlasTexture::Texture *atlasTexture = qobject_cast<const QSGAtlasTexture::Texture *>(t))
+            m_atlasGeneration = atlasTexture->generation();
 
         QRectF innerSourceRect(sourceRect.x() + m_innerSourceRect.x() * sourceRect.width(),
                                sourceRect.y() + m_innerSourceRect.y() * sourceRect.height(),
@@ -95,6 +95,8 @@ private:
     QSGTextureMaterial m_materialO;
     QSGSmoothTextureMaterial m_smoothMaterial;
 
+    int m_atlasGeneration;
+
     uint m_antialiasing : 1;
     uint m_mirror : 1;
     uint m_dirtyGeometry : 1;
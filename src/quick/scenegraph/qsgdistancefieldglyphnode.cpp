@@ -35,9 +35,22 @@
 #include "qsgdistancefieldglyphnode_p_p.h"
 #include <QtQuick/private/qsgdistancefieldutil_p.h>
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtCore/private/qsimd_p.h>
+
+#include <float.h>
 
 QT_BEGIN_NAMESPACE
 
+// A glyph as gathered from the glyph cache: its rectangle relative to the glyph
+// position (x1, y1, x2, y2), its texture rectangle (tx1, ty1, tx2, ty2) and its position.
+struct GlyphQuad
+{
+    float rect[4];
+    float texRect[4];
+    float position[2];
+};
+Q_DECLARE_TYPEINFO(GlyphQuad, Q_PRIMITIVE_TYPE);
+
 QSGDistanceFieldGlyphNode::QSGDistanceFieldGlyphNode(QSGRenderContext *context)
     : m_glyphNodeType(RootGlyphNode)
     , m_context(context)
@@ -175,6 +188,77 @@ void QSGDistanceFieldGlyphNode::invalidateGlyphs(const QVector<quint32> &glyphs)
     }
 }
 
+// Writes the four vertices of each glyph quad, laid out as top-left, top-right,
+// bottom-left and bottom-right, and returns the bounding rectangle of the run.
+static QRectF qsg_emitGlyphQuads(QSGGeometry::TexturedPoint2D *v, const GlyphQuad *quads, int count)
+{
+#if defined(__SSE2__)
+    __m128 vmin = _mm_set1_ps(FLT_MAX);
+    __m128 vmax = _mm_set1_ps(-FLT_MAX);
+    for (int i = 0; i < count; ++i, v += 4) {
+        const GlyphQuad &quad = quads[i];
+        // (x, y, x, y) from the two position floats
+        const __m128 position = _mm_castpd_ps(_mm_load1_pd(reinterpret_cast<const double *>(quad.position)));
+        const __m128 r = _mm_add_ps(position, _mm_loadu_ps(quad.rect));
+        const __m128 t = _mm_loadu_ps(quad.texRect);
+        _mm_storeu_ps(&v[0].x, _mm_movelh_ps(r, t));
+        _mm_storeu_ps(&v[1].x, _mm_shuffle_ps(r, t, _MM_SHUFFLE(1, 2, 1, 2)));
+        _mm_storeu_ps(&v[2].x, _mm_shuffle_ps(r, t, _MM_SHUFFLE(3, 0, 3, 0)));
+        _mm_storeu_ps(&v[3].x, _mm_movehl_ps(t, r));
+        vmin = _mm_min_ps(vmin, r);
+        vmax = _mm_max_ps(vmax, r);
+    }
+    float minimum[4];
+    float maximum[4];
+    _mm_storeu_ps(minimum, vmin);
+    _mm_storeu_ps(maximum, vmax);
+#elif defined(__ARM_NEON__)
+    float32x4_t vmin = vdupq_n_f32(FLT_MAX);
+    float32x4_t vmax = vdupq_n_f32(-FLT_MAX);
+    for (int i = 0; i < count; ++i, v += 4) {
+        const GlyphQuad &quad = quads[i];
+        const float32x2_t position = vld1_f32(quad.position);
+        const float32x4_t r = vaddq_f32(vcombine_f32(position, position), vld1q_f32(quad.rect));
+        const float32x4_t t = vld1q_f32(quad.texRect);
+        const float32x2_t topLeft = vget_low_f32(r);
+        const float32x2_t bottomRight = vget_high_f32(r);
+        const float32x2_t texTopLeft = vget_low_f32(t);
+        const float32x2_t texBottomRight = vget_high_f32(t);
+        vst1q_f32(&v[0].x, vcombine_f32(topLeft, texTopLeft));
+        vst1q_f32(&v[1].x, vcombine_f32(vset_lane_f32(vget_lane_f32(topLeft, 1), bottomRight, 1),
+                                        vset_lane_f32(vget_lane_f32(texTopLeft, 1), texBottomRight, 1)));
+        vst1q_f32(&v[2].x, vcombine_f32(vset_lane_f32(vget_lane_f32(bottomRight, 1), topLeft, 1),
+                                        vset_lane_f32(vget_lane_f32(texBottomRight, 1), texTopLeft, 1)));
+        vst1q_f32(&v[3].x, vcombine_f32(bottomRight, texBottomRight));
+        vmin = vminq_f32(vmin, r);
+        vmax = vmaxq_f32(vmax, r);
+    }
+    float minimum[4];
+    float maximum[4];
+    vst1q_f32(minimum, vmin);
+    vst1q_f32(maximum, vmax);
+#else
+    float minimum[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    float maximum[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = 0; i < count; ++i, v += 4) {
+        const GlyphQuad &quad = quads[i];
+        const float x1 = quad.position[0] + quad.rect[0];
+        const float y1 = quad.position[1] + quad.rect[1];
+        const float x2 = quad.position[0] + quad.rect[2];
+        const float y2 = quad.position[1] + quad.rect[3];
+        v[0].set(x1, y1, quad.texRect[0], quad.texRect[1]);
+        v[1].set(x2, y1, quad.texRect[2], quad.texRect[1]);
+        v[2].set(x1, y2, quad.texRect[0], quad.texRect[3]);
+        v[3].set(x2, y2, quad.texRect[2], quad.texRect[3]);
+        minimum[0] = qMin(minimum[0], x1);
+        minimum[1] = qMin(minimum[1], y1);
+        maximum[2] = qMax(maximum[2], x2);
+        maximum[3] = qMax(maximum[3], y2);
+    }
+#endif
+    return QRectF(QPointF(minimum[0], minimum[1]), QPointF(maximum[2], maximum[3]));
+}
+
 void QSGDistanceFieldGlyphNode::updateGeometry()
 {
     Q_ASSERT(m_glyph_cache);
@@ -202,10 +286,8 @@ void QSGDistanceFieldGlyphNode::updateGeometry()
 
     // The template parameters here are assuming that most strings are short, 64
     // characters or less.
-    QVarLengthArray<QSGGeometry::TexturedPoint2D, 256> vp;
-    vp.reserve(indexes.size() * 4);
-    QVarLengthArray<ushort, 384> ip;
-    ip.reserve(indexes.size() * 6);
+    QVarLengthArray<GlyphQuad, 64> quads;
+    quads.reserve(indexes.size());
 
     qreal maxTexMargin = m_glyph_cache->distanceFieldRadius();
     qreal fontScale = m_glyph_cache->fontScale(fontPixelSize);
@@ -234,7 +316,7 @@ void QSGDistanceFieldGlyphNode::updateGeometry()
         // 65536 vertices to render which would otherwise exceed the maximum index
         // size.  This will cause sub-nodes to be recursively created to handle any
         // number of glyphs.
-        if (m_texture != texture || vp.size() >= 65536) {
+        if (m_texture != texture || quads.size() * 4 >= 65536) {
             if (texture->textureId) {
                 GlyphInfo &glyphInfo = glyphsInOtherTextures[texture];
                 glyphInfo.indexes.append(glyphIndex);
@@ -256,45 +338,36 @@ void QSGDistanceFieldGlyphNode::updateGeometry()
             c.height += texMargin * 2;
         }
 
-        qreal x = position.x() + metrics.baselineX + m_position.x();
-        qreal y = position.y() - metrics.baselineY + m_position.y();
-
-        m_boundingRect |= QRectF(x, y, metrics.width, metrics.height);
-
-        float cx1 = x;
-        float cx2 = x + metrics.width;
-        float cy1 = y;
-        float cy2 = y + metrics.height;
-
-        float tx1 = c.x + c.xMargin;
-        float tx2 = tx1 + c.width;
-        float ty1 = c.y + c.yMargin;
-        float ty2 = ty1 + c.height;
-
         if (m_baseLine.isNull())
             m_baseLine = position;
 
-        int o = vp.size();
-
-        QSGGeometry::TexturedPoint2D v1;
-        v1.set(cx1, cy1, tx1, ty1);
-        QSGGeometry::TexturedPoint2D v2;
-        v2.set(cx2, cy1, tx2, ty1);
-        QSGGeometry::TexturedPoint2D v3;
-        v3.set(cx1, cy2, tx1, ty2);
-        QSGGeometry::TexturedPoint2D v4;
-        v4.set(cx2, cy2, tx2, ty2);
-        vp.append(v1);
-        vp.append(v2);
-        vp.append(v3);
-        vp.append(v4);
-
-        ip.append(o + 0);
-        ip.append(o + 2);
-        ip.append(o + 3);
-        ip.append(o + 3);
-        ip.append(o + 1);
-        ip.append(o + 0);
+        GlyphQuad quad;
+        quad.rect[0] = metrics.baselineX;
+        quad.rect[1] = -metrics.baselineY;
+        quad.rect[2] = metrics.baselineX + metrics.width;
+        quad.rect[3] = metrics.height - metrics.baselineY;
+        quad.texRect[0] = c.x + c.xMargin;
+        quad.texRect[1] = c.y + c.yMargin;
+        quad.texRect[2] = quad.texRect[0] + c.width;
+        quad.texRect[3] = quad.texRect[1] + c.height;
+        quad.position[0] = position.x() + m_position.x();
+        quad.position[1] = position.y() + m_position.y();
+        quads.append(quad);
+    }
+
+    g->allocate(quads.size() * 4, quads.size() * 6);
+    if (!quads.isEmpty()) {
+        m_boundingRect |= qsg_emitGlyphQuads(g->vertexDataAsTexturedPoint2D(), quads.constData(), quads.size());
+        quint16 *indices = g->indexDataAsUShort();
+        for (int i = 0; i < quads.size(); ++i, indices += 6) {
+            const quint16 o = i * 4;
+            indices[0] = o + 0;
+            indices[1] = o + 2;
+            indices[2] = o + 3;
+            indices[3] = o + 3;
+            indices[4] = o + 1;
+            indices[5] = o + 0;
+        }
     }
 
     QHash<const QSGDistanceFieldGlyphCache::Texture *, GlyphInfo>::const_iterator ite = glyphsInOtherTextures.constBegin();
@@ -317,10 +390,6 @@ void QSGDistanceFieldGlyphNode::updateGeometry()
         ++ite;
     }
 
-    g->allocate(vp.size(), ip.size());
-    memcpy(g->vertexDataAsTexturedPoint2D(), vp.constData(), vp.size() * sizeof(QSGGeometry::TexturedPoint2D));
-    memcpy(g->indexDataAsUShort(), ip.constData(), ip.size() * sizeof(quint16));
-
     setBoundingRect(m_boundingRect);
     markDirty(DirtyGeometry);
     m_dirtyGeometry = false;
@@ -47,7 +47,10 @@ HEADERS += \
     $$PWD/util/qsgtexture_p.h \
     $$PWD/util/qsgtextureprovider.h \
     $$PWD/util/qsgdefaultpainternode_p.h \
+    $$PWD/util/qsgdistancefielddiskcache_p.h \
     $$PWD/util/qsgdistancefieldutil_p.h \
+    $$PWD/util/qsgcompressedtexture_p.h \
+    $$PWD/util/qsgshaderdiskcache_p.h \
     $$PWD/util/qsgshadersourcebuilder_p.h
 
 SOURCES += \
@@ -63,8 +66,11 @@ SOURCES += \
     $$PWD/util/qsgtexture.cpp \
     $$PWD/util/qsgtextureprovider.cpp \
     $$PWD/util/qsgdefaultpainternode.cpp \
+    $$PWD/util/qsgdistancefielddiskcache.cpp \
     $$PWD/util/qsgdistancefieldutil.cpp \
     $$PWD/util/qsgsimplematerial.cpp \
+    $$PWD/util/qsgcompressedtexture.cpp \
+    $$PWD/util/qsgshaderdiskcache.cpp \
     $$PWD/util/qsgshadersourcebuilder.cpp
 
 # QML / Adaptations API
@@ -156,6 +156,32 @@ bool QSGAreaAllocator::allocateInNode(const QSize &size, QPoint &result, const Q
     }
 }
 
+/*
+    Returns the area of the largest free rectangle. Compared with the total
+    free area, this tells how fragmented the allocator is.
+ */
+int QSGAreaAllocator::largestFreeArea() const
+{
+    return largestFreeAreaInNode(QRect(QPoint(0, 0), m_size), m_root);
+}
+
+int QSGAreaAllocator::largestFreeAreaInNode(const QRect &currentRect, QSGAreaAllocatorNode *node) const
+{
+    if (node->isLeaf())
+        return node->isOccupied ? 0 : currentRect.width() * currentRect.height();
+
+    QRect leftRect = currentRect;
+    QRect rightRect = currentRect;
+    if (node->splitType == HorizontalSplit) {
+        leftRect.setHeight(node->split - leftRect.top());
+        rightRect.setTop(node->split);
+    } else {
+        leftRect.setWidth(node->split - leftRect.left());
+        rightRect.setLeft(node->split);
+    }
+    return qMax(largestFreeAreaInNode(leftRect, node->left), largestFreeAreaInNode(rightRect, node->right));
+}
+
 bool QSGAreaAllocator::deallocateInNode(const QPoint &pos, QSGAreaAllocatorNode *node)
 {
     while (!node->isLeaf()) {
@@ -63,8 +63,10 @@ public:
     bool deallocate(const QRect &rect);
     bool isEmpty() const { return m_root == 0; }
     QSize size() const { return m_size; }
+    int largestFreeArea() const;
 private:
     bool allocateInNode(const QSize &size, QPoint &result, const QRect &currentRect, QSGAreaAllocatorNode *node);
+    int largestFreeAreaInNode(const QRect &currentRect, QSGAreaAllocatorNode *node) const;
     bool deallocateInNode(const QPoint &pos, QSGAreaAllocatorNode *node);
     void mergeNodeWithNeighbors(QSGAreaAllocatorNode *node);
 
@@ -34,6 +34,7 @@
 #include "qsgatlastexture_p.h"
 
 #include <QtCore/QVarLengthArray>
+#include <QtCore/QVector>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QtMath>
 
@@ -48,6 +49,8 @@
 
 #include <private/qquickprofiler_p.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 #ifndef GL_BGRA
@@ -61,8 +64,18 @@ static QElapsedTimer qsg_renderer_timer;
 namespace QSGAtlasTexture
 {
 
+// Empty atlases beyond the first are released after this many frames.
+static const uint qsg_atlas_release_delay = 120;
+
+// Fragmented atlases are repacked at most once per this many frames, and
+// only after an allocation failed.
+static const uint qsg_atlas_repack_interval = 60;
+
 Manager::Manager()
-    : m_atlas(0)
+    : m_frame(0)
+    , m_last_repack_frame(0)
+    , m_allocation_failed(false)
+    , m_repack_enabled(!qEnvironmentVariableIsSet("QSG_ATLAS_NO_REPACK"))
 {
     QOpenGLContext *gl = QOpenGLContext::currentContext();
     Q_ASSERT(gl);
@@ -85,42 +98,189 @@ Manager::Manager()
 
     m_atlas_size_limit = qt_sg_envInt("QSG_ATLAS_SIZE_LIMIT", qMax(w, h) / 2);
     m_atlas_size = QSize(w, h);
+    m_max_atlas_count = qMax(1, qt_sg_envInt("QSG_ATLAS_MAX_COUNT", 4));
 
-    qCDebug(QSG_LOG_INFO, "texture atlas dimensions: %dx%d", w, h);
+    qCDebug(QSG_LOG_INFO, "texture atlas dimensions: %dx%d, at most %d atlases", w, h, m_max_atlas_count);
 }
 
 
 Manager::~Manager()
 {
-    Q_ASSERT(m_atlas == 0);
+    Q_ASSERT(m_atlases.isEmpty());
 }
 
 void Manager::invalidate()
 {
-    if (m_atlas) {
-        m_atlas->invalidate();
-        m_atlas->deleteLater();
-        m_atlas = 0;
+    for (int i = 0; i < m_atlases.size(); ++i) {
+        m_atlases.at(i)->invalidate();
+        m_atlases.at(i)->deleteLater();
     }
+    m_atlases.clear();
 }
 
 QSGTexture *Manager::create(const QImage &image, bool hasAlphaChannel)
 {
     Texture *t = 0;
     if (image.width() < m_atlas_size_limit && image.height() < m_atlas_size_limit) {
-        if (!m_atlas)
-            m_atlas = new Atlas(m_atlas_size);
-        t = m_atlas->create(image);
-        if (!hasAlphaChannel && t->hasAlphaChannel())
+        // Fill the oldest atlases first, so that newer ones can empty out.
+        for (int i = 0; !t && i < m_atlases.size(); ++i)
+            t = m_atlases.at(i)->create(image);
+        if (!t) {
+            if (!m_atlases.isEmpty())
+                m_allocation_failed = true;
+            if (m_atlases.size() < m_max_atlas_count) {
+                m_atlases << new Atlas(this, m_atlas_size);
+                t = m_atlases.last()->create(image);
+                if (m_atlases.size() > 1)
+                    logStatistics("atlas added");
+            }
+        }
+        if (t && !hasAlphaChannel && t->hasAlphaChannel())
             t->setHasAlphaChannel(false);
     }
     return t;
 }
 
-Atlas::Atlas(const QSize &size)
-    : m_allocator(size)
+/*
+    Called by the render context after each frame. Releases atlases which
+    have been empty for a while and repacks a fragmented atlas when images
+    recently failed to find room.
+ */
+void Manager::endFrame()
+{
+    ++m_frame;
+
+    for (int i = m_atlases.size() - 1; i > 0; --i) {
+        Atlas *atlas = m_atlases.at(i);
+        if (atlas->isEmpty() && m_frame - atlas->lastUsedFrame() > qsg_atlas_release_delay) {
+            m_atlases.removeAt(i);
+            atlas->invalidate();
+            delete atlas;
+            logStatistics("atlas released");
+        }
+    }
+
+    if (!m_repack_enabled || !m_allocation_failed
+            || m_frame - m_last_repack_frame < qsg_atlas_repack_interval)
+        return;
+    m_allocation_failed = false;
+    m_last_repack_frame = m_frame;
+
+    Atlas *candidate = 0;
+    for (int i = 0; i < m_atlases.size(); ++i) {
+        Atlas *atlas = m_atlases.at(i);
+        if (atlas->isEmpty() || !atlas->isRelocatable() || atlas->fragmentation() < 0.5)
+            continue;
+        if (!candidate || atlas->fragmentation() > candidate->fragmentation())
+            candidate = atlas;
+    }
+    if (candidate && repack(candidate))
+        logStatistics("atlas repacked");
+}
+
+static bool qsg_tallerTextureFirst(const Texture *a, const Texture *b)
+{
+    const QSize sa = a->atlasSubRect().size();
+    const QSize sb = b->atlasSubRect().size();
+    return sa.height() != sb.height() ? sa.height() > sb.height() : sa.width() > sb.width();
+}
+
+/*
+    Moves all textures of \a atlas into a new, tightly packed atlas, copying
+    the uploaded pixels on the GPU. Fails without side effects if they do not
+    fit or the atlas can not be read back.
+ */
+bool Manager::repack(Atlas *atlas)
+{
+    QList<Texture *> textures = atlas->m_textures.toList();
+    std::sort(textures.begin(), textures.end(), qsg_tallerTextureFirst);
+
+    Atlas *packed = new Atlas(this, m_atlas_size);
+    QVector<QRect> rects;
+    rects.reserve(textures.size());
+    for (int i = 0; i < textures.size(); ++i) {
+        const QRect r = packed->m_allocator.allocate(textures.at(i)->atlasSubRect().size());
+        if (r.isEmpty()) {
+            delete packed;
+            return false;
+        }
+        rects << r;
+    }
+
+    if (atlas->m_texture_id) {
+        packed->allocateTexture();
+        if (!packed->m_texture_id) {
+            delete packed;
+            return false;
+        }
+
+        QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+        GLint currentFbo;
+        f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &currentFbo);
+        GLuint fbo;
+        f->glGenFramebuffers(1, &fbo);
+        f->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlas->m_texture_id, 0);
+        const bool complete = f->glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        if (complete) {
+            f->glBindTexture(GL_TEXTURE_2D, packed->m_texture_id);
+            for (int i = 0; i < textures.size(); ++i) {
+                Texture *t = textures.at(i);
+                if (atlas->m_pending_uploads.contains(t))
+                    continue;
+                const QRect &from = t->atlasSubRect();
+                const QRect &to = rects.at(i);
+                f->glCopyTexSubImage2D(GL_TEXTURE_2D, 0, to.x(), to.y(), from.x(), from.y(), from.width(), from.height());
+            }
+        }
+        f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+        f->glBindFramebuffer(GL_FRAMEBUFFER, (GLuint) currentFbo);
+        f->glDeleteFramebuffers(1, &fbo);
+
+        if (!complete) {
+            packed->invalidate();
+            delete packed;
+            return false;
+        }
+    }
+
+    for (int i = 0; i < textures.size(); ++i) {
+        Texture *t = textures.at(i);
+        if (atlas->m_pending_uploads.contains(t))
+            packed->m_pending_uploads << t;
+        packed->m_textures.insert(t);
+        t->moveTo(packed, rects.at(i));
+    }
+    packed->m_last_used_frame = m_frame;
+
+    atlas->m_textures.clear();
+    atlas->m_pending_uploads.clear();
+    atlas->invalidate();
+    m_atlases.replace(m_atlases.indexOf(atlas), packed);
+    delete atlas;
+    return true;
+}
+
+void Manager::logStatistics(const char *reason) const
+{
+    if (!QSG_LOG_INFO().isDebugEnabled())
+        return;
+
+    qCDebug(QSG_LOG_INFO, "texture atlases (%s), frame %u:", reason, m_frame);
+    for (int i = 0; i < m_atlases.size(); ++i) {
+        const Atlas *atlas = m_atlases.at(i);
+        qCDebug(QSG_LOG_INFO, " - atlas %d: %d textures, %d%% occupied, %d%% fragmented, last used %u frames ago",
+                i, atlas->textureCount(), qRound(atlas->occupancy() * 100), qRound(atlas->fragmentation() * 100),
+                m_frame - atlas->lastUsedFrame());
+    }
+}
+
+Atlas::Atlas(Manager *manager, const QSize &size)
+    : m_manager(manager)
+    , m_allocator(size)
     , m_texture_id(0)
     , m_size(size)
+    , m_last_used_frame(manager->frame())
     , m_atlas_transient_image_threshold(0)
     , m_allocated(false)
 {
@@ -196,12 +356,42 @@ Texture *Atlas::create(const QImage &image)
     QRect rect = m_allocator.allocate(QSize(image.width() + 2, image.height() + 2));
     if (rect.width() > 0 && rect.height() > 0) {
         Texture *t = new Texture(this, rect, image);
+        m_textures.insert(t);
         m_pending_uploads << t;
         return t;
     }
     return 0;
 }
 
+bool Atlas::isRelocatable() const
+{
+    for (QSet<Texture *>::const_iterator it = m_textures.constBegin(); it != m_textures.constEnd(); ++it) {
+        if (!(*it)->isRelocatable())
+            return false;
+    }
+    return true;
+}
+
+qreal Atlas::occupancy() const
+{
+    qint64 used = 0;
+    for (QSet<Texture *>::const_iterator it = m_textures.constBegin(); it != m_textures.constEnd(); ++it)
+        used += (*it)->atlasSubRect().width() * (*it)->atlasSubRect().height();
+    return used / qreal(qint64(m_size.width()) * m_size.height());
+}
+
+/*
+    Returns how much of the free area is unusable for a single allocation,
+    from 0 when the free area is one rectangle to almost 1.
+ */
+qreal Atlas::fragmentation() const
+{
+    const qreal free = (1 - occupancy()) * m_size.width() * m_size.height();
+    if (free <= 0)
+        return 0;
+    return qMax(qreal(0), 1 - m_allocator.largestFreeArea() / free);
+}
+
 
 int Atlas::textureId() const
 {
@@ -326,57 +516,63 @@ void Atlas::uploadBgra(Texture *texture)
     }
 }
 
-void Atlas::bind(QSGTexture::Filtering filtering)
+void Atlas::allocateTexture()
 {
     QOpenGLFunctions *funcs = QOpenGLContext::currentContext()->functions();
-    if (!m_allocated) {
-        m_allocated = true;
+    m_allocated = true;
 
-        while (funcs->glGetError() != GL_NO_ERROR) ;
+    while (funcs->glGetError() != GL_NO_ERROR) ;
 
-        funcs->glGenTextures(1, &m_texture_id);
-        funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
-        funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    funcs->glGenTextures(1, &m_texture_id);
+    funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 #if !defined(QT_OPENGL_ES_2)
-        if (!QOpenGLContext::currentContext()->isOpenGLES())
-            funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    if (!QOpenGLContext::currentContext()->isOpenGLES())
+        funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 #endif
-        funcs->glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_size.width(), m_size.height(), 0, m_externalFormat, GL_UNSIGNED_BYTE, 0);
+    funcs->glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_size.width(), m_size.height(), 0, m_externalFormat, GL_UNSIGNED_BYTE, 0);
 
 #if 0
-        QImage pink(m_size.width(), m_size.height(), QImage::Format_ARGB32_Premultiplied);
-        pink.fill(0);
-        QPainter p(&pink);
-        QLinearGradient redGrad(0, 0, m_size.width(), 0);
-        redGrad.setColorAt(0, Qt::black);
-        redGrad.setColorAt(1, Qt::red);
-        p.fillRect(0, 0, m_size.width(), m_size.height(), redGrad);
-        p.setCompositionMode(QPainter::CompositionMode_Plus);
-        QLinearGradient blueGrad(0, 0, 0, m_size.height());
-        blueGrad.setColorAt(0, Qt::black);
-        blueGrad.setColorAt(1, Qt::blue);
-        p.fillRect(0, 0, m_size.width(), m_size.height(), blueGrad);
-        p.end();
-
-        funcs->glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_size.width(), m_size.height(), 0, m_externalFormat, GL_UNSIGNED_BYTE, pink.constBits());
+    QImage pink(m_size.width(), m_size.height(), QImage::Format_ARGB32_Premultiplied);
+    pink.fill(0);
+    QPainter p(&pink);
+    QLinearGradient redGrad(0, 0, m_size.width(), 0);
+    redGrad.setColorAt(0, Qt::black);
+    redGrad.setColorAt(1, Qt::red);
+    p.fillRect(0, 0, m_size.width(), m_size.height(), redGrad);
+    p.setCompositionMode(QPainter::CompositionMode_Plus);
+    QLinearGradient blueGrad(0, 0, 0, m_size.height());
+    blueGrad.setColorAt(0, Qt::black);
+    blueGrad.setColorAt(1, Qt::blue);
+    p.fillRect(0, 0, m_size.width(), m_size.height(), blueGrad);
+    p.end();
+
+    funcs->glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_size.width(), m_size.height(), 0, m_externalFormat, GL_UNSIGNED_BYTE, pink.constBits());
 #endif
 
-        GLenum errorCode = funcs->glGetError();
-        if (errorCode == GL_OUT_OF_MEMORY) {
-            qDebug("QSGTextureAtlas: texture atlas allocation failed, out of memory");
-            funcs->glDeleteTextures(1, &m_texture_id);
-            m_texture_id = 0;
-        } else if (errorCode != GL_NO_ERROR) {
-            qDebug("QSGTextureAtlas: texture atlas allocation failed, code=%x", errorCode);
-            funcs->glDeleteTextures(1, &m_texture_id);
-            m_texture_id = 0;
-        }
-    } else {
-        funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    GLenum errorCode = funcs->glGetError();
+    if (errorCode == GL_OUT_OF_MEMORY) {
+        qDebug("QSGTextureAtlas: texture atlas allocation failed, out of memory");
+        funcs->glDeleteTextures(1, &m_texture_id);
+        m_texture_id = 0;
+    } else if (errorCode != GL_NO_ERROR) {
+        qDebug("QSGTextureAtlas: texture atlas allocation failed, code=%x", errorCode);
+        funcs->glDeleteTextures(1, &m_texture_id);
+        m_texture_id = 0;
     }
+}
+
+void Atlas::bind(QSGTexture::Filtering filtering)
+{
+    QOpenGLFunctions *funcs = QOpenGLContext::currentContext()->functions();
+    if (!m_allocated)
+        allocateTexture();
+    else
+        funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    m_last_used_frame = m_manager->frame();
 
     if (m_texture_id == 0)
         return;
@@ -424,6 +620,7 @@ void Atlas::remove(Texture *t)
 {
     QRect atlasRect = t->atlasSubRect();
     m_allocator.deallocate(atlasRect);
+    m_textures.remove(t);
     m_pending_uploads.removeOne(t);
 }
 
@@ -435,8 +632,19 @@ Texture::Texture(Atlas *atlas, const QRect &textureRect, const QImage &image)
     , m_image(image)
     , m_atlas(atlas)
     , m_nonatlas_texture(0)
+    , m_generation(0)
     , m_has_alpha(image.hasAlphaChannel())
+    , m_relocatable(false)
 {
+    moveTo(atlas, textureRect);
+}
+
+void Texture::moveTo(Atlas *atlas, const QRect &textureRect)
+{
+    m_atlas = atlas;
+    m_allocated_rect = textureRect;
+    ++m_generation;
+
     float w = atlas->size().width();
     float h = atlas->size().height();
     QRect nopad = atlasSubRectWithoutPadding();
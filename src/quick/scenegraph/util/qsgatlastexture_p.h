@@ -46,6 +46,7 @@
 //
 
 #include <QtCore/QSize>
+#include <QtCore/QSet>
 
 #include <QtGui/qopengl.h>
 
@@ -72,17 +73,29 @@ public:
     QSGTexture *create(const QImage &image, bool hasAlphaChannel);
     void invalidate();
 
+    void endFrame();
+    uint frame() const { return m_frame; }
+
 private:
-    Atlas *m_atlas;
+    bool repack(Atlas *atlas);
+    void logStatistics(const char *reason) const;
+
+    QList<Atlas *> m_atlases;
 
     QSize m_atlas_size;
     int m_atlas_size_limit;
+    int m_max_atlas_count;
+
+    uint m_frame;
+    uint m_last_repack_frame;
+    uint m_allocation_failed : 1;
+    uint m_repack_enabled : 1;
 };
 
 class Atlas : public QObject
 {
 public:
-    Atlas(const QSize &size);
+    Atlas(Manager *manager, const QSize &size);
     ~Atlas();
 
     void invalidate();
@@ -97,15 +110,30 @@ public:
     void remove(Texture *t);
 
     QSize size() const { return m_size; }
+    Manager *manager() const { return m_manager; }
+
+    bool isEmpty() const { return m_textures.isEmpty(); }
+    int textureCount() const { return m_textures.size(); }
+    bool isRelocatable() const;
+    uint lastUsedFrame() const { return m_last_used_frame; }
+    qreal occupancy() const;
+    qreal fragmentation() const;
 
     GLuint internalFormat() const { return m_internalFormat; }
     GLuint externalFormat() const { return m_externalFormat; }
 
 private:
+    friend class Manager;
+
+    void allocateTexture();
+
+    Manager *m_manager;
     QSGAreaAllocator m_allocator;
     GLuint m_texture_id;
     QSize m_size;
+    QSet<Texture *> m_textures;
     QList<Texture *> m_pending_uploads;
+    uint m_last_used_frame;
 
     GLuint m_internalFormat;
     GLuint m_externalFormat;
@@ -144,9 +172,19 @@ public:
     void releaseImage() { m_image = QImage(); }
     const QImage &image() const { return m_image; }
 
+    // Relocatable textures may be moved to another atlas when their atlas is
+    // repacked, users must then pick up the new normalizedTextureSubRect().
+    void setRelocatable(bool relocatable) { m_relocatable = relocatable; }
+    bool isRelocatable() const { return m_relocatable; }
+    int generation() const { return m_generation; }
+
     void bind();
 
 private:
+    friend class Manager;
+
+    void moveTo(Atlas *atlas, const QRect &textureRect);
+
     QRect m_allocated_rect;
     QRectF m_texture_coords_rect;
 
@@ -156,7 +194,10 @@ private:
 
     mutable QSGPlainTexture *m_nonatlas_texture;
 
+    int m_generation;
+
     uint m_has_alpha : 1;
+    uint m_relocatable : 1;
 };
 
 }
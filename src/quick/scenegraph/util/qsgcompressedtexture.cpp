@@ -0,0 +1,414 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsgcompressedtexture_p.h"
+
+#include <QtQuick/private/qsgcontext_p.h>
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglfunctions.h>
+
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES 0x8d64
+#endif
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_SRGB8_ETC2 0x9275
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#define GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9277
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC 0x9279
+#endif
+
+#ifndef GL_NUM_COMPRESSED_TEXTURE_FORMATS
+#define GL_NUM_COMPRESSED_TEXTURE_FORMATS 0x86A2
+#endif
+
+#ifndef GL_COMPRESSED_TEXTURE_FORMATS
+#define GL_COMPRESSED_TEXTURE_FORMATS 0x86A3
+#endif
+
+QT_BEGIN_NAMESPACE
+
+static const char qsg_ktxIdentifier[12] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+static const int qsg_ktxHeaderSize = 64;
+static const int qsg_pkmHeaderSize = 16;
+
+static bool qsg_isKtx(const uchar *data, qint64 size)
+{
+    return size >= qint64(sizeof(qsg_ktxIdentifier))
+            && memcmp(data, qsg_ktxIdentifier, sizeof(qsg_ktxIdentifier)) == 0;
+}
+
+static bool qsg_isPkm(const uchar *data, qint64 size)
+{
+    return size >= 4 && memcmp(data, "PKM ", 4) == 0;
+}
+
+static quint32 qsg_ktxWord(const uchar *data, int index, bool bigEndian)
+{
+    const uchar *p = data + sizeof(qsg_ktxIdentifier) + index * 4;
+    return bigEndian ? qFromBigEndian<quint32>(p) : qFromLittleEndian<quint32>(p);
+}
+
+// KTX 1.1, see https://www.khronos.org/opengles/sdk/tools/KTX/file_format_spec/
+static bool qsg_parseKtx(const uchar *data, qint64 size, QSGTextureFileData *d,
+                         qint64 *offset, QString *errorString)
+{
+    enum { Endianness, GlType, GlTypeSize, GlFormat, GlInternalFormat, GlBaseInternalFormat,
+           PixelWidth, PixelHeight, PixelDepth, ArrayElements, Faces, MipmapLevels, KeyValueBytes };
+
+    if (size < qsg_ktxHeaderSize + 4) {
+        *errorString = QStringLiteral("Truncated KTX header");
+        return false;
+    }
+
+    // The header is written in the byte order of the machine that created the file
+    const bool bigEndian = qsg_ktxWord(data, Endianness, false) != 0x04030201;
+    if (qsg_ktxWord(data, Endianness, bigEndian) != 0x04030201) {
+        *errorString = QStringLiteral("Invalid KTX endianness marker");
+        return false;
+    }
+
+    if (qsg_ktxWord(data, PixelDepth, bigEndian) > 1
+            || qsg_ktxWord(data, ArrayElements, bigEndian) > 0
+            || qsg_ktxWord(data, Faces, bigEndian) != 1) {
+        *errorString = QStringLiteral("Only 2D KTX textures are supported");
+        return false;
+    }
+
+    d->glType = qsg_ktxWord(data, GlType, bigEndian);
+    d->glFormat = qsg_ktxWord(data, GlFormat, bigEndian);
+    d->glInternalFormat = qsg_ktxWord(data, GlInternalFormat, bigEndian);
+    d->size = QSize(qsg_ktxWord(data, PixelWidth, bigEndian), qsg_ktxWord(data, PixelHeight, bigEndian));
+
+    if (d->size.isEmpty()) {
+        *errorString = QStringLiteral("Invalid KTX texture size");
+        return false;
+    }
+
+    // Uncompressed data is uploaded as it is, so only accept what
+    // glTexImage2D takes on every OpenGL version without conversion.
+    if (!d->isCompressed()) {
+        if (d->glType != GL_UNSIGNED_BYTE || (d->glFormat != GL_RGBA && d->glFormat != GL_RGB)) {
+            *errorString = QStringLiteral("Uncompressed KTX textures must be GL_RGBA or GL_RGB with GL_UNSIGNED_BYTE components");
+            return false;
+        }
+        d->glInternalFormat = d->glFormat;
+    }
+
+    const GLenum baseFormat = qsg_ktxWord(data, GlBaseInternalFormat, bigEndian);
+    d->hasAlpha = baseFormat == GL_RGBA || baseFormat == GL_ALPHA || baseFormat == GL_LUMINANCE_ALPHA;
+
+    // Only the first mipmap level is used, the image size precedes it
+    const qint64 imageSizeOffset = qint64(qsg_ktxHeaderSize) + qsg_ktxWord(data, KeyValueBytes, bigEndian);
+    if (imageSizeOffset + 4 > size) {
+        *errorString = QStringLiteral("Truncated KTX key/value data");
+        return false;
+    }
+
+    const uchar *p = data + imageSizeOffset;
+    const quint32 imageSize = bigEndian ? qFromBigEndian<quint32>(p) : qFromLittleEndian<quint32>(p);
+    *offset = imageSizeOffset + 4;
+    if (*offset + imageSize > size) {
+        *errorString = QStringLiteral("Truncated KTX image data");
+        return false;
+    }
+
+    // glTexImage2D reads whole rows, which KTX pads to four bytes like the
+    // default unpack alignment does.
+    if (!d->isCompressed()) {
+        const qint64 bytesPerLine = (qint64(d->size.width()) * (d->glFormat == GL_RGBA ? 4 : 3) + 3) & ~qint64(3);
+        if (imageSize < bytesPerLine * d->size.height()) {
+            *errorString = QStringLiteral("KTX image data is smaller than the texture");
+            return false;
+        }
+    }
+    d->payload = QByteArray::fromRawData(reinterpret_cast<const char *>(data + *offset), imageSize);
+    return true;
+}
+
+// PKM as written by etcpack and the Mali texture compression tool
+static bool qsg_parsePkm(const uchar *data, qint64 size, QSGTextureFileData *d,
+                         qint64 *offset, QString *errorString)
+{
+    if (size < qsg_pkmHeaderSize) {
+        *errorString = QStringLiteral("Truncated PKM header");
+        return false;
+    }
+
+    const quint16 type = qFromBigEndian<quint16>(data + 6);
+    const int paddedWidth = qFromBigEndian<quint16>(data + 8);
+    const int paddedHeight = qFromBigEndian<quint16>(data + 10);
+    d->size = QSize(qFromBigEndian<quint16>(data + 12), qFromBigEndian<quint16>(data + 14));
+
+    int blockSize = 8;
+    switch (type) {
+    case 0:
+        d->glInternalFormat = GL_ETC1_RGB8_OES;
+        break;
+    case 1:
+        d->glInternalFormat = GL_COMPRESSED_RGB8_ETC2;
+        break;
+    case 3:
+        d->glInternalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC;
+        d->hasAlpha = true;
+        blockSize = 16;
+        break;
+    case 4:
+        d->glInternalFormat = GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+        d->hasAlpha = true;
+        break;
+    default:
+        *errorString = QStringLiteral("Unsupported PKM texture type %1").arg(type);
+        return false;
+    }
+
+    if (d->size.isEmpty() || paddedWidth < d->size.width() || paddedHeight < d->size.height()) {
+        *errorString = QStringLiteral("Invalid PKM texture size");
+        return false;
+    }
+
+    const qint64 imageSize = qint64((paddedWidth + 3) / 4) * ((paddedHeight + 3) / 4) * blockSize;
+    *offset = qsg_pkmHeaderSize;
+    if (*offset + imageSize > size) {
+        *errorString = QStringLiteral("Truncated PKM image data");
+        return false;
+    }
+    d->payload = QByteArray::fromRawData(reinterpret_cast<const char *>(data + *offset), imageSize);
+    return true;
+}
+
+static bool qsg_parseTextureFile(const uchar *data, qint64 size, QSGTextureFileData *d,
+                                 qint64 *offset, QString *errorString)
+{
+    if (qsg_isKtx(data, size))
+        return qsg_parseKtx(data, size, d, offset, errorString);
+    if (qsg_isPkm(data, size))
+        return qsg_parsePkm(data, size, d, offset, errorString);
+    *errorString = QStringLiteral("Unknown texture file format");
+    return false;
+}
+
+static bool qsg_hasEtc2(QOpenGLContext *context)
+{
+    if (context->isOpenGLES())
+        return context->format().majorVersion() >= 3;
+    return context->format().version() >= qMakePair(4, 3)
+            || context->hasExtension(QByteArrayLiteral("GL_ARB_ES3_compatibility"));
+}
+
+QSGCompressedTexture::QSGCompressedTexture(const QSGTextureFileData &data)
+    : m_data(data)
+    , m_texture_id(0)
+    , m_texture_size(data.size)
+    , m_has_alpha(data.hasAlpha)
+{
+}
+
+QSGCompressedTexture::~QSGCompressedTexture()
+{
+    if (m_texture_id && QOpenGLContext::currentContext())
+        QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_texture_id);
+}
+
+// Returns true if internalFormat can be uploaded with glCompressedTexImage2D
+// in context. ETC1 data is decoded by every ETC2 implementation, so
+// internalFormat is changed to GL_COMPRESSED_RGB8_ETC2 when only the
+// latter is available.
+bool QSGCompressedTexture::isFormatSupported(QOpenGLContext *context, GLenum *internalFormat)
+{
+    switch (*internalFormat) {
+    case GL_ETC1_RGB8_OES:
+        if (context->hasExtension(QByteArrayLiteral("GL_OES_compressed_ETC1_RGB8_texture")))
+            return true;
+        if (qsg_hasEtc2(context)) {
+            *internalFormat = GL_COMPRESSED_RGB8_ETC2;
+            return true;
+        }
+        return false;
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_SRGB8_ETC2:
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        if (qsg_hasEtc2(context))
+            return true;
+        break;
+    default:
+        break;
+    }
+
+    QOpenGLFunctions *funcs = context->functions();
+    GLint count = 0;
+    funcs->glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    QVarLengthArray<GLint, 32> formats(count);
+    if (count > 0)
+        funcs->glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+    for (int i = 0; i < count; ++i) {
+        if (GLenum(formats.at(i)) == *internalFormat)
+            return true;
+    }
+    return false;
+}
+
+void QSGCompressedTexture::bind()
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    QOpenGLFunctions *funcs = context->functions();
+    if (m_texture_id) {
+        funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
+        updateBindOptions();
+        return;
+    }
+
+    QElapsedTimer timer;
+    bool profileFrames = QSG_LOG_TIME_TEXTURE().isDebugEnabled();
+    if (profileFrames)
+        timer.start();
+
+    funcs->glGenTextures(1, &m_texture_id);
+    funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    updateBindOptions(true);
+
+    int max;
+    if (QSGRenderContext *rc = QSGRenderContext::from(context))
+        max = rc->maxTextureSize();
+    else
+        funcs->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max);
+
+    // Nothing is decoded on the CPU, so there is no fallback for data the
+    // GPU cannot take. Leave a transparent pixel instead of garbage.
+    GLenum internalFormat = m_data.glInternalFormat;
+    if (m_texture_size.width() > max || m_texture_size.height() > max) {
+        qWarning("QSGCompressedTexture: texture size %dx%d exceeds the maximum of %d",
+                 m_texture_size.width(), m_texture_size.height(), max);
+        internalFormat = 0;
+    } else if (m_data.isCompressed() && !isFormatSupported(context, &internalFormat)) {
+        qWarning("QSGCompressedTexture: compressed format 0x%x is not supported by the OpenGL implementation",
+                 m_data.glInternalFormat);
+        internalFormat = 0;
+    }
+
+    if (!internalFormat) {
+        const quint32 transparent = 0;
+        funcs->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &transparent);
+    } else if (m_data.isCompressed()) {
+        funcs->glCompressedTexImage2D(GL_TEXTURE_2D, 0, internalFormat,
+                                      m_texture_size.width(), m_texture_size.height(), 0,
+                                      m_data.payload.size(), m_data.payload.constData());
+    } else {
+        funcs->glTexImage2D(GL_TEXTURE_2D, 0, internalFormat,
+                            m_texture_size.width(), m_texture_size.height(), 0,
+                            m_data.glFormat, m_data.glType, m_data.payload.constData());
+    }
+
+    if (profileFrames) {
+        qCDebug(QSG_LOG_TIME_TEXTURE, "compressed texture uploaded in: %dms (%dx%d), format=0x%x, bytes=%d",
+                int(timer.elapsed()),
+                m_texture_size.width(), m_texture_size.height(),
+                internalFormat, m_data.payload.size());
+    }
+
+    // The texture factory keeps its own reference to the payload
+    m_data = QSGTextureFileData();
+}
+
+// Returns true if the data available from device starts like a KTX or
+// PKM container. The device position is not changed.
+bool QSGCompressedTextureFactory::canRead(QIODevice *device)
+{
+    return canRead(device->peek(sizeof(qsg_ktxIdentifier)));
+}
+
+bool QSGCompressedTextureFactory::canRead(const QByteArray &header)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(header.constData());
+    return qsg_isKtx(data, header.size()) || qsg_isPkm(data, header.size());
+}
+
+// Creates a texture factory for the texture file fileName. The file is
+// memory mapped when possible, so the payload is paged in on demand by the
+// upload rather than copied to the heap.
+QSGCompressedTextureFactory *QSGCompressedTextureFactory::create(const QString &fileName, QString *errorString)
+{
+    QSharedPointer<QFile> file(new QFile(fileName));
+    if (!file->open(QIODevice::ReadOnly)) {
+        *errorString = file->errorString();
+        return 0;
+    }
+
+    const qint64 size = file->size();
+    if (uchar *data = file->map(0, size)) {
+        QSGTextureFileData d;
+        qint64 offset = 0;
+        if (!qsg_parseTextureFile(data, size, &d, &offset, errorString))
+            return 0;
+        d.mappedFile = file;
+        return new QSGCompressedTextureFactory(d);
+    }
+
+    // Not mappable, e.g. a compressed resource
+    return create(file->readAll(), errorString);
+}
+
+QSGCompressedTextureFactory *QSGCompressedTextureFactory::create(const QByteArray &data, QString *errorString)
+{
+    QSGTextureFileData d;
+    qint64 offset = 0;
+    if (!qsg_parseTextureFile(reinterpret_cast<const uchar *>(data.constData()), data.size(),
+                              &d, &offset, errorString)) {
+        return 0;
+    }
+    d.payload = data.mid(offset, d.payload.size());
+    return new QSGCompressedTextureFactory(d);
+}
+
+QSGCompressedTextureFactory::QSGCompressedTextureFactory(const QSGTextureFileData &data)
+    : m_data(data)
+{
+}
+
+QSGTexture *QSGCompressedTextureFactory::createTexture(QQuickWindow *) const
+{
+    return new QSGCompressedTexture(m_data);
+}
+
+QT_END_NAMESPACE
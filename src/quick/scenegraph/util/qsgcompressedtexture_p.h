@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSGCOMPRESSEDTEXTURE_P_H
+#define QSGCOMPRESSEDTEXTURE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtquickglobal_p.h>
+#include <QtQuick/qsgtexture.h>
+#include <QtQuick/qquickimageprovider.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtGui/qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QFile;
+class QIODevice;
+
+// The first image of a KTX or PKM container. The payload either points into
+// a memory mapped file, which stays mapped as long as a copy of this is
+// alive, or into an ordinary byte array.
+class QSGTextureFileData
+{
+public:
+    QSGTextureFileData()
+        : glInternalFormat(0), glFormat(0), glType(0), hasAlpha(false)
+    {
+    }
+
+    bool isNull() const { return payload.isNull(); }
+    bool isCompressed() const { return glType == 0; }
+
+    QByteArray payload;
+    QSharedPointer<QFile> mappedFile;
+    QSize size;
+    GLenum glInternalFormat;
+    GLenum glFormat;
+    GLenum glType;
+    bool hasAlpha;
+};
+
+class Q_QUICK_PRIVATE_EXPORT QSGCompressedTexture : public QSGTexture
+{
+    Q_OBJECT
+public:
+    QSGCompressedTexture(const QSGTextureFileData &data);
+    ~QSGCompressedTexture();
+
+    int textureId() const Q_DECL_OVERRIDE { return m_texture_id; }
+    QSize textureSize() const Q_DECL_OVERRIDE { return m_texture_size; }
+    bool hasAlphaChannel() const Q_DECL_OVERRIDE { return m_has_alpha; }
+    bool hasMipmaps() const Q_DECL_OVERRIDE { return false; }
+
+    void bind() Q_DECL_OVERRIDE;
+
+    static bool isFormatSupported(QOpenGLContext *context, GLenum *internalFormat);
+
+private:
+    QSGTextureFileData m_data;
+    GLuint m_texture_id;
+    QSize m_texture_size;
+    bool m_has_alpha;
+};
+
+class Q_QUICK_PRIVATE_EXPORT QSGCompressedTextureFactory : public QQuickTextureFactory
+{
+    Q_OBJECT
+public:
+    static bool canRead(QIODevice *device);
+    static bool canRead(const QByteArray &header);
+
+    static QSGCompressedTextureFactory *create(const QString &fileName, QString *errorString);
+    static QSGCompressedTextureFactory *create(const QByteArray &data, QString *errorString);
+
+    QSGTexture *createTexture(QQuickWindow *window) const Q_DECL_OVERRIDE;
+    QSize textureSize() const Q_DECL_OVERRIDE { return m_data.size; }
+    int textureByteCount() const Q_DECL_OVERRIDE { return m_data.payload.size(); }
+
+private:
+    QSGCompressedTextureFactory(const QSGTextureFileData &data);
+
+    QSGTextureFileData m_data;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGCOMPRESSEDTEXTURE_P_H
@@ -0,0 +1,188 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgdistancefielddiskcache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+#include <private/qquickworkerpool_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// Bump when the tile layout or the distance field generation changes.
+static const quint32 qsg_dfcache_version = 1;
+static const quint32 qsg_dfcache_magic = 0x46445351; // "QSDF"
+
+struct QSGDistanceFieldTileHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 width;
+    quint32 height;
+};
+
+/*
+    Returns the directory given by the QSG_DISTANCEFIELD_CACHE_DIR environment
+    variable, or an empty string when the disk cache is disabled.
+ */
+QString QSGDistanceFieldDiskCache::defaultDirectory()
+{
+    static const QString dir = QString::fromLocal8Bit(qgetenv("QSG_DISTANCEFIELD_CACHE_DIR"));
+    return dir;
+}
+
+static QString qsg_tileFileName(const QString &path, glyph_t glyph)
+{
+    return path + QLatin1Char('/') + QString::number(glyph) + QLatin1String(".df");
+}
+
+static bool qsg_storeTile(const QString &path, glyph_t glyph, const QDistanceField &tile)
+{
+    if (tile.isNull())
+        return false;
+
+    QSGDistanceFieldTileHeader header;
+    header.magic = qToLittleEndian(qsg_dfcache_magic);
+    header.version = qToLittleEndian(qsg_dfcache_version);
+    header.width = qToLittleEndian(quint32(tile.width()));
+    header.height = qToLittleEndian(quint32(tile.height()));
+
+    // QSaveFile renames the tile into place, so readers never see a partial file.
+    QSaveFile file(qsg_tileFileName(path, glyph));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(tile.constBits()), qint64(tile.width()) * tile.height());
+    return file.commit();
+}
+
+// Writes the tiles generated in one frame for one font.
+class QSGDistanceFieldDiskCacheWriter : public QRunnable
+{
+public:
+    QSGDistanceFieldDiskCacheWriter(const QString &path, const QSGDistanceFieldDiskCache::TileList &tiles)
+        : m_path(path), m_tiles(tiles)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        if (!QDir().mkpath(m_path))
+            return;
+        for (int i = 0; i < m_tiles.size(); ++i)
+            qsg_storeTile(m_path, m_tiles.at(i).first, m_tiles.at(i).second);
+    }
+
+private:
+    QString m_path;
+    QSGDistanceFieldDiskCache::TileList m_tiles;
+};
+
+QSGDistanceFieldDiskCache::QSGDistanceFieldDiskCache(const QString &directory, const QRawFont &font,
+                                                     bool doubleGlyphResolution, int padding)
+{
+    // The head table carries the checksum of the whole font file, maxp the glyph
+    // count; together with the names they identify the font file.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(font.familyName().toUtf8());
+    hash.addData(font.styleName().toUtf8());
+    hash.addData(QByteArray::number(font.weight()));
+    hash.addData(QByteArray::number(int(font.style())));
+    hash.addData(font.fontTable("head"));
+    hash.addData(font.fontTable("maxp"));
+    hash.addData(font.fontTable("name"));
+
+    const QString key = QString::fromLatin1(hash.result().toHex())
+            + QLatin1Char('-') + QString::number(qsg_dfcache_version)
+            + QLatin1Char('-') + QLatin1Char(doubleGlyphResolution ? 'd' : 's')
+            + QString::number(padding);
+
+    m_path = QDir(directory).filePath(key);
+}
+
+bool QSGDistanceFieldDiskCache::load(glyph_t glyph, Tile *tile) const
+{
+    tile->file.setFileName(qsg_tileFileName(m_path, glyph));
+    if (!tile->file.open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 size = tile->file.size();
+    if (size < qint64(sizeof(QSGDistanceFieldTileHeader)))
+        return false;
+
+    const uchar *data = tile->file.map(0, size);
+    if (!data)
+        return false;
+
+    QSGDistanceFieldTileHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (qFromLittleEndian(header.magic) != qsg_dfcache_magic
+            || qFromLittleEndian(header.version) != qsg_dfcache_version) {
+        return false;
+    }
+
+    const int width = qFromLittleEndian(header.width);
+    const int height = qFromLittleEndian(header.height);
+    if (width <= 0 || height <= 0 || size != qint64(sizeof(header)) + qint64(width) * height)
+        return false;
+
+    tile->width = width;
+    tile->height = height;
+    tile->bits = data + sizeof(header);
+    return true;
+}
+
+/*
+    Writes \a tile right away. Used by tools that fill the cache.
+ */
+bool QSGDistanceFieldDiskCache::store(glyph_t glyph, const QDistanceField &tile)
+{
+    if (!QDir().mkpath(m_path))
+        return false;
+    return qsg_storeTile(m_path, glyph, tile);
+}
+
+/*
+    Writes \a tiles on a worker thread, so that the render thread does not
+    wait for the file system.
+ */
+void QSGDistanceFieldDiskCache::storeLater(const TileList &tiles)
+{
+    if (!tiles.isEmpty())
+        qquick_workerPool()->start(new QSGDistanceFieldDiskCacheWriter(m_path, tiles));
+}
+
+QT_END_NAMESPACE
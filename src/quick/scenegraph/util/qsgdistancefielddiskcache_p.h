@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGDISTANCEFIELDDISKCACHE_P_H
+#define QSGDISTANCEFIELDDISKCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qfile.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qvector.h>
+#include <QtGui/qrawfont.h>
+#include <private/qfontengine_p.h>
+#include <private/qdistancefield_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// Stores padded distance-field tiles on disk so that they can be uploaded
+// straight from a memory mapped file instead of being regenerated on every
+// start. Tiles are stored per font, distance field resolution and padding.
+class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldDiskCache
+{
+public:
+    class Tile
+    {
+    public:
+        Tile() : width(0), height(0), bits(0) { }
+
+        int width;
+        int height;
+        const uchar *bits;
+
+    private:
+        QFile file;
+        friend class QSGDistanceFieldDiskCache;
+        Q_DISABLE_COPY(Tile)
+    };
+
+    QSGDistanceFieldDiskCache(const QString &directory, const QRawFont &font,
+                              bool doubleGlyphResolution, int padding);
+
+    static QString defaultDirectory();
+
+    typedef QVector<QPair<glyph_t, QDistanceField> > TileList;
+
+    bool load(glyph_t glyph, Tile *tile) const;
+    bool store(glyph_t glyph, const QDistanceField &tile);
+    void storeLater(const TileList &tiles);
+
+private:
+    QString m_path;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGDISTANCEFIELDDISKCACHE_P_H
@@ -0,0 +1,395 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsgshaderdiskcache_p.h"
+
+#include <QtQuick/private/qsgcontext_p.h>
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglfunctions.h>
+#include <QtGui/qopenglshaderprogram.h>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+QT_BEGIN_NAMESPACE
+
+// Bump when the shader rewriting or the file layout changes.
+static const quint32 qsg_shadercache_version = 1;
+static const quint32 qsg_shadercache_magic = 0x48535351; // "QSSH"
+
+// Default limit for the total size of the binaries stored for one driver.
+static const qint64 qsg_shadercache_default_max_size = 8 * 1024 * 1024;
+
+struct QSGProgramBinaryHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 format;
+    quint32 length;
+};
+
+static QString qsg_shaderCacheDirectory()
+{
+    if (qEnvironmentVariableIsSet("QSG_NO_SHADER_CACHE"))
+        return QString();
+
+    const QString dir = QString::fromLocal8Bit(qgetenv("QSG_SHADER_CACHE_DIR"));
+    if (!dir.isEmpty())
+        return dir;
+
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheLocation.isEmpty())
+        return QString();
+    return cacheLocation + QLatin1String("/qsgshadercache");
+}
+
+/*
+    Returns the size limit in bytes given by the QSG_SHADER_CACHE_MAX_SIZE
+    environment variable, or the default limit.
+ */
+static qint64 qsg_shaderCacheMaxSize()
+{
+    static const qint64 maxSize = qgetenv("QSG_SHADER_CACHE_MAX_SIZE").toLongLong();
+    return maxSize > 0 ? maxSize : qsg_shadercache_default_max_size;
+}
+
+/*
+    Binaries are stored in one subdirectory per driver, named after the first
+    sixteen hex digits of the driver hash.
+ */
+static bool qsg_isDriverDirectoryName(const QString &name)
+{
+    if (name.size() != 16)
+        return false;
+    for (int i = 0; i < name.size(); ++i) {
+        const QChar c = name.at(i);
+        if (!c.isDigit() && (c < QLatin1Char('a') || c > QLatin1Char('f')))
+            return false;
+    }
+    return true;
+}
+
+static void qsg_removeBinaries(const QString &directory)
+{
+    QDir dir(directory);
+    const QStringList files = dir.entryList(QStringList(QStringLiteral("*.bin")), QDir::Files);
+    for (int i = 0; i < files.size(); ++i)
+        dir.remove(files.at(i));
+}
+
+/*
+    Removes the binaries stored for other drivers than \a driverDirectory, for
+    instance those left behind by a driver update, and those of the older
+    layout without driver directories. Done once per process, by the first
+    context that uses the cache.
+ */
+static void qsg_pruneStaleDrivers(const QString &driverDirectory)
+{
+    static QBasicAtomicInt pruned = Q_BASIC_ATOMIC_INITIALIZER(0);
+    if (!pruned.testAndSetRelaxed(0, 1))
+        return;
+
+    const QString cacheDirectory = QSGShaderDiskCache::defaultDirectory();
+    qsg_removeBinaries(cacheDirectory);
+
+    QDir dir(cacheDirectory);
+    const QString current = QFileInfo(driverDirectory).fileName();
+    const QStringList drivers = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (int i = 0; i < drivers.size(); ++i) {
+        const QString &name = drivers.at(i);
+        if (name == current || !qsg_isDriverDirectoryName(name))
+            continue;
+        qCDebug(QSG_LOG_INFO, "removing program binaries of stale driver %s", qPrintable(name));
+        qsg_removeBinaries(dir.filePath(name));
+        dir.rmdir(name);
+    }
+}
+
+/*
+    Removes the oldest binaries in \a driverDirectory until the ones left fit
+    in the size limit. The binary just stored in \a keep is never removed.
+ */
+static void qsg_evictBinaries(const QString &driverDirectory, const QString &keep)
+{
+    QDir dir(driverDirectory);
+    const QFileInfoList files = dir.entryInfoList(QStringList(QStringLiteral("*.bin")), QDir::Files,
+                                                  QDir::Time | QDir::Reversed);
+    qint64 size = 0;
+    for (int i = 0; i < files.size(); ++i)
+        size += files.at(i).size();
+
+    const qint64 maxSize = qsg_shaderCacheMaxSize();
+    for (int i = 0; i < files.size() && size > maxSize; ++i) {
+        const QFileInfo &file = files.at(i);
+        if (file.fileName() == keep)
+            continue;
+        if (dir.remove(file.fileName()))
+            size -= file.size();
+    }
+}
+
+/*
+    Returns the directory given by the QSG_SHADER_CACHE_DIR environment
+    variable, or a directory in the application's cache location. Returns an
+    empty string when QSG_NO_SHADER_CACHE is set.
+ */
+QString QSGShaderDiskCache::defaultDirectory()
+{
+    static const QString dir = qsg_shaderCacheDirectory();
+    return dir;
+}
+
+/*
+    Resolves the program binary functions for \a context, which must be
+    current. The cache stays disabled when the context does not support
+    program binaries or when the driver reports no binary formats.
+ */
+QSGShaderDiskCache::QSGShaderDiskCache(QOpenGLContext *context)
+    : m_context(context)
+    , m_programBinary(0)
+    , m_getProgramBinary(0)
+    , m_programParameteri(0)
+{
+    if (!context || defaultDirectory().isEmpty())
+        return;
+
+    const QSurfaceFormat format = context->format();
+    if (context->isOpenGLES() && format.majorVersion() < 3) {
+        if (context->hasExtension(QByteArrayLiteral("GL_OES_get_program_binary"))) {
+            m_programBinary = reinterpret_cast<ProgramBinary>(context->getProcAddress("glProgramBinaryOES"));
+            m_getProgramBinary = reinterpret_cast<GetProgramBinary>(context->getProcAddress("glGetProgramBinaryOES"));
+        }
+    } else if (context->isOpenGLES() || format.version() >= qMakePair(4, 1)
+               || context->hasExtension(QByteArrayLiteral("GL_ARB_get_program_binary"))) {
+        m_programBinary = reinterpret_cast<ProgramBinary>(context->getProcAddress("glProgramBinary"));
+        m_getProgramBinary = reinterpret_cast<GetProgramBinary>(context->getProcAddress("glGetProgramBinary"));
+        m_programParameteri = reinterpret_cast<ProgramParameteri>(context->getProcAddress("glProgramParameteri"));
+    }
+
+    QOpenGLFunctions *funcs = context->functions();
+    GLint formats = 0;
+    if (m_programBinary && m_getProgramBinary)
+        funcs->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        m_programBinary = 0;
+        m_getProgramBinary = 0;
+        m_programParameteri = 0;
+        return;
+    }
+
+    // Binaries are only valid for the driver that produced them.
+    m_driver = QByteArray(reinterpret_cast<const char *>(funcs->glGetString(GL_VENDOR)));
+    m_driver += '\n';
+    m_driver += reinterpret_cast<const char *>(funcs->glGetString(GL_RENDERER));
+    m_driver += '\n';
+    m_driver += reinterpret_cast<const char *>(funcs->glGetString(GL_VERSION));
+
+    const QByteArray driverHash = QCryptographicHash::hash(m_driver, QCryptographicHash::Sha1).toHex();
+    m_directory = defaultDirectory() + QLatin1Char('/') + QString::fromLatin1(driverHash.left(16));
+    qsg_pruneStaleDrivers(m_directory);
+}
+
+/*
+    Returns the cache key for a program built from \a vertexCode and
+    \a fragmentCode, with the attributes in \a attributeNames bound to their
+    index. The sources are the ones passed to the compiler, so rewritten
+    variants of a material shader get different keys.
+ */
+QByteArray QSGShaderDiskCache::key(const char *vertexCode, const char *fragmentCode,
+                                   char const *const *attributeNames) const
+{
+    if (!isEnabled())
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(qsg_shadercache_version));
+    hash.addData(m_driver);
+    hash.addData(vertexCode, int(qstrlen(vertexCode)) + 1);
+    hash.addData(fragmentCode, int(qstrlen(fragmentCode)) + 1);
+    for (int i = 0; attributeNames && attributeNames[i]; ++i)
+        hash.addData(attributeNames[i], int(qstrlen(attributeNames[i])) + 1);
+    return hash.result().toHex();
+}
+
+QString QSGShaderDiskCache::fileName(const QByteArray &key) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(key) + QLatin1String(".bin");
+}
+
+/*
+    Links \a program from the binary stored for \a key. A binary which the
+    driver does not accept is removed, the program can then still be built
+    from source.
+ */
+bool QSGShaderDiskCache::load(QOpenGLShaderProgram *program, const QByteArray &key)
+{
+    if (!isEnabled() || key.isEmpty())
+        return false;
+
+    const QString name = fileName(key);
+    QFile file(name);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = file.readAll();
+    file.close();
+
+    QSGProgramBinaryHeader header;
+    if (data.size() < int(sizeof(header))) {
+        QFile::remove(name);
+        return false;
+    }
+    memcpy(&header, data.constData(), sizeof(header));
+    const quint32 length = qFromLittleEndian(header.length);
+    if (qFromLittleEndian(header.magic) != qsg_shadercache_magic
+            || qFromLittleEndian(header.version) != qsg_shadercache_version
+            || length == 0 || quint32(data.size()) - sizeof(header) != length) {
+        QFile::remove(name);
+        return false;
+    }
+
+    if (!program->create())
+        return false;
+
+    QOpenGLFunctions *funcs = m_context->functions();
+    const GLuint id = program->programId();
+    m_programBinary(id, qFromLittleEndian(header.format), data.constData() + sizeof(header), length);
+
+    GLint linked = 0;
+    funcs->glGetProgramiv(id, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // Typically a driver update that kept the version string.
+        while (funcs->glGetError() != GL_NO_ERROR) { }
+        qCDebug(QSG_LOG_INFO, "program binary %s rejected by the driver, removing it", key.constData());
+        QFile::remove(name);
+        return false;
+    }
+
+    // Without shaders attached, link() only picks up the link status.
+    return program->link();
+}
+
+/*
+    Asks the driver to keep \a program retrievable, must be called before
+    it is linked from source.
+ */
+void QSGShaderDiskCache::prepare(QOpenGLShaderProgram *program)
+{
+    if (m_programParameteri && program->create())
+        m_programParameteri(program->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool QSGShaderDiskCache::store(QOpenGLShaderProgram *program, const QByteArray &key)
+{
+    if (!isEnabled() || key.isEmpty() || !program->isLinked())
+        return false;
+
+    QOpenGLFunctions *funcs = m_context->functions();
+    const GLuint id = program->programId();
+    GLint length = 0;
+    funcs->glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+
+    QByteArray binary(length, Qt::Uninitialized);
+    GLsizei written = 0;
+    GLenum format = 0;
+    m_getProgramBinary(id, length, &written, &format, binary.data());
+    if (written <= 0) {
+        while (funcs->glGetError() != GL_NO_ERROR) { }
+        return false;
+    }
+
+    if (!QDir().mkpath(m_directory))
+        return false;
+
+    QSGProgramBinaryHeader header;
+    header.magic = qToLittleEndian(qsg_shadercache_magic);
+    header.version = qToLittleEndian(qsg_shadercache_version);
+    header.format = qToLittleEndian(quint32(format));
+    header.length = qToLittleEndian(quint32(written));
+
+    const QString name = fileName(key);
+    QSaveFile file(name);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(binary.constData(), written);
+    if (!file.commit())
+        return false;
+
+    qsg_evictBinaries(m_directory, QFileInfo(name).fileName());
+    return true;
+}
+
+/*
+    Links \a program from the cached binary if there is one, otherwise from
+    \a vertexCode and \a fragmentCode, storing the result. Attribute
+    locations must already be bound to their index in \a attributeNames.
+ */
+bool QSGShaderDiskCache::link(QOpenGLShaderProgram *program, const char *vertexCode, const char *fragmentCode,
+                              char const *const *attributeNames)
+{
+    const QByteArray cacheKey = key(vertexCode, fragmentCode, attributeNames);
+    if (load(program, cacheKey))
+        return true;
+
+    program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode);
+    program->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentCode);
+    prepare(program);
+    if (!program->link())
+        return false;
+
+    store(program, cacheKey);
+    return true;
+}
+
+QT_END_NAMESPACE
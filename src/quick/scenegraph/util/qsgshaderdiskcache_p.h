@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSGSHADERDISKCACHE_P_H
+#define QSGSHADERDISKCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtquickglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+#include <QtGui/qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLContext;
+class QOpenGLShaderProgram;
+
+// Stores linked program binaries on disk so that later runs can skip
+// compiling and linking the shader sources. Binaries are keyed by the
+// shader sources, the attribute bindings and the GL driver, a binary the
+// driver rejects is removed from the cache. Each driver has its own
+// directory, the oldest binaries are evicted when it outgrows the size limit
+// and the directories of other drivers are removed.
+class Q_QUICK_PRIVATE_EXPORT QSGShaderDiskCache
+{
+public:
+    QSGShaderDiskCache(QOpenGLContext *context);
+
+    static QString defaultDirectory();
+
+    bool isEnabled() const { return m_programBinary != 0; }
+
+    QByteArray key(const char *vertexCode, const char *fragmentCode,
+                   char const *const *attributeNames) const;
+
+    bool load(QOpenGLShaderProgram *program, const QByteArray &key);
+    void prepare(QOpenGLShaderProgram *program);
+    bool store(QOpenGLShaderProgram *program, const QByteArray &key);
+
+    bool link(QOpenGLShaderProgram *program, const char *vertexCode, const char *fragmentCode,
+              char const *const *attributeNames);
+
+private:
+    typedef void (QOPENGLF_APIENTRYP ProgramBinary)(GLuint, GLenum, const void *, GLsizei);
+    typedef void (QOPENGLF_APIENTRYP GetProgramBinary)(GLuint, GLsizei, GLsizei *, GLenum *, void *);
+    typedef void (QOPENGLF_APIENTRYP ProgramParameteri)(GLuint, GLenum, GLint);
+
+    QString fileName(const QByteArray &key) const;
+
+    QOpenGLContext *m_context;
+    ProgramBinary m_programBinary;
+    GetProgramBinary m_getProgramBinary;
+    ProgramParameteri m_programParameteri;
+    QByteArray m_driver;
+    QString m_directory;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGSHADERDISKCACHE_P_H
@@ -37,11 +37,16 @@
 #include <qthread.h>
 #include <qmath.h>
 #include <private/qquickprofiler_p.h>
+#include <private/qquickworkerpool_p.h>
 #include <private/qqmlglobal_p.h>
 #include <QtGui/qguiapplication.h>
 #include <QtGui/qpa/qplatformnativeinterface.h>
 #include <QtGui/qopenglcontext.h>
 #include <QtGui/qopenglfunctions.h>
+#include <QtGui/qopenglextrafunctions.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
 
 #include <private/qsgmaterialshader_p.h>
 
@@ -73,9 +78,23 @@ static const bool qsg_leak_check = !qEnvironmentVariableIsEmpty("QML_LEAK_CHECK"
 #define GL_BGRA 0x80E1
 #endif
 
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+
 
 QT_BEGIN_NAMESPACE
 
+int qt_sg_envInt(const char *name, int defaultValue);
+
 inline static bool isPowerOfTwo(int x)
 {
     // Assumption: x >= 1
@@ -556,12 +575,14 @@ QSGPlainTexture::QSGPlainTexture()
     , m_owns_texture(true)
     , m_mipmaps_generated(false)
     , m_retain_image(false)
+    , m_async_upload(false)
 {
 }
 
 
 QSGPlainTexture::~QSGPlainTexture()
 {
+    cancelAsynchronousUpload();
     if (m_texture_id && m_owns_texture && QOpenGLContext::currentContext())
         QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_texture_id);
 }
@@ -577,6 +598,294 @@ void qsg_swizzleBGRAToRGBA(QImage *image)
     }
 }
 
+/*
+    Picks the pixel format used to upload ARGB32 image data. When BGRA is not
+    supported, the data has to be swizzled to RGBA before uploading.
+ */
+static void qsg_textureUploadFormats(QOpenGLContext *context, GLenum *externalFormat, GLenum *internalFormat)
+{
+    *externalFormat = GL_RGBA;
+    *internalFormat = GL_RGBA;
+
+#if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_NO_SDK)
+    QString *deviceName =
+            static_cast<QString *>(QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("AndroidDeviceName"));
+    static bool wrongfullyReportsBgra8888Support = deviceName != 0
+                                                    && (deviceName->compare(QStringLiteral("samsung SM-T211"), Qt::CaseInsensitive) == 0
+                                                        || deviceName->compare(QStringLiteral("samsung SM-T210"), Qt::CaseInsensitive) == 0
+                                                        || deviceName->compare(QStringLiteral("samsung SM-T215"), Qt::CaseInsensitive) == 0);
+#else
+    static bool wrongfullyReportsBgra8888Support = false;
+#endif
+
+    if (context->hasExtension(QByteArrayLiteral("GL_EXT_bgra"))) {
+        *externalFormat = GL_BGRA;
+#ifdef QT_OPENGL_ES
+        *internalFormat = GL_BGRA;
+#else
+        if (context->isOpenGLES())
+            *internalFormat = GL_BGRA;
+#endif // QT_OPENGL_ES
+    } else if (!wrongfullyReportsBgra8888Support
+               && (context->hasExtension(QByteArrayLiteral("GL_EXT_texture_format_BGRA8888"))
+                   || context->hasExtension(QByteArrayLiteral("GL_IMG_texture_format_BGRA8888")))) {
+        *externalFormat = GL_BGRA;
+        *internalFormat = GL_BGRA;
+#ifdef Q_OS_IOS
+    } else if (context->hasExtension(QByteArrayLiteral("GL_APPLE_texture_format_BGRA8888"))) {
+        *externalFormat = GL_BGRA;
+        *internalFormat = GL_RGBA;
+#endif
+    }
+}
+
+/*
+    An image that is converted on a worker thread and written into a mapped
+    pixel buffer object, so that the render thread only has to start the
+    transfer. The texture and the job each hold a reference, so either can
+    let go of it first.
+ */
+class QSGTextureUpload
+{
+public:
+    enum State {
+        Queued,
+        Running,
+        Done,
+        Cancelled
+    };
+
+    QSGTextureUpload(QSGPlainTexture *texture, const QImage &image, const QSize &size,
+                     GLenum externalFormat, GLenum internalFormat, GLuint pbo, uchar *data)
+        : texture(texture)
+        , image(image)
+        , size(size)
+        , externalFormat(externalFormat)
+        , internalFormat(internalFormat)
+        , pbo(pbo)
+        , data(data)
+        , state(Queued)
+        , job(0)
+    {
+    }
+
+    QImage convertedImage() const
+    {
+        QImage tmp = (image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32_Premultiplied)
+                     ? image
+                     : image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        if (tmp.size() != size)
+            tmp = tmp.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        return tmp;
+    }
+
+    bool isDone() const { return state.loadAcquire() == Done; }
+
+    QSGPlainTexture *texture;
+    QImage image;
+    QSize size;
+    GLenum externalFormat;
+    GLenum internalFormat;
+    GLuint pbo;
+    uchar *data;
+    QAtomicInt state;
+    // Released when the job no longer refers to the texture.
+    QSemaphore finished;
+    // Released when the texture no longer refers to the cancelled job.
+    QSemaphore cancelled;
+    QRunnable *job;
+};
+
+class QSGTextureUploadJob : public QRunnable
+{
+public:
+    explicit QSGTextureUploadJob(const QSharedPointer<QSGTextureUpload> &upload)
+        : upload(upload)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        if (!upload->state.testAndSetOrdered(QSGTextureUpload::Queued, QSGTextureUpload::Running)) {
+            // The texture still refers to the job until it is out of the pool.
+            upload->cancelled.acquire();
+            return;
+        }
+
+        const QImage tmp = upload->convertedImage();
+        const QSize size = upload->size;
+        const int bytesPerLine = size.width() * 4;
+        for (int y = 0; y < size.height(); ++y)
+            memcpy(upload->data + y * bytesPerLine, tmp.constScanLine(y), bytesPerLine);
+        if (upload->externalFormat != GL_BGRA) {
+            QImage target(upload->data, size.width(), size.height(), bytesPerLine, tmp.format());
+            qsg_swizzleBGRAToRGBA(&target);
+        }
+
+        // The upload is done before the texture is told, so that the frame
+        // the signal asks for can show the image. The texture is not
+        // destroyed before the job is finished.
+        QSGPlainTexture *texture = upload->texture;
+        upload->state.storeRelease(QSGTextureUpload::Done);
+        emit texture->asynchronousUploadReady();
+        upload->finished.release();
+    }
+
+private:
+    QSharedPointer<QSGTextureUpload> upload;
+};
+
+static bool qsg_canUploadAsynchronously(QOpenGLContext *context, const QImage &image)
+{
+    static const int threshold = qt_sg_envInt("QSG_ASYNC_TEXTURE_UPLOAD_THRESHOLD", 256 * 1024);
+    if (threshold <= 0 || qint64(image.width()) * image.height() * 4 < threshold)
+        return false;
+
+    // Mapping pixel buffer objects needs glMapBufferRange
+    return context->isOpenGLES()
+            ? context->format().majorVersion() >= 3
+            : context->format().version() >= qMakePair(3, 0);
+}
+
+/*
+    Starts converting the image on a worker thread into a pixel buffer object.
+    Until it is done, the texture contains a single transparent pixel.
+ */
+bool QSGPlainTexture::startAsynchronousUpload(QOpenGLContext *context)
+{
+    if (!qsg_canUploadAsynchronously(context, m_image))
+        return false;
+
+    QOpenGLFunctions *funcs = context->functions();
+    QOpenGLExtraFunctions *extraFuncs = context->extraFunctions();
+
+    int max;
+    if (QSGRenderContext *rc = QSGRenderContext::from(context))
+        max = rc->maxTextureSize();
+    else
+        funcs->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max);
+    QSize size = m_image.size().boundedTo(QSize(max, max));
+    if (mipmapFiltering() != QSGTexture::None
+        && (!isPowerOfTwo(size.width()) || !isPowerOfTwo(size.height()))
+        && !funcs->hasOpenGLFeature(QOpenGLFunctions::NPOTTextures)) {
+        size = QSize(qNextPowerOfTwo(size.width()), qNextPowerOfTwo(size.height()));
+    }
+
+    GLenum externalFormat;
+    GLenum internalFormat;
+    qsg_textureUploadFormats(context, &externalFormat, &internalFormat);
+
+    const int byteCount = size.width() * size.height() * 4;
+    GLuint pbo = 0;
+    funcs->glGenBuffers(1, &pbo);
+    funcs->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    funcs->glBufferData(GL_PIXEL_UNPACK_BUFFER, byteCount, 0, GL_STREAM_DRAW);
+    uchar *data = static_cast<uchar *>(extraFuncs->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, byteCount,
+                                                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    funcs->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!data) {
+        funcs->glDeleteBuffers(1, &pbo);
+        return false;
+    }
+
+    const quint32 transparent = 0;
+    funcs->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &transparent);
+    updateBindOptions(m_dirty_bind_options);
+    m_dirty_bind_options = false;
+    m_mipmaps_generated = false;
+
+    m_upload = QSharedPointer<QSGTextureUpload>(new QSGTextureUpload(this, m_image, size, externalFormat,
+                                                                     internalFormat, pbo, data));
+    m_upload->job = new QSGTextureUploadJob(m_upload);
+    qquick_workerPool()->start(m_upload->job);
+
+    m_texture_size = size;
+    m_texture_rect = QRectF(0, 0, 1, 1);
+    if (!m_retain_image)
+        m_image = QImage();
+    return true;
+}
+
+/*
+    Transfers the converted image from the pixel buffer object into the
+    texture, which is left bound.
+ */
+void QSGPlainTexture::finishAsynchronousUpload(QOpenGLContext *context)
+{
+    Q_ASSERT(m_upload && m_upload->isDone());
+    m_upload->finished.acquire();
+
+    QOpenGLFunctions *funcs = context->functions();
+    funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    funcs->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_upload->pbo);
+    const bool intact = context->extraFunctions()->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    if (intact) {
+        funcs->glTexImage2D(GL_TEXTURE_2D, 0, m_upload->internalFormat, m_upload->size.width(), m_upload->size.height(),
+                            0, m_upload->externalFormat, GL_UNSIGNED_BYTE, 0);
+    }
+    funcs->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    funcs->glDeleteBuffers(1, &m_upload->pbo);
+
+    if (!intact) {
+        // The buffer contents were lost while it was mapped, upload directly.
+        QImage tmp = m_upload->convertedImage();
+        if (m_upload->externalFormat != GL_BGRA)
+            qsg_swizzleBGRAToRGBA(&tmp);
+        if (tmp.width() * 4 != tmp.bytesPerLine())
+            tmp = tmp.copy();
+        funcs->glTexImage2D(GL_TEXTURE_2D, 0, m_upload->internalFormat, tmp.width(), tmp.height(),
+                            0, m_upload->externalFormat, GL_UNSIGNED_BYTE, tmp.constBits());
+    }
+
+    if (mipmapFiltering() != QSGTexture::None) {
+        funcs->glGenerateMipmap(GL_TEXTURE_2D);
+        m_mipmaps_generated = true;
+    }
+
+    qCDebug(QSG_LOG_TIME_TEXTURE, "plain texture uploaded asynchronously (%dx%d)%s",
+            m_texture_size.width(), m_texture_size.height(), intact ? "" : " (buffer lost, uploaded directly)");
+
+    m_upload.clear();
+}
+
+/*
+    Drops the upload. A job that has not started yet is taken out of the
+    worker pool, only one that is running is waited for.
+ */
+void QSGPlainTexture::cancelAsynchronousUpload()
+{
+    if (!m_upload)
+        return;
+
+    if (m_upload->state.testAndSetOrdered(QSGTextureUpload::Queued, QSGTextureUpload::Cancelled)) {
+        // A worker that took the job already waits for it to be released.
+        qquick_workerPool()->cancel(m_upload->job);
+        m_upload->cancelled.release();
+    } else {
+        m_upload->finished.acquire();
+    }
+
+    if (QOpenGLContext *context = QOpenGLContext::currentContext()) {
+        QOpenGLFunctions *funcs = context->functions();
+        funcs->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_upload->pbo);
+        context->extraFunctions()->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        funcs->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        funcs->glDeleteBuffers(1, &m_upload->pbo);
+    }
+    m_upload.clear();
+}
+
+/*
+    Uploads the image, or starts uploading it asynchronously, unless that has
+    been done already. Returns true once the texture contains the image.
+ */
+bool QSGPlainTexture::prepareTexture()
+{
+    if (m_dirty_texture)
+        bind();
+    return !m_upload || m_upload->isDone();
+}
+
 void QSGPlainTexture::setImage(const QImage &image)
 {
     m_image = image;
@@ -605,6 +914,7 @@ int QSGPlainTexture::textureId() const
 
 void QSGPlainTexture::setTextureId(int id)
 {
+    cancelAsynchronousUpload();
     if (m_texture_id && m_owns_texture)
         QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_texture_id);
 
@@ -619,6 +929,16 @@ void QSGPlainTexture::bind()
 {
     QOpenGLContext *context = QOpenGLContext::currentContext();
     QOpenGLFunctions *funcs = context->functions();
+    if (m_upload && !m_dirty_texture) {
+        if (m_upload->isDone())
+            finishAsynchronousUpload(context);
+        else
+            funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
+        updateBindOptions(m_dirty_bind_options);
+        m_dirty_bind_options = false;
+        return;
+    }
+
     if (!m_dirty_texture) {
         funcs->glBindTexture(GL_TEXTURE_2D, m_texture_id);
         if (mipmapFiltering() != QSGTexture::None && !m_mipmaps_generated) {
@@ -631,6 +951,7 @@ void QSGPlainTexture::bind()
     }
 
     m_dirty_texture = false;
+    cancelAsynchronousUpload();
 
     bool profileFrames = QSG_LOG_TIME_TEXTURE().isDebugEnabled();
     if (profileFrames)
@@ -664,6 +985,11 @@ void QSGPlainTexture::bind()
         bindTime = qsg_renderer_timer.nsecsElapsed();
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphTexturePrepare);
 
+    if (m_async_upload && startAsynchronousUpload(context)) {
+        Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphTexturePrepare);
+        return;
+    }
+
     // ### TODO: check for out-of-memory situations...
 
     QImage tmp = (m_image.format() == QImage::Format_RGB32 || m_image.format() == QImage::Format_ARGB32_Premultiplied)
@@ -709,39 +1035,9 @@ void QSGPlainTexture::bind()
 
     GLenum externalFormat = GL_RGBA;
     GLenum internalFormat = GL_RGBA;
-
-#if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_NO_SDK)
-    QString *deviceName =
-            static_cast<QString *>(QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("AndroidDeviceName"));
-    static bool wrongfullyReportsBgra8888Support = deviceName != 0
-                                                    && (deviceName->compare(QStringLiteral("samsung SM-T211"), Qt::CaseInsensitive) == 0
-                                                        || deviceName->compare(QStringLiteral("samsung SM-T210"), Qt::CaseInsensitive) == 0
-                                                        || deviceName->compare(QStringLiteral("samsung SM-T215"), Qt::CaseInsensitive) == 0);
-#else
-    static bool wrongfullyReportsBgra8888Support = false;
-#endif
-
-    if (context->hasExtension(QByteArrayLiteral("GL_EXT_bgra"))) {
-        externalFormat = GL_BGRA;
-#ifdef QT_OPENGL_ES
-        internalFormat = GL_BGRA;
-#else
-        if (context->isOpenGLES())
-            internalFormat = GL_BGRA;
-#endif // QT_OPENGL_ES
-    } else if (!wrongfullyReportsBgra8888Support
-               && (context->hasExtension(QByteArrayLiteral("GL_EXT_texture_format_BGRA8888"))
-                   || context->hasExtension(QByteArrayLiteral("GL_IMG_texture_format_BGRA8888")))) {
-        externalFormat = GL_BGRA;
-        internalFormat = GL_BGRA;
-#ifdef Q_OS_IOS
-    } else if (context->hasExtension(QByteArrayLiteral("GL_APPLE_texture_format_BGRA8888"))) {
-        externalFormat = GL_BGRA;
-        internalFormat = GL_RGBA;
-#endif
-    } else {
+    qsg_textureUploadFormats(context, &externalFormat, &internalFormat);
+    if (externalFormat != GL_BGRA)
         qsg_swizzleBGRAToRGBA(&tmp);
-    }
 
     qint64 swizzleTime = 0;
     if (profileFrames)
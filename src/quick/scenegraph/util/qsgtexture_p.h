@@ -48,6 +48,7 @@
 #include <QtQuick/qtquickglobal.h>
 #include <private/qobject_p.h>
 
+#include <QtCore/qsharedpointer.h>
 #include <QtGui/qopengl.h>
 
 #include "qsgtexture.h"
@@ -70,6 +71,8 @@ public:
     uint filterMode : 2;
 };
 
+class QSGTextureUpload;
+
 class Q_QUICK_PRIVATE_EXPORT QSGPlainTexture : public QSGTexture
 {
     Q_OBJECT
@@ -90,6 +93,11 @@ public:
 
     bool hasMipmaps() const { return mipmapFiltering() != QSGTexture::None; }
 
+    void setAsynchronousUpload(bool async) { m_async_upload = async; }
+    bool asynchronousUpload() const { return m_async_upload; }
+    bool isUploadPending() const { return !m_upload.isNull(); }
+    bool prepareTexture();
+
     void setImage(const QImage &image);
     const QImage &image() { return m_image; }
 
@@ -101,7 +109,14 @@ public:
         return t;
     }
 
+Q_SIGNALS:
+    void asynchronousUploadReady();
+
 protected:
+    bool startAsynchronousUpload(QOpenGLContext *context);
+    void finishAsynchronousUpload(QOpenGLContext *context);
+    void cancelAsynchronousUpload();
+
     QImage m_image;
 
     GLuint m_texture_id;
@@ -114,6 +129,9 @@ protected:
     uint m_owns_texture : 1;
     uint m_mipmaps_generated : 1;
     uint m_retain_image: 1;
+    uint m_async_upload : 1;
+
+    QSharedPointer<QSGTextureUpload> m_upload;
 };
 
 Q_QUICK_PRIVATE_EXPORT bool qsg_safeguard_texture(QSGTexture *);
@@ -44,15 +44,21 @@
 #include <qpa/qplatformintegration.h>
 
 #include <QtQuick/private/qsgtexture_p.h>
+#include <QtQuick/private/qsgcompressedtexture_p.h>
+#include <QtQuick/private/qquickworkerpool_p.h>
 
 #include <QQuickWindow>
 #include <QCoreApplication>
 #include <QImageReader>
 #include <QHash>
+#include <QCache>
 #include <QNetworkReply>
 #include <QPixmapCache>
 #include <QFile>
 #include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSet>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QWaitCondition>
@@ -66,8 +72,11 @@
 
 #include <private/qquickprofiler_p.h>
 
+#include <QtCore/private/qsimd_p.h>
+
 #define IMAGEREQUEST_MAX_NETWORK_REQUEST_COUNT 8
 #define IMAGEREQUEST_MAX_REDIRECT_RECURSION 16
+#define IMAGEREQUEST_MAX_DECODE_THREAD_COUNT 4
 #define CACHE_EXPIRE_TIME 30
 #define CACHE_REMOVAL_FRACTION 4
 
@@ -80,8 +89,59 @@ QT_BEGIN_NAMESPACE
 static const bool qsg_leak_check = !qEnvironmentVariableIsEmpty("QML_LEAK_CHECK");
 #endif
 
-// The cache limit describes the maximum "junk" in the cache.
-static int cache_limit = 2048 * 1024; // 2048 KB cache limit for embedded in qpixmapcache.cpp
+// The cache limits describe the maximum "junk" in the cache, in KB. Unreferenced pixmaps
+// are limited by both the decoded image memory and the texture memory they keep alive.
+#define CACHE_IMAGE_LIMIT 2048 // as for embedded in qpixmapcache.cpp
+#define CACHE_TEXTURE_LIMIT 4096
+#define CACHE_ORIGINALS_LIMIT 2048
+
+static int cacheLimit(const char *name, int defaultLimit)
+{
+    bool ok = false;
+    int limit = qEnvironmentVariableIntValue(name, &ok);
+    if (!ok || limit < 0)
+        limit = defaultLimit;
+    return limit * 1024;
+}
+
+// The second tier of the cache: the encoded data of images downloaded from
+// the network, so that pixmaps evicted from the store can be decoded again
+// without another download. Accessed from the reader threads.
+class QQuickPixmapOriginals
+{
+public:
+    QQuickPixmapOriginals()
+    {
+        cache.setMaxCost(cacheLimit("QML_PIXMAP_CACHE_ORIGINALS_LIMIT", CACHE_ORIGINALS_LIMIT));
+    }
+
+    bool find(const QUrl &url, QByteArray *data)
+    {
+        QMutexLocker locker(&mutex);
+        if (QByteArray *original = cache.object(url)) {
+            *data = *original;
+            return true;
+        }
+        return false;
+    }
+
+    void insert(const QUrl &url, const QByteArray &data)
+    {
+        QMutexLocker locker(&mutex);
+        cache.insert(url, new QByteArray(data), data.size());
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&mutex);
+        cache.clear();
+    }
+
+private:
+    QMutex mutex;
+    QCache<QUrl, QByteArray> cache;
+};
+Q_GLOBAL_STATIC(QQuickPixmapOriginals, pixmapOriginals)
 
 static inline QString imageProviderId(const QUrl &url)
 {
@@ -127,12 +187,15 @@ public:
 
     QQuickPixmapData *data;
     QQmlEngine *engineForReader; // always access reader inside readerMutex
+    QRect requestRegion;
     QSize requestSize;
     QUrl url;
 
     bool loading;
     AutoTransform autoTransform;
     int redirectCount;
+    bool cache;
+    QQuickPixmap::LoadPriority priority; // always access inside the reader's mutex
 
     class Event : public QEvent {
     public:
@@ -176,6 +239,24 @@ private:
     QQuickPixmapReader *reader;
 };
 
+class QQuickPixmapDecodeJob : public QRunnable
+{
+public:
+    QQuickPixmapDecodeJob(QQuickPixmapReader *, QQuickPixmapReply *, const QUrl &, const QString &,
+                          const QByteArray &, AutoTransform);
+    void run();
+
+private:
+    QQuickPixmapReader *reader;
+    QQuickPixmapReply *reply;
+    QUrl url;
+    QString localFile;
+    QByteArray data;
+    QRect requestRegion;
+    QSize requestSize;
+    AutoTransform autoTransform;
+};
+
 class QQuickPixmapData;
 class QQuickPixmapReader : public QThread
 {
@@ -186,6 +267,7 @@ public:
 
     QQuickPixmapReply *getImage(QQuickPixmapData *);
     void cancel(QQuickPixmapReply *rep);
+    void setPriority(QQuickPixmapReply *rep, QQuickPixmap::LoadPriority priority);
 
     static QQuickPixmapReader *instance(QQmlEngine *engine);
     static QQuickPixmapReader *existingInstance(QQmlEngine *engine);
@@ -195,8 +277,12 @@ protected:
 
 private:
     friend class QQuickPixmapReaderThreadObject;
+    friend class QQuickPixmapDecodeJob;
     void processJobs();
     void processJob(QQuickPixmapReply *, const QUrl &, const QString &, AutoTransform, QQuickImageProvider::ImageType, QQuickImageProvider *);
+    void decodeImage(QQuickPixmapReply *, const QUrl &, const QString &, const QByteArray &, AutoTransform);
+    void decodeFinished(QQuickPixmapReply *, QQuickPixmapReply::ReadError, const QString &, const QSize &,
+                        AutoTransform, QQuickTextureFactory *);
     void networkRequestDone(QNetworkReply *);
     void asyncResponseFinished(QQuickImageResponse *);
 
@@ -215,6 +301,20 @@ private:
     QHash<QNetworkReply*,QQuickPixmapReply*> networkJobs;
     QHash<QQuickImageResponse*,QQuickPixmapReply*> asyncResponses;
 
+    // Replies currently referenced by a decoder thread. They stay alive until
+    // decodeFinished() even if they get cancelled in the meantime.
+    QSet<QQuickPixmapReply*> decodingJobs;
+    QWaitCondition decodingDone;
+    int maxDecodingJobs;
+
+    // Downloaded images waiting for a free decoder
+    struct DownloadedJob {
+        QQuickPixmapReply *job;
+        QUrl url;
+        QByteArray data;
+    };
+    QList<DownloadedJob> downloadedJobs;
+
     static int replyDownloadProgress;
     static int replyFinished;
     static int downloadProgress;
@@ -280,6 +380,7 @@ public:
     }
 
     int cost() const;
+    int imageCost() const;
     void addref();
     void release();
     void addToCache();
@@ -293,6 +394,7 @@ public:
     QUrl url;
     QString errorString;
     QSize implicitSize;
+    QRect requestRegion;
     QSize requestSize;
     AutoTransform requestedTransform;
     AutoTransform appliedTransform;
@@ -369,8 +471,92 @@ static void maybeRemoveAlpha(QImage *image)
     }
 }
 
+// KTX and PKM files hold data the GPU takes as it is, they are neither
+// decoded nor scaled to the requested size.
+template <typename Source>
+static QQuickTextureFactory *readTextureFile(const QUrl &url, const Source &source, QString *errorString,
+                                             QSize *impsize)
+{
+    QString error;
+    QQuickTextureFactory *factory = QSGCompressedTextureFactory::create(source, &error);
+    if (factory) {
+        if (impsize)
+            *impsize = factory->textureSize();
+    } else if (errorString) {
+        *errorString = QQuickPixmap::tr("Error decoding: %1: %2").arg(url.toString()).arg(error);
+    }
+    return factory;
+}
+
+// Averages each 2x2 block of a 32-bit image into one pixel. The channels are
+// averaged vertically and then horizontally, rounding up each time, the same way
+// in the vectorized and the plain loops.
+static inline quint32 averagePixels(quint32 a, quint32 b)
+{
+    return (a | b) - (((a ^ b) & 0xfefefefe) >> 1);
+}
+
+static QImage halveImage(const QImage &src)
+{
+    QImage dst(src.width() / 2, src.height() / 2, src.format());
+    const int width = dst.width();
+    for (int y = 0; y < dst.height(); ++y) {
+        const quint32 *a = reinterpret_cast<const quint32 *>(src.constScanLine(2 * y));
+        const quint32 *b = reinterpret_cast<const quint32 *>(src.constScanLine(2 * y + 1));
+        quint32 *d = reinterpret_cast<quint32 *>(dst.scanLine(y));
+        int x = 0;
+#if defined(__SSE2__)
+        for (; x + 4 <= width; x += 4) {
+            const __m128i r0 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + 2 * x)),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + 2 * x)));
+            const __m128i r1 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + 2 * x + 4)),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + 2 * x + 4)));
+            const __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(r0), _mm_castsi128_ps(r1), _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(r0), _mm_castsi128_ps(r1), _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d + x),
+                             _mm_avg_epu8(_mm_castps_si128(even), _mm_castps_si128(odd)));
+        }
+#elif defined(__ARM_NEON__)
+        for (; x + 4 <= width; x += 4) {
+            const uint8x16_t r0 = vrhaddq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(a + 2 * x)),
+                                             vld1q_u8(reinterpret_cast<const uint8_t *>(b + 2 * x)));
+            const uint8x16_t r1 = vrhaddq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(a + 2 * x + 4)),
+                                             vld1q_u8(reinterpret_cast<const uint8_t *>(b + 2 * x + 4)));
+            const uint32x4x2_t pixels = vuzpq_u32(vreinterpretq_u32_u8(r0), vreinterpretq_u32_u8(r1));
+            vst1q_u8(reinterpret_cast<uint8_t *>(d + x),
+                     vrhaddq_u8(vreinterpretq_u8_u32(pixels.val[0]), vreinterpretq_u8_u32(pixels.val[1])));
+        }
+#endif
+        for (; x < width; ++x) {
+            d[x] = averagePixels(averagePixels(a[2 * x], b[2 * x]),
+                                 averagePixels(a[2 * x + 1], b[2 * x + 1]));
+        }
+    }
+    return dst;
+}
+
+// Used for decoders that cannot scale while decoding. Box filtering by powers of
+// two leaves only a small ratio for the smooth transformation, which is slow
+// for large ratios.
+static QImage downscaleImage(const QImage &src, const QSize &size)
+{
+    QImage image = src;
+    if (image.width() >= 2 * size.width() && image.height() >= 2 * size.height()) {
+        // Averaging needs premultiplied channels
+        const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                              : QImage::Format_RGB32;
+        if (image.format() != format)
+            image = image.convertToFormat(format);
+        while (image.width() >= 2 * size.width() && image.height() >= 2 * size.height())
+            image = halveImage(image);
+    }
+    if (image.size() != size)
+        image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    return image;
+}
+
 static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *errorString, QSize *impsize,
-                      const QSize &requestSize, AutoTransform &autoTransform)
+                      const QRect &requestRegion, const QSize &requestSize, AutoTransform &autoTransform)
 {
     QImageReader imgio(dev);
     if (autoTransform != UsePluginDefault)
@@ -380,8 +566,25 @@ static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *e
 
     const bool force_scale = imgio.format() == "svg" || imgio.format() == "svgz";
 
+    // Only decode the requested region, decoders that support it skip the rest
+    QSize sourceSize = imgio.size();
+    if (requestRegion.isValid()) {
+        QRect region = requestRegion;
+        if (sourceSize.isValid())
+            region &= QRect(QPoint(0, 0), sourceSize);
+        if (region.isEmpty()) {
+            if (errorString)
+                *errorString = QQuickPixmap::tr("Error decoding: %1: %2").arg(url.toString())
+                                    .arg(QQuickPixmap::tr("Requested region is outside of the image"));
+            return false;
+        }
+        imgio.setClipRect(region);
+        sourceSize = region.size();
+    }
+
+    QSize scaledSize;
     if (requestSize.width() > 0 || requestSize.height() > 0) {
-        QSize s = imgio.size();
+        QSize s = sourceSize;
         qreal ratio = 0.0;
         if (requestSize.width() && (force_scale || requestSize.width() < s.width())) {
             ratio = qreal(requestSize.width())/s.width();
@@ -394,14 +597,27 @@ static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *e
         if (ratio > 0.0) {
             s.setHeight(qRound(s.height() * ratio));
             s.setWidth(qRound(s.width() * ratio));
-            imgio.setScaledSize(s);
+            scaledSize = s;
         }
     }
 
+    // Decoders that support it scale while decoding, JPEG for instance through
+    // DCT scaling. For the others the image is scaled after decoding.
+    const bool scaleAfterDecoding = scaledSize.isValid() && !force_scale
+            && !imgio.supportsOption(QImageIOHandler::ScaledSize);
+    if (scaledSize.isValid() && !scaleAfterDecoding)
+        imgio.setScaledSize(scaledSize);
+
     if (impsize)
-        *impsize = imgio.size();
+        *impsize = sourceSize;
 
     if (imgio.read(image)) {
+        if (scaleAfterDecoding) {
+            // the reader has already applied the transformation
+            if (imgio.autoTransform() && (imgio.transformation() & QImageIOHandler::TransformationRotate90))
+                scaledSize.transpose();
+            *image = downscaleImage(*image, scaledSize);
+        }
         maybeRemoveAlpha(image);
         if (impsize && impsize->width() < 0)
             *impsize = image->size();
@@ -420,6 +636,16 @@ QQuickPixmapReader::QQuickPixmapReader(QQmlEngine *eng)
     eventLoopQuitHack = new QObject;
     eventLoopQuitHack->moveToThread(this);
     connect(eventLoopQuitHack, SIGNAL(destroyed(QObject*)), SLOT(quit()), Qt::DirectConnection);
+
+    // Network access and image providers are serviced by the reader thread,
+    // while local files and downloaded data are decoded in parallel.
+    // The decoders run on the shared worker pool, so more decoders than the
+    // pool has threads would only queue up there, out of priority order.
+    maxDecodingJobs = qEnvironmentVariableIntValue("QML_PIXMAP_DECODE_THREADS");
+    if (maxDecodingJobs <= 0)
+        maxDecodingJobs = qBound(1, QThread::idealThreadCount() - 1, IMAGEREQUEST_MAX_DECODE_THREAD_COUNT);
+    maxDecodingJobs = qMin(maxDecodingJobs, qquick_workerPool()->maxThreadCount());
+
     start(QThread::LowestPriority);
 }
 
@@ -437,7 +663,9 @@ QQuickPixmapReader::~QQuickPixmapReader()
         delete reply;
     }
     jobs.clear();
-    QList<QQuickPixmapReply*> activeJobs = networkJobs.values() + asyncResponses.values();
+    QList<QQuickPixmapReply*> activeJobs = networkJobs.values() + asyncResponses.values() + decodingJobs.toList();
+    for (int i = 0; i < downloadedJobs.count(); ++i)
+        activeJobs.append(downloadedJobs.at(i).job);
     foreach (QQuickPixmapReply *reply, activeJobs ) {
         if (reply->loading) {
             cancelled.append(reply);
@@ -445,6 +673,10 @@ QQuickPixmapReader::~QQuickPixmapReader()
         }
     }
     if (threadObject) threadObject->processJobs();
+
+    // the decoder threads still reference this reader
+    while (!decodingJobs.isEmpty())
+        decodingDone.wait(&mutex);
     mutex.unlock();
 
     eventLoopQuitHack->deleteLater();
@@ -475,25 +707,24 @@ void QQuickPixmapReader::networkRequestDone(QNetworkReply *reply)
             }
         }
 
-        QImage image;
-        QQuickPixmapReply::ReadError error = QQuickPixmapReply::NoError;
-        QString errorString;
-        QSize readSize;
         if (reply->error()) {
-            error = QQuickPixmapReply::Loading;
-            errorString = reply->errorString();
+            // send completion event to the QQuickPixmapReply
+            mutex.lock();
+            if (!cancelled.contains(job))
+                job->postReply(QQuickPixmapReply::Loading, reply->errorString(), QSize(), 0);
+            mutex.unlock();
         } else {
-            QByteArray all = reply->readAll();
-            QBuffer buff(&all);
-            buff.open(QIODevice::ReadOnly);
-            if (!readImage(reply->url(), &buff, &image, &errorString, &readSize, job->requestSize, job->autoTransform))
-                error = QQuickPixmapReply::Decoding;
-       }
-        // send completion event to the QQuickPixmapReply
-        mutex.lock();
-        if (!cancelled.contains(job))
-            job->postReply(error, errorString, readSize, QQuickTextureFactory::textureFactoryForImage(image));
-        mutex.unlock();
+            DownloadedJob downloaded;
+            downloaded.job = job;
+            downloaded.url = reply->url();
+            downloaded.data = reply->readAll();
+            if (job->cache)
+                pixmapOriginals()->insert(job->url, downloaded.data);
+            // decoded by processJobs() once a decoder is available
+            mutex.lock();
+            downloadedJobs.append(downloaded);
+            mutex.unlock();
+        }
     }
     reply->deleteLater();
 
@@ -565,13 +796,22 @@ void QQuickPixmapReader::processJobs()
     QMutexLocker locker(&mutex);
 
     while (true) {
-        if (cancelled.isEmpty() && jobs.isEmpty())
-            return; // Nothing else to do
-
         // Clean cancelled jobs
         if (!cancelled.isEmpty()) {
+            QList<QQuickPixmapReply*> stillDecoding;
             for (int i = 0; i < cancelled.count(); ++i) {
                 QQuickPixmapReply *job = cancelled.at(i);
+                if (decodingJobs.contains(job)) {
+                    // cleaned up once the decoder thread is done with it
+                    stillDecoding.append(job);
+                    continue;
+                }
+                for (int j = 0; j < downloadedJobs.count(); ++j) {
+                    if (downloadedJobs.at(j).job == job) {
+                        downloadedJobs.removeAt(j);
+                        break;
+                    }
+                }
                 QNetworkReply *reply = networkJobs.key(job, 0);
                 if (reply) {
                     networkJobs.remove(reply);
@@ -591,48 +831,74 @@ void QQuickPixmapReader::processJobs()
                 // deleteLater, since not owned by this thread
                 job->deleteLater();
             }
-            cancelled.clear();
+            cancelled = stillDecoding;
         }
 
-        if (!jobs.isEmpty()) {
-            // Find a job we can use
-            bool usableJob = false;
-            for (int i = jobs.count() - 1; !usableJob && i >= 0; i--) {
-                QQuickPixmapReply *job = jobs[i];
-                const QUrl url = job->url;
-                QString localFile;
-                QQuickImageProvider::ImageType imageType = QQuickImageProvider::Invalid;
-                QQuickImageProvider *provider = 0;
-
-                if (url.scheme() == QLatin1String("image")) {
-                    provider = static_cast<QQuickImageProvider *>(engine->imageProvider(imageProviderId(url)));
-                    if (provider)
-                        imageType = provider->imageType();
-
-                    usableJob = true;
-                } else {
-                    localFile = QQmlFile::urlToLocalFileOrQrc(url);
-                    usableJob = !localFile.isEmpty() || networkJobs.count() < IMAGEREQUEST_MAX_NETWORK_REQUEST_COUNT;
-                }
+        // Downloaded images have waited the longest, so they take the next
+        // free decoder
+        const bool canDecode = decodingJobs.count() < maxDecodingJobs;
+        if (canDecode && !downloadedJobs.isEmpty()) {
+            DownloadedJob downloaded = downloadedJobs.takeFirst();
+            AutoTransform autoTransform = downloaded.job->autoTransform;
+            locker.unlock();
+            decodeImage(downloaded.job, downloaded.url, QString(), downloaded.data, autoTransform);
+            locker.relock();
+            continue;
+        }
 
+        if (jobs.isEmpty())
+            return; // Nothing else to do
 
-                if (usableJob) {
-                    jobs.removeAt(i);
+        // Find a job we can use. Higher priority requests go first, and among
+        // those the most recent one, as was the case before priorities existed.
+        int usableJob = -1;
+        for (int i = jobs.count() - 1; i >= 0; i--) {
+            QQuickPixmapReply *job = jobs.at(i);
+            if (usableJob != -1 && job->priority <= jobs.at(usableJob)->priority)
+                continue;
+
+            const QUrl &url = job->url;
+            bool usable;
+            if (url.scheme() == QLatin1String("image")) {
+                usable = true;
+            } else if (!QQmlFile::urlToLocalFileOrQrc(url).isEmpty()) {
+                usable = canDecode;
+            } else {
+                usable = networkJobs.count() < IMAGEREQUEST_MAX_NETWORK_REQUEST_COUNT;
+            }
 
-                    job->loading = true;
+            if (usable) {
+                usableJob = i;
+                if (job->priority == QQuickPixmap::HighPriority)
+                    break;
+            }
+        }
 
-                    PIXMAP_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
+        if (usableJob == -1)
+            return;
 
-                    AutoTransform autoTransform = job->autoTransform;
-                    locker.unlock();
-                    processJob(job, url, localFile, autoTransform, imageType, provider);
-                    locker.relock();
-                }
-            }
+        QQuickPixmapReply *job = jobs.takeAt(usableJob);
+        const QUrl url = job->url;
+        QString localFile;
+        QQuickImageProvider::ImageType imageType = QQuickImageProvider::Invalid;
+        QQuickImageProvider *provider = 0;
 
-            if (!usableJob)
-                return;
+        if (url.scheme() == QLatin1String("image")) {
+            provider = static_cast<QQuickImageProvider *>(engine->imageProvider(imageProviderId(url)));
+            if (provider)
+                imageType = provider->imageType();
+        } else {
+            localFile = QQmlFile::urlToLocalFileOrQrc(url);
         }
+
+        job->loading = true;
+
+        PIXMAP_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
+
+        AutoTransform autoTransform = job->autoTransform;
+        locker.unlock();
+        processJob(job, url, localFile, autoTransform, imageType, provider);
+        locker.relock();
     }
 }
 
@@ -718,24 +984,13 @@ void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &u
         }
 
     } else {
+        QByteArray original;
         if (!localFile.isEmpty()) {
-            // Image is local - load/decode immediately
-            QImage image;
-            QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
-            QString errorStr;
-            QFile f(localFile);
-            QSize readSize;
-            if (f.open(QIODevice::ReadOnly)) {
-                if (!readImage(url, &f, &image, &errorStr, &readSize, runningJob->requestSize, autoTransform))
-                    errorCode = QQuickPixmapReply::Loading;
-            } else {
-                errorStr = QQuickPixmap::tr("Cannot open: %1").arg(url.toString());
-                errorCode = QQuickPixmapReply::Loading;
-            }
-            mutex.lock();
-            if (!cancelled.contains(runningJob))
-                runningJob->postReply(errorCode, errorStr, readSize, QQuickTextureFactory::textureFactoryForImage(image));
-            mutex.unlock();
+            // Image is local - hand it to the decoder threads
+            decodeImage(runningJob, url, localFile, QByteArray(), autoTransform);
+        } else if (runningJob->cache && pixmapOriginals()->find(url, &original)) {
+            // Downloaded before, but evicted from the pixmap store since
+            decodeImage(runningJob, url, QString(), original, autoTransform);
         } else {
             // Network resource
             QNetworkRequest req(url);
@@ -750,6 +1005,91 @@ void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &u
     }
 }
 
+void QQuickPixmapReader::decodeImage(QQuickPixmapReply *runningJob, const QUrl &url, const QString &localFile,
+                                      const QByteArray &data, AutoTransform autoTransform)
+{
+    mutex.lock();
+    decodingJobs.insert(runningJob);
+    mutex.unlock();
+
+    qquick_workerPool()->start(new QQuickPixmapDecodeJob(this, runningJob, url, localFile, data, autoTransform));
+}
+
+void QQuickPixmapReader::decodeFinished(QQuickPixmapReply *job, QQuickPixmapReply::ReadError error,
+                                        const QString &errorString, const QSize &readSize,
+                                        AutoTransform autoTransform, QQuickTextureFactory *factory)
+{
+    mutex.lock();
+    decodingJobs.remove(job);
+    if (!cancelled.contains(job)) {
+        job->autoTransform = autoTransform;
+        job->postReply(error, errorString, readSize, factory);
+    } else {
+        delete factory;
+    }
+    if (decodingJobs.isEmpty())
+        decodingDone.wakeAll();
+    // a decoder thread is available again, and cancelled jobs can now be deleted
+    if (threadObject) threadObject->processJobs();
+    mutex.unlock();
+}
+
+QQuickPixmapDecodeJob::QQuickPixmapDecodeJob(QQuickPixmapReader *r, QQuickPixmapReply *job, const QUrl &u,
+                                             const QString &file, const QByteArray &d, AutoTransform transform)
+    : reader(r), reply(job), url(u), localFile(file), data(d), requestRegion(job->requestRegion),
+      requestSize(job->requestSize),
+      autoTransform(transform)
+{
+}
+
+void QQuickPixmapDecodeJob::run()
+{
+    QImage image;
+    QQuickTextureFactory *factory = 0;
+    QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
+    QString errorStr;
+    QSize readSize;
+
+    // Don't bother decoding images whose requester is already gone, which
+    // happens a lot when flicking through a view of delegates.
+    reader->mutex.lock();
+    const bool isCancelled = reader->cancelled.contains(reply);
+    reader->mutex.unlock();
+
+    if (!isCancelled) {
+        if (localFile.isEmpty()) {
+            if (QSGCompressedTextureFactory::canRead(data)) {
+                factory = readTextureFile(url, data, &errorStr, &readSize);
+                if (!factory)
+                    errorCode = QQuickPixmapReply::Decoding;
+            } else {
+                QBuffer buff(&data);
+                buff.open(QIODevice::ReadOnly);
+                if (!readImage(url, &buff, &image, &errorStr, &readSize, requestRegion, requestSize, autoTransform))
+                    errorCode = QQuickPixmapReply::Decoding;
+            }
+        } else {
+            QFile f(localFile);
+            if (f.open(QIODevice::ReadOnly)) {
+                if (QSGCompressedTextureFactory::canRead(&f)) {
+                    factory = readTextureFile(url, localFile, &errorStr, &readSize);
+                    if (!factory)
+                        errorCode = QQuickPixmapReply::Loading;
+                } else if (!readImage(url, &f, &image, &errorStr, &readSize, requestRegion, requestSize, autoTransform)) {
+                    errorCode = QQuickPixmapReply::Loading;
+                }
+            } else {
+                errorStr = QQuickPixmap::tr("Cannot open: %1").arg(url.toString());
+                errorCode = QQuickPixmapReply::Loading;
+            }
+        }
+    }
+
+    if (!factory)
+        factory = QQuickTextureFactory::textureFactoryForImage(image);
+    reader->decodeFinished(reply, errorCode, errorStr, readSize, autoTransform, factory);
+}
+
 QQuickPixmapReader *QQuickPixmapReader::instance(QQmlEngine *engine)
 {
     // XXX NOTE: must be called within readerMutex locking.
@@ -773,6 +1113,7 @@ QQuickPixmapReply *QQuickPixmapReader::getImage(QQuickPixmapData *data)
     mutex.lock();
     QQuickPixmapReply *reply = new QQuickPixmapReply(data);
     reply->engineForReader = engine;
+    reply->cache = data->inCache;
     jobs.append(reply);
     // XXX
     if (threadObject) threadObject->processJobs();
@@ -799,6 +1140,13 @@ void QQuickPixmapReader::cancel(QQuickPixmapReply *reply)
     mutex.unlock();
 }
 
+void QQuickPixmapReader::setPriority(QQuickPixmapReply *reply, QQuickPixmap::LoadPriority priority)
+{
+    mutex.lock();
+    reply->priority = priority;
+    mutex.unlock();
+}
+
 void QQuickPixmapReader::run()
 {
     if (replyDownloadProgress == -1) {
@@ -824,18 +1172,22 @@ class QQuickPixmapKey
 {
 public:
     const QUrl *url;
+    const QRect *region;
     const QSize *size;
     AutoTransform autoTransform;
 };
 
 inline bool operator==(const QQuickPixmapKey &lhs, const QQuickPixmapKey &rhs)
 {
-    return *lhs.size == *rhs.size && *lhs.url == *rhs.url && lhs.autoTransform == rhs.autoTransform;
+    return *lhs.region == *rhs.region && *lhs.size == *rhs.size && *lhs.url == *rhs.url &&
+            lhs.autoTransform == rhs.autoTransform;
 }
 
 inline uint qHash(const QQuickPixmapKey &key)
 {
-    return qHash(*key.url) ^ (key.size->width()*7) ^ (key.size->height()*17) ^ (key.autoTransform * 0x5c5c5c5c);
+    return qHash(*key.url) ^ (key.size->width()*7) ^ (key.size->height()*17) ^
+            (key.region->x()*23) ^ (key.region->y()*29) ^ (key.region->width()*31) ^ (key.region->height()*37) ^
+            (key.autoTransform * 0x5c5c5c5c);
 }
 
 class QQuickPixmapStore : public QObject
@@ -848,7 +1200,11 @@ public:
     void unreferencePixmap(QQuickPixmapData *);
     void referencePixmap(QQuickPixmapData *);
 
+    void cacheHit(QQuickPixmapData *);
+    void cacheMiss(QQuickPixmapData *);
+
     void purgeCache();
+    void trimCache();
 
 protected:
     virtual void timerEvent(QTimerEvent *);
@@ -856,6 +1212,9 @@ protected:
 public:
     QHash<QQuickPixmapKey, QQuickPixmapData *> m_cache;
 
+private slots:
+    void applicationStateChanged(Qt::ApplicationState state);
+
 private:
     void shrinkCache(int remove);
 
@@ -863,6 +1222,12 @@ private:
     QQuickPixmapData *m_lastUnreferencedPixmap;
 
     int m_unreferencedCost;
+    int m_unreferencedImageCost;
+    int m_textureLimit;
+    int m_imageLimit;
+    int m_hits;
+    int m_misses;
+    int m_evictions;
     int m_timerId;
     bool m_destroying;
 };
@@ -870,8 +1235,14 @@ Q_GLOBAL_STATIC(QQuickPixmapStore, pixmapStore);
 
 
 QQuickPixmapStore::QQuickPixmapStore()
-    : m_unreferencedPixmaps(0), m_lastUnreferencedPixmap(0), m_unreferencedCost(0), m_timerId(-1), m_destroying(false)
+    : m_unreferencedPixmaps(0), m_lastUnreferencedPixmap(0), m_unreferencedCost(0), m_unreferencedImageCost(0),
+      m_textureLimit(cacheLimit("QML_PIXMAP_CACHE_TEXTURE_LIMIT", CACHE_TEXTURE_LIMIT)),
+      m_imageLimit(cacheLimit("QML_PIXMAP_CACHE_IMAGE_LIMIT", CACHE_IMAGE_LIMIT)),
+      m_hits(0), m_misses(0), m_evictions(0), m_timerId(-1), m_destroying(false)
 {
+    if (QGuiApplication *app = qGuiApp)
+        connect(app, SIGNAL(applicationStateChanged(Qt::ApplicationState)),
+                this, SLOT(applicationStateChanged(Qt::ApplicationState)));
 }
 
 QQuickPixmapStore::~QQuickPixmapStore()
@@ -921,8 +1292,10 @@ void QQuickPixmapStore::unreferencePixmap(QQuickPixmapData *data)
 
     data->nextUnreferenced = m_unreferencedPixmaps;
     data->prevUnreferencedPtr = &m_unreferencedPixmaps;
-    if (!m_destroying) // the texture factories may have been cleaned up already.
+    if (!m_destroying) { // the texture factories may have been cleaned up already.
         m_unreferencedCost += data->cost();
+        m_unreferencedImageCost += data->imageCost();
+    }
 
     m_unreferencedPixmaps = data;
     if (m_unreferencedPixmaps->nextUnreferenced) {
@@ -933,7 +1306,7 @@ void QQuickPixmapStore::unreferencePixmap(QQuickPixmapData *data)
     if (!m_lastUnreferencedPixmap)
         m_lastUnreferencedPixmap = data;
 
-    shrinkCache(-1); // Shrink the cache in case it has become larger than cache_limit
+    shrinkCache(-1); // Shrink the cache in case it has become larger than the cache limits
 
     if (m_timerId == -1 && m_unreferencedPixmaps
             && !m_destroying && !QCoreApplication::closingDown()) {
@@ -958,11 +1331,25 @@ void QQuickPixmapStore::referencePixmap(QQuickPixmapData *data)
     data->prevUnreferenced = 0;
 
     m_unreferencedCost -= data->cost();
+    m_unreferencedImageCost -= data->imageCost();
+}
+
+void QQuickPixmapStore::cacheHit(QQuickPixmapData *data)
+{
+    ++m_hits;
+    PIXMAP_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheHit>(data->url, m_hits));
+}
+
+void QQuickPixmapStore::cacheMiss(QQuickPixmapData *data)
+{
+    ++m_misses;
+    PIXMAP_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheMiss>(data->url, m_misses));
 }
 
 void QQuickPixmapStore::shrinkCache(int remove)
 {
-    while ((remove > 0 || m_unreferencedCost > cache_limit) && m_lastUnreferencedPixmap) {
+    while ((remove > 0 || m_unreferencedCost > m_textureLimit || m_unreferencedImageCost > m_imageLimit)
+           && m_lastUnreferencedPixmap) {
         QQuickPixmapData *data = m_lastUnreferencedPixmap;
         Q_ASSERT(data->nextUnreferenced == 0);
 
@@ -974,6 +1361,9 @@ void QQuickPixmapStore::shrinkCache(int remove)
         if (!m_destroying) {
             remove -= data->cost();
             m_unreferencedCost -= data->cost();
+            m_unreferencedImageCost -= data->imageCost();
+            ++m_evictions;
+            PIXMAP_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheEviction>(data->url, m_evictions));
         }
         data->removeFromCache();
         delete data;
@@ -995,15 +1385,38 @@ void QQuickPixmapStore::timerEvent(QTimerEvent *)
 void QQuickPixmapStore::purgeCache()
 {
     shrinkCache(m_unreferencedCost);
+    pixmapOriginals()->clear();
 }
 
+void QQuickPixmapStore::trimCache()
+{
+    shrinkCache(m_unreferencedCost);
+}
+
+void QQuickPixmapStore::applicationStateChanged(Qt::ApplicationState state)
+{
+    if (state == Qt::ApplicationSuspended)
+        trimCache();
+}
+
+// Releases all images that are no longer referenced, including the encoded
+// data kept for images downloaded from the network. Meant for low memory warnings.
 void QQuickPixmap::purgeCache()
 {
     pixmapStore()->purgeCache();
 }
 
+// Releases the decoded images and textures that are no longer referenced, but keeps
+// the encoded data of downloaded images. Done automatically when the application
+// gets suspended.
+void QQuickPixmap::trimCache()
+{
+    pixmapStore()->trimCache();
+}
+
 QQuickPixmapReply::QQuickPixmapReply(QQuickPixmapData *d)
-: data(d), engineForReader(0), requestSize(d->requestSize), url(d->url), loading(false), autoTransform(d->appliedTransform), redirectCount(0)
+: data(d), engineForReader(0), requestRegion(d->requestRegion), requestSize(d->requestSize), url(d->url), loading(false), autoTransform(d->appliedTransform), redirectCount(0),
+  cache(false), priority(QQuickPixmap::NormalPriority)
 {
     if (finishedIndex == -1) {
         finishedIndex = QMetaMethod::fromSignal(&QQuickPixmapReply::finished).methodIndex();
@@ -1059,6 +1472,18 @@ int QQuickPixmapData::cost() const
     return 0;
 }
 
+// The memory held on the CPU side, which is nothing for a compressed
+// texture mapped from a file, nor for a default texture factory that let go
+// of its image after the upload.
+int QQuickPixmapData::imageCost() const
+{
+    if (!textureFactory || qobject_cast<QSGCompressedTextureFactory *>(textureFactory))
+        return 0;
+    if (QQuickDefaultTextureFactory *factory = qobject_cast<QQuickDefaultTextureFactory *>(textureFactory))
+        return factory->image().byteCount();
+    return textureFactory->textureByteCount();
+}
+
 void QQuickPixmapData::addref()
 {
     ++refCount;
@@ -1099,7 +1524,7 @@ void QQuickPixmapData::release()
 void QQuickPixmapData::addToCache()
 {
     if (!inCache) {
-        QQuickPixmapKey key = { &url, &requestSize, requestedTransform };
+        QQuickPixmapKey key = { &url, &requestRegion, &requestSize, requestedTransform };
         pixmapStore()->m_cache.insert(key, this);
         inCache = true;
         PIXMAP_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheCountChanged>(
@@ -1110,7 +1535,7 @@ void QQuickPixmapData::addToCache()
 void QQuickPixmapData::removeFromCache()
 {
     if (inCache) {
-        QQuickPixmapKey key = { &url, &requestSize, requestedTransform };
+        QQuickPixmapKey key = { &url, &requestRegion, &requestSize, requestedTransform };
         pixmapStore()->m_cache.remove(key);
         inCache = false;
         PIXMAP_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheCountChanged>(
@@ -1118,7 +1543,7 @@ void QQuickPixmapData::removeFromCache()
     }
 }
 
-static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, QQmlEngine *engine, const QUrl &url, const QSize &requestSize, AutoTransform autoTransform, bool *ok)
+static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, QQmlEngine *engine, const QUrl &url, const QRect &requestRegion, const QSize &requestSize, AutoTransform autoTransform, bool *ok)
 {
     if (url.scheme() == QLatin1String("image")) {
         QSize readSize;
@@ -1178,9 +1603,17 @@ static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, Q
     QString errorString;
 
     if (f.open(QIODevice::ReadOnly)) {
+        if (QSGCompressedTextureFactory::canRead(&f)) {
+            if (QQuickTextureFactory *factory = readTextureFile(url, localFile, &errorString, &readSize)) {
+                *ok = true;
+                return new QQuickPixmapData(declarativePixmap, url, factory, readSize, requestSize, autoTransform, autoTransform);
+            }
+            return new QQuickPixmapData(declarativePixmap, url, requestSize, autoTransform, errorString);
+        }
+
         QImage image;
         AutoTransform appliedTransform = autoTransform;
-        if (readImage(url, &f, &image, &errorString, &readSize, requestSize, appliedTransform)) {
+        if (readImage(url, &f, &image, &errorString, &readSize, requestRegion, requestSize, appliedTransform)) {
             *ok = true;
             return new QQuickPixmapData(declarativePixmap, url, QQuickTextureFactory::textureFactoryForImage(image), readSize, requestSize, autoTransform, appliedTransform);
         }
@@ -1193,6 +1626,7 @@ static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, Q
 
 struct QQuickPixmapNull {
     QUrl url;
+    QRect region;
     QSize size;
 };
 Q_GLOBAL_STATIC(QQuickPixmapNull, nullPixmap);
@@ -1281,6 +1715,14 @@ const QSize &QQuickPixmap::implicitSize() const
         return nullPixmap()->size;
 }
 
+const QRect &QQuickPixmap::requestRegion() const
+{
+    if (d)
+        return d->requestRegion;
+    else
+        return nullPixmap()->region;
+}
+
 const QSize &QQuickPixmap::requestSize() const
 {
     if (d)
@@ -1376,6 +1818,11 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
 }
 
 void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &requestSize, QQuickPixmap::Options options, AutoTransform requestAutoTransform)
+{
+    load(engine, url, QRect(), requestSize, options, requestAutoTransform);
+}
+
+void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QRect &requestRegion, const QSize &requestSize, QQuickPixmap::Options options, AutoTransform requestAutoTransform)
 {
     if (d) {
         d->declarativePixmaps.remove(this);
@@ -1383,7 +1830,7 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
         d = 0;
     }
 
-    QQuickPixmapKey key = { &url, &requestSize, requestAutoTransform };
+    QQuickPixmapKey key = { &url, &requestRegion, &requestSize, requestAutoTransform };
     QQuickPixmapStore *store = pixmapStore();
 
     QHash<QQuickPixmapKey, QQuickPixmapData *>::Iterator iter = store->m_cache.end();
@@ -1409,11 +1856,15 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
         if (!(options & QQuickPixmap::Asynchronous)) {
             bool ok = false;
             PIXMAP_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
-            d = createPixmapDataSync(this, engine, url, requestSize, requestAutoTransform, &ok);
+            d = createPixmapDataSync(this, engine, url, requestRegion, requestSize, requestAutoTransform, &ok);
+            if (d)
+                d->requestRegion = requestRegion;
             if (ok) {
                 PIXMAP_PROFILE(pixmapLoadingFinished(url, QSize(width(), height())));
-                if (options & QQuickPixmap::Cache)
+                if (options & QQuickPixmap::Cache) {
                     d->addToCache();
+                    store->cacheMiss(d);
+                }
                 return;
             }
             if (d) { // loadable, but encountered error while loading
@@ -1426,8 +1877,11 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
             return;
 
         d = new QQuickPixmapData(this, url, requestSize, requestAutoTransform, requestAutoTransform);
-        if (options & QQuickPixmap::Cache)
+        d->requestRegion = requestRegion;
+        if (options & QQuickPixmap::Cache) {
             d->addToCache();
+            store->cacheMiss(d);
+        }
 
         QQuickPixmapReader::readerMutex.lock();
         d->reply = QQuickPixmapReader::instance(engine)->getImage(d);
@@ -1436,6 +1890,7 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
         d = *iter;
         d->addref();
         d->declarativePixmaps.insert(this);
+        store->cacheHit(d);
     }
 }
 
@@ -1459,9 +1914,22 @@ void QQuickPixmap::clear(QObject *obj)
     }
 }
 
+void QQuickPixmap::setLoadPriority(LoadPriority priority)
+{
+    if (!d || !d->reply)
+        return;
+
+    QQuickPixmapReader::readerMutex.lock();
+    QQuickPixmapReader *reader = QQuickPixmapReader::existingInstance(d->reply->engineForReader);
+    if (reader)
+        reader->setPriority(d->reply, priority);
+    QQuickPixmapReader::readerMutex.unlock();
+}
+
 bool QQuickPixmap::isCached(const QUrl &url, const QSize &requestSize)
 {
-    QQuickPixmapKey key = { &url, &requestSize, UsePluginDefault };
+    const QRect requestRegion;
+    QQuickPixmapKey key = { &url, &requestRegion, &requestSize, UsePluginDefault };
     QQuickPixmapStore *store = pixmapStore();
 
     return store->m_cache.contains(key);
@@ -99,6 +99,12 @@ public:
     };
     Q_DECLARE_FLAGS(Options, Option)
 
+    enum LoadPriority {
+        LowPriority,
+        NormalPriority,
+        HighPriority
+    };
+
     bool isNull() const;
     bool isReady() const;
     bool isError() const;
@@ -108,6 +114,7 @@ public:
     QString error() const;
     const QUrl &url() const;
     const QSize &implicitSize() const;
+    const QRect &requestRegion() const;
     const QSize &requestSize() const;
     AutoTransform autoTransform() const;
     QImage image() const;
@@ -125,16 +132,20 @@ public:
     void load(QQmlEngine *, const QUrl &, const QSize &);
     void load(QQmlEngine *, const QUrl &, const QSize &, QQuickPixmap::Options options);
     void load(QQmlEngine *, const QUrl &, const QSize &, QQuickPixmap::Options options, AutoTransform autoTransform);
+    void load(QQmlEngine *, const QUrl &, const QRect &requestRegion, const QSize &, QQuickPixmap::Options options, AutoTransform autoTransform);
 
     void clear();
     void clear(QObject *);
 
+    void setLoadPriority(LoadPriority priority);
+
     bool connectFinished(QObject *, const char *);
     bool connectFinished(QObject *, int);
     bool connectDownloadProgress(QObject *, const char *);
     bool connectDownloadProgress(QObject *, int);
 
     static void purgeCache();
+    static void trimCache();
     static bool isCached(const QUrl &url, const QSize &requestSize);
 
 private:
@@ -71,6 +71,9 @@ void QQuickProfilerData::toByteArrays(QList<QByteArray> &messages) const
                     case QQuickProfiler::PixmapSizeKnown: ds << x << y; break;
                     case QQuickProfiler::PixmapReferenceCountChanged: ds << count; break;
                     case QQuickProfiler::PixmapCacheCountChanged: ds << count; break;
+                    case QQuickProfiler::PixmapCacheHit: ds << count; break;
+                    case QQuickProfiler::PixmapCacheMiss: ds << count; break;
+                    case QQuickProfiler::PixmapCacheEviction: ds << count; break;
                     default: break;
                 }
                 break;
@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qquickworkerpool_p.h"
+
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+
+QT_BEGIN_NAMESPACE
+
+// Upper bound for the default number of worker threads. The render thread
+// and the GUI thread are busy as well, so the pool does not try to use all
+// cores.
+#define QQUICK_WORKERPOOL_MAX_THREAD_COUNT 4
+
+class QQuickWorkerPool : public QThreadPool
+{
+public:
+    QQuickWorkerPool()
+    {
+        int threadCount = qEnvironmentVariableIntValue("QML_WORKER_THREADS");
+        if (threadCount <= 0)
+            threadCount = qBound(1, QThread::idealThreadCount() - 1, QQUICK_WORKERPOOL_MAX_THREAD_COUNT);
+        setMaxThreadCount(threadCount);
+    }
+};
+
+Q_GLOBAL_STATIC(QQuickWorkerPool, qquick_worker_pool)
+
+QThreadPool *qquick_workerPool()
+{
+    return qquick_worker_pool();
+}
+
+QT_END_NAMESPACE
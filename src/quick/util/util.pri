@@ -30,7 +30,8 @@ SOURCES += \
     $$PWD/qquickfontmetrics.cpp \
     $$PWD/qquicktextmetrics.cpp \
     $$PWD/qquickshortcut.cpp \
-    $$PWD/qquickvalidator.cpp
+    $$PWD/qquickvalidator.cpp \
+    $$PWD/qquickworkerpool.cpp
 
 HEADERS += \
     $$PWD/qquickapplication_p.h\
@@ -68,4 +69,5 @@ HEADERS += \
     $$PWD/qquickfontmetrics_p.h \
     $$PWD/qquicktextmetrics_p.h \
     $$PWD/qquickshortcut_p.h \
-    $$PWD/qquickvalidator_p.h
+    $$PWD/qquickvalidator_p.h \
+    $$PWD/qquickworkerpool_p.h
@@ -109,6 +109,9 @@ public:
         PixmapLoadingStarted,
         PixmapLoadingFinished,
         PixmapLoadingError,
+        PixmapCacheHit,
+        PixmapCacheMiss,
+        PixmapCacheEviction,
 
         MaximumPixmapEventType
     };
@@ -302,6 +305,12 @@ void QQmlProfilerClient::messageReceived(const QByteArray &message)
             stream >> data.animationcount;
         if (data.detailType == QQmlProfilerClient::PixmapCacheCountChanged)
             stream >> data.animationcount;
+        if (data.detailType == QQmlProfilerClient::PixmapCacheHit
+                || data.detailType == QQmlProfilerClient::PixmapCacheMiss
+                || data.detailType == QQmlProfilerClient::PixmapCacheEviction) {
+            stream >> data.animationcount;
+            QVERIFY(data.animationcount > 0);
+        }
         break;
     }
     case QQmlProfilerClient::SceneGraphFrame: {
@@ -627,6 +636,18 @@ void tst_QQmlProfilerService::pixmapCacheData()
     // cache size
     expected.detailType = QQmlProfilerClient::PixmapCacheCountChanged;
     VERIFY(MessageListPixmap, 3, expected, CheckMessageType | CheckDetailType);
+
+    // first lookup of the image
+    expected.detailType = QQmlProfilerClient::PixmapCacheMiss;
+    VERIFY(MessageListPixmap, 4, expected, CheckMessageType | CheckDetailType);
+
+    // hits, misses and evictions are running totals
+    int misses = 0;
+    foreach (const QQmlProfilerData &data, m_client->pixmapMessages) {
+        if (data.detailType == QQmlProfilerClient::PixmapCacheMiss)
+            QCOMPARE(data.animationcount, ++misses);
+    }
+    QCOMPARE(misses, 1);
 }
 
 void tst_QQmlProfilerService::scenegraphData()
@@ -0,0 +1,7 @@
+import QtQuick 2.0
+
+QtObject {
+    property date dateTimeProperty
+    property int changeCount: 0
+    onDateTimePropertyChanged: ++changeCount
+}
@@ -251,6 +251,7 @@ private slots:
     void urlProperty();
     void urlPropertyWithEncoding();
     void urlListPropertyWithEncoding();
+    void declaredDateTimeProperty();
     void dynamicString();
     void include();
     void includeRemoteSuccess();
@@ -6628,6 +6629,27 @@ void tst_qqmlecmascript::urlProperty()
     }
 }
 
+// A write which compares equal to the current value must still be stored,
+// but must not emit the change signal.
+void tst_qqmlecmascript::declaredDateTimeProperty()
+{
+    QQmlComponent component(&engine, testFileUrl("declaredDateTimeProperty.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object != 0);
+
+    const QDateTime utc(QDate(2016, 5, 12), QTime(13, 22, 1), Qt::UTC);
+    QVERIFY(object->setProperty("dateTimeProperty", utc));
+    QCOMPARE(object->property("changeCount").toInt(), 1);
+
+    const QDateTime offset = utc.toOffsetFromUtc(3600);
+    QCOMPARE(offset, utc);
+    QVERIFY(object->setProperty("dateTimeProperty", offset));
+    QCOMPARE(object->property("changeCount").toInt(), 1);
+    const QDateTime stored = object->property("dateTimeProperty").toDateTime();
+    QCOMPARE(stored.timeSpec(), Qt::OffsetFromUTC);
+    QCOMPARE(stored.offsetFromUtc(), 3600);
+}
+
 void tst_qqmlecmascript::urlPropertyWithEncoding()
 {
     {
@@ -0,0 +1,17 @@
+import Test 1.0
+import QtQuick 2.0
+
+MyTypeObject {
+    colorProperty: "red"
+    dateProperty: "1982-11-25"
+    timeProperty: "11:11:32"
+    dateTimeProperty: "2009-05-12T13:22:01"
+    pointProperty: "99,13"
+    pointFProperty: "-10.1,12.3"
+    sizeProperty: "99x13"
+    sizeFProperty: "0.1x0.2"
+    rectProperty: "9,7,100x200"
+    rectFProperty: "1000.1,-10.9,400x90.99"
+
+    objectProperty: MyTypeObject { colorProperty: "#80ff0000" }
+}
@@ -49,6 +49,8 @@
 #include <private/qqmlglobal_p.h>
 #include <private/qqmlscriptstring_p.h>
 #include <private/qqmlvmemetaobject_p.h>
+#include <private/qqmlcomponent_p.h>
+#include <private/qqmlcompiler_p.h>
 
 #include "testtypes.h"
 #include "testhttpserver.h"
@@ -102,6 +104,7 @@ private slots:
     void assignQmlComponent();
     void assignBasicTypes();
     void assignTypeExtremes();
+    void assignConvertedLiterals();
     void assignCompositeToType();
     void assignLiteralToVariant();
     void assignLiteralToVar();
@@ -696,6 +699,39 @@ void tst_qqmllanguage::assignBasicTypes()
     QCOMPARE(object->property("mirroredEnumTriggeredChange").toBool(), false);
 }
 
+// Literals assigned to value type properties are converted when the type is
+// compiled on the loader thread and only written when objects are created
+void tst_qqmllanguage::assignConvertedLiterals()
+{
+    QQmlComponent component(&engine);
+    component.loadUrl(testFileUrl("assignConvertedLiterals.qml"), QQmlComponent::Asynchronous);
+    QTRY_VERIFY(!component.isLoading());
+    VERIFY_ERRORS(0);
+
+    QQmlCompiledData *compiledData = QQmlComponentPrivate::get(&component)->cc;
+    QVERIFY(compiledData != 0);
+    QCOMPARE(compiledData->convertedLiteralBindingsPerObject.count(), 2);
+
+    for (int i = 0; i < 2; ++i) {
+        QScopedPointer<MyTypeObject> object(qobject_cast<MyTypeObject *>(component.create()));
+        QVERIFY(object != 0);
+        QCOMPARE(object->colorProperty(), QColor("red"));
+        QCOMPARE(object->dateProperty(), QDate(1982, 11, 25));
+        QCOMPARE(object->timeProperty(), QTime(11, 11, 32));
+        QCOMPARE(object->dateTimeProperty(), QDateTime(QDate(2009, 5, 12), QTime(13, 22, 1)));
+        QCOMPARE(object->pointProperty(), QPoint(99, 13));
+        QCOMPARE(object->pointFProperty(), QPointF(-10.1, 12.3));
+        QCOMPARE(object->sizeProperty(), QSize(99, 13));
+        QCOMPARE(object->sizeFProperty(), QSizeF(0.1, 0.2));
+        QCOMPARE(object->rectProperty(), QRect(9, 7, 100, 200));
+        QCOMPARE(object->rectFProperty(), QRectF(1000.1, -10.9, 400, 90.99));
+
+        MyTypeObject *child = qobject_cast<MyTypeObject *>(object->objectProperty());
+        QVERIFY(child != 0);
+        QCOMPARE(child->colorProperty(), QColor(255, 0, 0, 128));
+    }
+}
+
 // Test edge case type assignments
 void tst_qqmllanguage::assignTypeExtremes()
 {
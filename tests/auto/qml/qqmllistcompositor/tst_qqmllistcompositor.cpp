@@ -144,6 +144,7 @@ private slots:
     void find();
     void findInsertPosition_data();
     void findInsertPosition();
+    void findDistant();
     void insert();
     void clearFlags_data();
     void clearFlags();
@@ -286,6 +287,65 @@ void tst_qqmllistcompositor::findInsertPosition()
     QCOMPARE(it->index, rangeIndex);
 }
 
+void tst_qqmllistcompositor::findDistant()
+{
+    QQmlListCompositor compositor;
+    compositor.setGroupCount(4);
+    compositor.setDefaultGroups(VisibleFlag | C::DefaultFlag);
+
+    int listA; void *a = &listA;
+
+    // Scatter group memberships so most items are in a range of their own, and jump
+    // around so lookups are resolved from the range index instead of by walking.
+    compositor.append(a, 0, 1000, C::AppendFlag | C::PrependFlag | C::DefaultFlag);
+    for (int i = 0; i < 1000; i += 3)
+        compositor.setFlags(C::Default, i, 1, VisibleFlag);
+    for (int i = 0; i < 1000; i += 7)
+        compositor.setFlags(C::Default, i, 1, SelectionFlag);
+
+    QCOMPARE(compositor.count(C::Default), 1000);
+    QCOMPARE(compositor.count(Visible), 334);
+    QCOMPARE(compositor.count(Selection), 143);
+
+    for (int i = 0; i < 1000; ++i) {
+        const int index = (i * 397) % 1000;
+        C::iterator it = compositor.find(C::Default, index);
+        QCOMPARE(it.modelIndex(), index);
+        QCOMPARE(it.index[C::Default], index);
+        QCOMPARE(it.index[Visible], (index + 2) / 3);
+        QCOMPARE(it.index[Selection], (index + 6) / 7);
+    }
+
+    for (int i = 0; i < 334; ++i) {
+        const int index = (i * 157) % 334;
+        C::iterator it = compositor.find(Visible, index);
+        QCOMPARE(it.modelIndex(), index * 3);
+        QCOMPARE(it.index[C::Default], index * 3);
+        QCOMPARE(it.index[Visible], index);
+        QCOMPARE(it.index[Selection], (index * 3 + 6) / 7);
+    }
+
+    C::insert_iterator insertIt = compositor.findInsertPosition(Visible, 200);
+    QCOMPARE(insertIt.index[C::Default], 600);
+    QCOMPARE(insertIt.index[Visible], 200);
+    insertIt = compositor.findInsertPosition(Visible, 334);
+    QCOMPARE(insertIt.index[C::Default], 1000);
+    QCOMPARE(insertIt.index[Visible], 334);
+
+    // Lookups after a change must not use stale indexes.
+    QVector<C::Remove> removes;
+    compositor.listItemsRemoved(a, 0, 500, &removes);
+    QCOMPARE(compositor.count(C::Default), 500);
+
+    for (int i = 0; i < 500; ++i) {
+        const int index = (i * 197) % 500;
+        C::iterator it = compositor.find(C::Default, index);
+        QCOMPARE(it.modelIndex(), index);
+        QCOMPARE(it.index[Visible], (500 + index + 2) / 3 - (500 + 2) / 3);
+        QCOMPARE(it.index[Selection], (500 + index + 6) / 7 - (500 + 6) / 7);
+    }
+}
+
 void tst_qqmllistcompositor::insert()
 {
     QQmlListCompositor compositor;
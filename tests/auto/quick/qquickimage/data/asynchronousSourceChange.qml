@@ -0,0 +1,13 @@
+import QtQuick 2.0
+
+Rectangle {
+    width: 200; height: 200
+    color: "blue"
+
+    Image {
+        objectName: "image"
+        width: 100; height: 100
+        asynchronous: true
+        source: "image://color/red"
+    }
+}
@@ -0,0 +1,8 @@
+import QtQuick 2.7
+
+Image {
+    source: "quadrants.png"
+    sourceClipRect: clipRect
+    sourceSize.width: srcWidth
+    sourceSize.height: srcHeight
+}
@@ -0,0 +1,26 @@
+import QtQuick 2.7
+
+Item {
+    width: 400
+    height: 200
+
+    Image {
+        id: clipped
+        objectName: "clipped"
+        source: "quadrants.png"
+        sourceClipRect: Qt.rect(0, 0, 100, 100)
+    }
+    Image {
+        id: full
+        objectName: "full"
+        x: 100
+        source: "quadrants.png"
+    }
+    Image {
+        id: otherClipped
+        objectName: "otherClipped"
+        x: 300
+        source: "quadrants.png"
+        sourceClipRect: Qt.rect(100, 100, 100, 100)
+    }
+}
@@ -45,6 +45,7 @@
 #include <QtQml/qqmlcontext.h>
 #include <QtQml/qqmlexpression.h>
 #include <QtTest/QSignalSpy>
+#include <QtCore/QRegularExpression>
 #include <QtGui/QPainter>
 #include <QtGui/QImageReader>
 #include <QQuickWindow>
@@ -97,6 +98,10 @@ private slots:
     void correctStatus();
     void highdpi();
     void hugeImages();
+    void sourceClipRect_data();
+    void sourceClipRect();
+    void sourceClipRectCacheKey();
+    void asynchronousSourceChange();
 
 private:
     QQmlEngine engine;
@@ -992,6 +997,148 @@ void tst_qquickimage::hugeImages()
     QCOMPARE(contents.pixel(199, 99), qRgba(0, 0, 255, 255));
 }
 
+void tst_qquickimage::sourceClipRect_data()
+{
+    QTest::addColumn<QRectF>("clipRect");
+    QTest::addColumn<QSize>("sourceSize");
+    QTest::addColumn<QSizeF>("implicitSize");
+    QTest::addColumn<QRgb>("color");
+
+    // quadrants.png is 200x200: red, green on top, blue, yellow below
+    QTest::newRow("unclipped") << QRectF() << QSize() << QSizeF(200, 200) << qRgb(255, 0, 0);
+    QTest::newRow("bottom right") << QRectF(100, 100, 100, 100) << QSize() << QSizeF(100, 100) << qRgb(255, 255, 0);
+    QTest::newRow("top right") << QRectF(100, 0, 100, 100) << QSize() << QSizeF(100, 100) << qRgb(0, 255, 0);
+    QTest::newRow("scale width") << QRectF(100, 100, 100, 100) << QSize(50, 0) << QSizeF(50, 50) << qRgb(255, 255, 0);
+    QTest::newRow("scale height") << QRectF(0, 100, 200, 100) << QSize(0, 25) << QSizeF(50, 25) << qRgb(0, 0, 255);
+    QTest::newRow("larger sourceSize") << QRectF(0, 0, 100, 100) << QSize(150, 150) << QSizeF(100, 100) << qRgb(255, 0, 0);
+    QTest::newRow("partly outside") << QRectF(150, 150, 100, 100) << QSize() << QSizeF(50, 50) << qRgb(255, 255, 0);
+    QTest::newRow("partly outside, negative") << QRectF(-50, -50, 100, 100) << QSize() << QSizeF(50, 50) << qRgb(255, 0, 0);
+    QTest::newRow("fully outside") << QRectF(300, 300, 100, 100) << QSize() << QSizeF(0, 0) << QRgb(0);
+}
+
+void tst_qquickimage::sourceClipRect()
+{
+    QFETCH(QRectF, clipRect);
+    QFETCH(QSize, sourceSize);
+    QFETCH(QSizeF, implicitSize);
+    QFETCH(QRgb, color);
+
+    QScopedPointer<QQuickView> window(new QQuickView(0));
+    QQmlContext *ctxt = window->rootContext();
+    ctxt->setContextProperty("clipRect", clipRect);
+    ctxt->setContextProperty("srcWidth", sourceSize.width());
+    ctxt->setContextProperty("srcHeight", sourceSize.height());
+
+    if (implicitSize.isEmpty())
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(".*Requested region is outside of the image"));
+
+    window->setSource(testFileUrl("sourceClipRect.qml"));
+
+    QQuickImage *image = qobject_cast<QQuickImage*>(window->rootObject());
+    QVERIFY(image);
+
+    QCOMPARE(image->sourceClipRect(), clipRect);
+    QCOMPARE(image->status(), implicitSize.isEmpty() ? QQuickImage::Error : QQuickImage::Ready);
+    QCOMPARE(image->implicitWidth(), implicitSize.width());
+    QCOMPARE(image->implicitHeight(), implicitSize.height());
+    if (implicitSize.isEmpty())
+        return;
+
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    // The first pixel shows the top left corner of the clipped region
+    QImage contents = window->grabWindow();
+    QCOMPARE(contents.pixel(1, 1), color);
+}
+
+void tst_qquickimage::sourceClipRectCacheKey()
+{
+    QScopedPointer<QQuickView> window(new QQuickView(0));
+    window->setSource(testFileUrl("sourceClipRectCache.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickImage *clipped = window->rootObject()->findChild<QQuickImage *>("clipped");
+    QQuickImage *full = window->rootObject()->findChild<QQuickImage *>("full");
+    QQuickImage *otherClipped = window->rootObject()->findChild<QQuickImage *>("otherClipped");
+    QVERIFY(clipped);
+    QVERIFY(full);
+    QVERIFY(otherClipped);
+
+    // The same URL with and without a clip rect, and with different clip rects,
+    // must not share pixmaps, in whichever order they are requested
+    QCOMPARE(clipped->status(), QQuickImage::Ready);
+    QCOMPARE(full->status(), QQuickImage::Ready);
+    QCOMPARE(otherClipped->status(), QQuickImage::Ready);
+    QCOMPARE(clipped->implicitWidth(), 100.0);
+    QCOMPARE(full->implicitWidth(), 200.0);
+    QCOMPARE(otherClipped->implicitWidth(), 100.0);
+
+    QImage contents = window->grabWindow();
+    QCOMPARE(contents.pixel(1, 1), qRgb(255, 0, 0));
+    QCOMPARE(contents.pixel(101, 1), qRgb(255, 0, 0));
+    QCOMPARE(contents.pixel(298, 198), qRgb(255, 255, 0));
+    QCOMPARE(contents.pixel(301, 1), qRgb(255, 255, 0));
+
+    // Removing the clip rect gives the whole image again
+    clipped->resetSourceClipRect();
+    QTRY_COMPARE(clipped->status(), QQuickImage::Ready);
+    QCOMPARE(clipped->implicitWidth(), 200.0);
+    QCOMPARE(clipped->implicitHeight(), 200.0);
+
+    otherClipped->setSourceClipRect(QRectF(0, 100, 100, 100));
+    QTRY_COMPARE(otherClipped->status(), QQuickImage::Ready);
+    QCOMPARE(otherClipped->implicitWidth(), 100.0);
+    contents = window->grabWindow();
+    QCOMPARE(contents.pixel(301, 1), qRgb(0, 0, 255));
+    QCOMPARE(contents.pixel(101, 1), qRgb(255, 0, 0));
+}
+
+// Solid images large enough to be uploaded asynchronously and to stay out of the atlas
+class ColorImageProvider : public QQuickImageProvider
+{
+public:
+    ColorImageProvider() : QQuickImageProvider(Image) {}
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+    {
+        Q_UNUSED(requestedSize);
+        QImage image(600, 600, QImage::Format_RGB32);
+        image.fill(QColor(id));
+        if (size)
+            *size = image.size();
+        return image;
+    }
+};
+
+void tst_qquickimage::asynchronousSourceChange()
+{
+    QQuickView window;
+    window.engine()->addImageProvider(QLatin1String("color"), new ColorImageProvider);
+    window.setSource(testFileUrl("asynchronousSourceChange.qml"));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QQuickImage *image = window.rootObject()->findChild<QQuickImage *>("image");
+    QVERIFY(image);
+    QTRY_COMPARE(image->status(), QQuickImage::Ready);
+    QTRY_COMPARE(window.grabWindow().pixel(50, 50), qRgb(255, 0, 0));
+
+    // The previous image stays on screen until the new one has been loaded
+    // and uploaded, and the new one is eventually shown without further changes.
+    image->setSource(QUrl("image://color/lime"));
+    QRgb pixel = qRgb(255, 0, 0);
+    for (int i = 0; i < 500 && pixel != qRgb(0, 255, 0); ++i) {
+        pixel = window.grabWindow().pixel(50, 50);
+        QVERIFY2(pixel == qRgb(255, 0, 0) || pixel == qRgb(0, 255, 0),
+                 qPrintable(QString::number(pixel, 16)));
+        QTest::qWait(10);
+    }
+    QCOMPARE(pixel, qRgb(0, 255, 0));
+    QCOMPARE(image->status(), QQuickImage::Ready);
+}
+
 QTEST_MAIN(tst_qquickimage)
 
 #include "tst_qquickimage.moc"
@@ -0,0 +1,35 @@
+import QtQuick 2.7
+
+ListView {
+    id: list
+    width: 240
+    height: 320
+    spacing: 2
+    sizeHintRole: "size"
+
+    property int itemCount: 1000
+
+    function itemSize(index) {
+        return 20 + (index % 7) * 10
+    }
+
+    function positionOf(index) {
+        var pos = 0
+        for (var i = 0; i < index; ++i)
+            pos += itemSize(i) + spacing
+        return pos
+    }
+
+    model: ListModel { id: listModel }
+    delegate: Rectangle {
+        objectName: "wrapper"
+        width: list.width
+        height: size
+        color: index % 2 ? "lightsteelblue" : "white"
+    }
+
+    Component.onCompleted: {
+        for (var i = 0; i < itemCount; ++i)
+            listModel.append({ "size": itemSize(i) })
+    }
+}
@@ -255,6 +255,8 @@ private slots:
     void QTBUG_50105();
     void QTBUG_50097_stickyHeader_positionViewAtIndex();
 
+    void sizeHintRole();
+
 private:
     template <class T> void items(const QUrl &source);
     template <class T> void changed(const QUrl &source);
@@ -8266,6 +8268,43 @@ void tst_QQuickListView::QTBUG_50097_stickyHeader_positionViewAtIndex()
     QTRY_COMPARE(listview->contentY(), -100.0); // back to the same position: header visible, items not under the header.
 }
 
+void tst_QQuickListView::sizeHintRole()
+{
+    QScopedPointer<QQuickView> window(createView());
+    window->setSource(testFileUrl("sizeHintRole.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickListView *listview = qobject_cast<QQuickListView*>(window->rootObject());
+    QVERIFY(listview != 0);
+    QTRY_COMPARE(listview->count(), 1000);
+
+    QVariant position;
+    QMetaObject::invokeMethod(listview, "positionOf", Q_RETURN_ARG(QVariant, position), Q_ARG(QVariant, 1000));
+    const qreal contentHeight = position.toReal() - listview->spacing();
+
+    // the content height is exact before any item past the first page is created
+    QTRY_COMPARE(listview->contentHeight(), contentHeight);
+    QCOMPARE(listview->originY(), 0.0);
+
+    QMetaObject::invokeMethod(listview, "positionOf", Q_RETURN_ARG(QVariant, position), Q_ARG(QVariant, 500));
+    listview->positionViewAtIndex(500, QQuickListView::Beginning);
+    QTRY_COMPARE(listview->contentY(), position.toReal());
+    QCOMPARE(listview->indexAt(10, listview->contentY() + 1), 500);
+    QCOMPARE(listview->contentHeight(), contentHeight);
+    QCOMPARE(listview->originY(), 0.0);
+
+    listview->positionViewAtEnd();
+    QTRY_COMPARE(listview->contentY(), contentHeight - listview->height());
+    QCOMPARE(listview->contentHeight(), contentHeight);
+
+    // without the hints, the content height is estimated from the visible items
+    listview->setSizeHintRole(QString());
+    listview->positionViewAtBeginning();
+    QTRY_COMPARE(listview->contentY(), 0.0);
+    QVERIFY(listview->contentHeight() != contentHeight);
+}
+
 QTEST_MAIN(tst_QQuickListView)
 
 #include "tst_qquicklistview.moc"
@@ -67,6 +67,8 @@ private slots:
 #endif
     void lockingCrash();
     void uncached();
+    void cacheBudgets();
+    void trimCache();
 #if PIXMAP_DATA_LEAK_TEST
     void dataLeak();
 #endif
@@ -108,6 +110,12 @@ void tst_qquickpixmapcache::initTestCase()
 {
     QQmlDataTest::initTestCase();
 
+    // Read when the pixmap store is created. Larger than the defaults, so
+    // that cacheBudgets() can tell them apart without evicting images the
+    // other tests expect to stay cached.
+    qputenv("QML_PIXMAP_CACHE_IMAGE_LIMIT", "8192");
+    qputenv("QML_PIXMAP_CACHE_TEXTURE_LIMIT", "8192");
+
     QVERIFY2(server.listen(), qPrintable(server.errorString()));
 
 #ifndef QT_NO_BEARERMANAGEMENT
@@ -457,6 +465,119 @@ void tst_qquickpixmapcache::uncached()
 }
 
 
+class SizedImageProvider : public QQuickImageProvider
+{
+public:
+    SizedImageProvider()
+    : QQuickImageProvider(Image) {}
+
+    virtual QImage requestImage(const QString &, QSize *size, const QSize &requestedSize) {
+        QImage image(requestedSize, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::red);
+        *size = requestedSize;
+        return image;
+    }
+};
+
+void tst_qquickpixmapcache::cacheBudgets()
+{
+    QQuickPixmap::purgeCache();
+
+    QQmlEngine engine;
+    engine.addImageProvider(QLatin1String("sized"), new SizedImageProvider);
+
+    // 3072 KB each, above the default image budget of 2048 KB but below the
+    // 8192 KB image and texture budgets set in initTestCase()
+    const QSize size(1024, 768);
+    const QUrl url1("image://sized/1");
+    const QUrl url2("image://sized/2");
+    const QUrl url3("image://sized/3");
+
+    {
+        QQuickPixmap p(&engine, url1, size);
+        QVERIFY(p.isReady());
+    }
+    QVERIFY(QQuickPixmap::isCached(url1, size));
+
+    {
+        QQuickPixmap p(&engine, url2, size);
+        QVERIFY(p.isReady());
+    }
+    QVERIFY(QQuickPixmap::isCached(url1, size));
+    QVERIFY(QQuickPixmap::isCached(url2, size));
+
+    // Over budget, the least recently released pixmap goes first
+    {
+        QQuickPixmap p(&engine, url3, size);
+        QVERIFY(p.isReady());
+    }
+    QVERIFY(!QQuickPixmap::isCached(url1, size));
+    QVERIFY(QQuickPixmap::isCached(url2, size));
+    QVERIFY(QQuickPixmap::isCached(url3, size));
+
+    // Referenced pixmaps do not count against the budgets
+    {
+        QQuickPixmap p1(&engine, url1, size);
+        QQuickPixmap p2(&engine, url2, size);
+        QQuickPixmap p3(&engine, url3, size);
+        QVERIFY(p1.isReady());
+        QVERIFY(p2.isReady());
+        QVERIFY(p3.isReady());
+        QVERIFY(QQuickPixmap::isCached(url1, size));
+        QVERIFY(QQuickPixmap::isCached(url2, size));
+        QVERIFY(QQuickPixmap::isCached(url3, size));
+    }
+
+    QQuickPixmap::purgeCache();
+    QVERIFY(!QQuickPixmap::isCached(url1, size));
+    QVERIFY(!QQuickPixmap::isCached(url2, size));
+    QVERIFY(!QQuickPixmap::isCached(url3, size));
+}
+
+void tst_qquickpixmapcache::trimCache()
+{
+    QQmlEngine engine;
+
+    const QUrl localUrl = testFileUrl("exists.png");
+    {
+        QQuickPixmap p(&engine, localUrl);
+        QTRY_VERIFY(p.isReady());
+    }
+    QVERIFY(QQuickPixmap::isCached(localUrl, QSize()));
+
+    // A server of its own, so that it can go away while the test runs
+    QScopedPointer<TestHTTPServer> trimServer(new TestHTTPServer);
+    QVERIFY2(trimServer->listen(), qPrintable(trimServer->errorString()));
+    trimServer->serveDirectory(testFile("http"));
+    const QUrl remoteUrl = trimServer->url("/exists8.png");
+    {
+        QQuickPixmap p(&engine, remoteUrl);
+        QTRY_VERIFY(p.isReady());
+    }
+    QVERIFY(QQuickPixmap::isCached(remoteUrl, QSize()));
+
+    // The decoded images go, the downloaded data stays
+    QQuickPixmap::trimCache();
+    QVERIFY(!QQuickPixmap::isCached(localUrl, QSize()));
+    QVERIFY(!QQuickPixmap::isCached(remoteUrl, QSize()));
+
+    trimServer.reset();
+    {
+        QQuickPixmap p(&engine, remoteUrl);
+        QTRY_VERIFY(!p.isLoading());
+        QCOMPARE(p.status(), QQuickPixmap::Ready);
+        QCOMPARE(p.width(), 100);
+    }
+
+    // Purging drops the downloaded data too
+    QQuickPixmap::purgeCache();
+    {
+        QQuickPixmap p(&engine, remoteUrl);
+        QTRY_VERIFY(!p.isLoading());
+        QCOMPARE(p.status(), QQuickPixmap::Error);
+    }
+}
+
 #if PIXMAP_DATA_LEAK_TEST
 // This test should not be enabled by default as it
 // produces spurious output in the expected case.
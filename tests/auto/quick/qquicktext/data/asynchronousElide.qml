@@ -0,0 +1,26 @@
+import QtQuick 2.7
+
+Item {
+    width: 400; height: 200
+
+    Text {
+        objectName: "asynchronous"
+        width: 100
+        text: "A single line of text that is too long to fit"
+        font.pixelSize: 16
+        asynchronous: true
+
+        // Eliding is not done asynchronously, so this lays the text out again while the
+        // asynchronous layout is being applied.
+        onLineCountChanged: elide = Text.ElideRight
+    }
+
+    Text {
+        objectName: "synchronous"
+        y: 100
+        width: 100
+        text: "A single line of text that is too long to fit"
+        font.pixelSize: 16
+        elide: Text.ElideRight
+    }
+}
@@ -0,0 +1,25 @@
+import QtQuick 2.7
+
+Item {
+    width: 400; height: 400
+
+    property string label: "The quick brown fox jumps over the lazy dog, and then the dog chases the fox all the way back home."
+
+    Text {
+        objectName: "asynchronous"
+        width: 150
+        text: label
+        wrapMode: Text.Wrap
+        font.pixelSize: 16
+        asynchronous: true
+    }
+
+    Text {
+        objectName: "synchronous"
+        y: 200
+        width: 150
+        text: label
+        wrapMode: Text.Wrap
+        font.pixelSize: 16
+    }
+}
@@ -0,0 +1,30 @@
+import QtQuick 2.6
+
+Item {
+    width: 400; height: 200
+
+    Text {
+        objectName: "text1"
+        text: "Shared label with some more words"
+        font.pixelSize: 16
+        elide: Text.ElideRight
+    }
+
+    Text {
+        objectName: "text2"
+        y: 50
+        text: "Shared label with some more words"
+        font.pixelSize: 16
+        elide: Text.ElideRight
+    }
+
+    // Handling lineLaidOut keeps the text from sharing its layout.
+    Text {
+        objectName: "reference"
+        y: 100
+        text: "Shared label with some more words"
+        font.pixelSize: 16
+        elide: Text.ElideRight
+        onLineLaidOut: {}
+    }
+}
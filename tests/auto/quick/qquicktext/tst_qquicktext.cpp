@@ -41,6 +41,7 @@
 #include <private/qquicktextdocument_p.h>
 #include <private/qquickvaluetypes_p.h>
 #include <QFontMetrics>
+#include <QFontDatabase>
 #include <qmath.h>
 #include <QtQuick/QQuickView>
 #include <private/qguiapplication_p.h>
@@ -151,6 +152,13 @@ private slots:
 
     void padding();
 
+    void layoutSharing_data();
+    void layoutSharing();
+
+    void asynchronousLayout();
+    void asynchronousLayoutTextChange();
+    void asynchronousLayoutElide();
+
 private:
     QStringList standard;
     QStringList richText;
@@ -769,24 +777,24 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     QQuickTextPrivate *textPrivate = QQuickTextPrivate::get(text);
     QVERIFY(textPrivate != 0);
 
-    QTRY_VERIFY(textPrivate->layout.lineCount());
+    QTRY_VERIFY(textPrivate->currentLayout()->lineCount());
 
     // implicit alignment should follow the reading direction of RTL text
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // explicitly left aligned text
     text->setHAlign(QQuickText::AlignLeft);
     QCOMPARE(text->hAlign(), QQuickText::AlignLeft);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
 
     // explicitly right aligned text
     text->setHAlign(QQuickText::AlignRight);
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // change to rich text
     QString textString = text->text();
@@ -819,13 +827,13 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     text->setHAlign(QQuickText::AlignHCenter);
     QCOMPARE(text->hAlign(), QQuickText::AlignHCenter);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().right() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().right() > window->width()/2);
 
     // reseted alignment should go back to following the text reading direction
     text->resetHAlign();
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // mirror the text item
     QQuickItemPrivate::get(text)->setLayoutMirror(true);
@@ -833,19 +841,19 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     // mirrored implicit alignment should continue to follow the reading direction of the text
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), QQuickText::AlignRight);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // mirrored explicitly right aligned behaves as left aligned
     text->setHAlign(QQuickText::AlignRight);
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), QQuickText::AlignLeft);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
 
     // mirrored explicitly left aligned behaves as right aligned
     text->setHAlign(QQuickText::AlignLeft);
     QCOMPARE(text->hAlign(), QQuickText::AlignLeft);
     QCOMPARE(text->effectiveHAlign(), QQuickText::AlignRight);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // disable mirroring
     QQuickItemPrivate::get(text)->setLayoutMirror(false);
@@ -854,7 +862,7 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     // English text should be implicitly left aligned
     text->setText("Hello world!");
     QCOMPARE(text->hAlign(), QQuickText::AlignLeft);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
 
     // empty text with implicit alignment follows the system locale-based
     // keyboard input direction from QInputMethod::inputDirection()
@@ -2742,8 +2750,8 @@ void tst_qquicktext::lineLaidOut()
 
     QVERIFY(!textPrivate->extra.isAllocated());
 
-    for (int i = 0; i < textPrivate->layout.lineCount(); ++i) {
-        QRectF r = textPrivate->layout.lineAt(i).rect();
+    for (int i = 0; i < textPrivate->currentLayout()->lineCount(); ++i) {
+        QRectF r = textPrivate->currentLayout()->lineAt(i).rect();
         QVERIFY(r.width() == i * 15);
         if (i >= 30)
             QVERIFY(r.x() == r.width() + 30);
@@ -2773,8 +2781,8 @@ void tst_qquicktext::lineLaidOutRelayout()
     QVERIFY(!textPrivate->extra.isAllocated());
 
     qreal maxH = 0;
-    for (int i = 0; i < textPrivate->layout.lineCount(); ++i) {
-        QTextLine line = textPrivate->layout.lineAt(i);
+    for (int i = 0; i < textPrivate->currentLayout()->lineCount(); ++i) {
+        QTextLine line = textPrivate->currentLayout()->lineAt(i);
         const QRectF r = line.rect();
         const qreal h = line.height();
         if (r.x() == 0) {
@@ -2799,9 +2807,9 @@ void tst_qquicktext::lineLaidOutHAlign()
     QQuickTextPrivate *textPrivate = QQuickTextPrivate::get(myText);
     QVERIFY(textPrivate != 0);
 
-    QCOMPARE(textPrivate->layout.lineCount(), 1);
+    QCOMPARE(textPrivate->currentLayout()->lineCount(), 1);
 
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().x() < 0.0);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().x() < 0.0);
 
     delete window;
 }
@@ -2932,7 +2940,7 @@ void tst_qquicktext::imgTagsAlign()
     QQuickTextPrivate *textPrivate = QQuickTextPrivate::get(textObject);
     QVERIFY(textPrivate != 0);
 
-    QRectF br = textPrivate->layout.boundingRect();
+    QRectF br = textPrivate->currentLayout()->boundingRect();
     if (align == "bottom")
         QVERIFY(br.y() == imgHeight - br.height());
     else if (align == "middle")
@@ -4157,6 +4165,173 @@ void tst_qquicktext::padding()
     delete root;
 }
 
+void tst_qquicktext::layoutSharing_data()
+{
+    QTest::addColumn<QString>("change");
+
+    QTest::newRow("width") << "width";
+    QTest::newRow("font") << "font";
+    QTest::newRow("text") << "text";
+}
+
+void tst_qquicktext::layoutSharing()
+{
+    QFETCH(QString, change);
+
+    QScopedPointer<QQuickView> window(createView(testFile("layoutSharing.qml")));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickText *text1 = window->rootObject()->findChild<QQuickText *>("text1");
+    QVERIFY(text1);
+    QQuickText *text2 = window->rootObject()->findChild<QQuickText *>("text2");
+    QVERIFY(text2);
+    QQuickText *reference = window->rootObject()->findChild<QQuickText *>("reference");
+    QVERIFY(reference);
+
+    QQuickTextPrivate *textPrivate1 = QQuickTextPrivate::get(text1);
+    QQuickTextPrivate *textPrivate2 = QQuickTextPrivate::get(text2);
+    QQuickTextPrivate *referencePrivate = QQuickTextPrivate::get(reference);
+
+    QVERIFY(textPrivate1->sharedLayout);
+    QCOMPARE(textPrivate2->sharedLayout, textPrivate1->sharedLayout);
+    QCOMPARE(textPrivate2->currentLayout(), textPrivate1->currentLayout());
+    QVERIFY(!referencePrivate->sharedLayout);
+
+    const QExplicitlySharedDataPointer<QQuickTextLayoutCache::Entry> entry = textPrivate1->sharedLayout;
+    const qreal implicitWidth = text1->implicitWidth();
+    const qreal implicitHeight = text1->implicitHeight();
+
+    QQuickText *changed[] = { text2, reference };
+    for (int i = 0; i < 2; ++i) {
+        QQuickText *text = changed[i];
+        if (change == "width") {
+            text->setWidth(60);
+        } else if (change == "font") {
+            QFont font = text->font();
+            font.setPixelSize(24);
+            text->setFont(font);
+        } else {
+            text->setText("A different label");
+        }
+    }
+
+    QVERIFY(textPrivate2->sharedLayout);
+    QVERIFY(textPrivate2->sharedLayout != entry);
+    QVERIFY(textPrivate2->currentLayout() != textPrivate1->currentLayout());
+
+    QCOMPARE(textPrivate1->sharedLayout, entry);
+    QCOMPARE(text1->implicitWidth(), implicitWidth);
+    QCOMPARE(text1->implicitHeight(), implicitHeight);
+    QCOMPARE(text1->truncated(), false);
+
+    QCOMPARE(text2->implicitWidth(), reference->implicitWidth());
+    QCOMPARE(text2->implicitHeight(), reference->implicitHeight());
+    QCOMPARE(text2->contentWidth(), reference->contentWidth());
+    QCOMPARE(text2->contentHeight(), reference->contentHeight());
+    QCOMPARE(text2->lineCount(), reference->lineCount());
+    QCOMPARE(text2->truncated(), reference->truncated());
+    QCOMPARE(text2->truncated(), change == "width");
+    QCOMPARE(textPrivate2->currentLayout()->lineCount(), referencePrivate->currentLayout()->lineCount());
+    QCOMPARE(textPrivate2->currentLayout()->lineAt(0).naturalTextWidth(),
+             referencePrivate->currentLayout()->lineAt(0).naturalTextWidth());
+}
+
+static bool isAsynchronouslyLaidOut(QQuickText *text)
+{
+    QQuickTextPrivate *textPrivate = QQuickTextPrivate::get(text);
+    return textPrivate->extra.isAllocated()
+            && textPrivate->extra->asyncLayout
+            && !textPrivate->extra->layoutJob;
+}
+
+void tst_qquicktext::asynchronousLayout()
+{
+    if (!QFontDatabase::supportsThreadedFontRendering())
+        QSKIP("Text is only laid out asynchronously where fonts can be used in other threads");
+
+    QScopedPointer<QQuickView> window(createView(testFile("asynchronousLayout.qml")));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickText *asynchronous = window->rootObject()->findChild<QQuickText *>("asynchronous");
+    QVERIFY(asynchronous);
+    QQuickText *synchronous = window->rootObject()->findChild<QQuickText *>("synchronous");
+    QVERIFY(synchronous);
+
+    QTRY_VERIFY(isAsynchronouslyLaidOut(asynchronous));
+    QVERIFY(synchronous->lineCount() > 1);
+
+    QCOMPARE(asynchronous->lineCount(), synchronous->lineCount());
+    QCOMPARE(asynchronous->implicitWidth(), synchronous->implicitWidth());
+    QCOMPARE(asynchronous->implicitHeight(), synchronous->implicitHeight());
+    QCOMPARE(asynchronous->contentWidth(), synchronous->contentWidth());
+    QCOMPARE(asynchronous->contentHeight(), synchronous->contentHeight());
+    QCOMPARE(asynchronous->baselineOffset(), synchronous->baselineOffset());
+}
+
+void tst_qquicktext::asynchronousLayoutTextChange()
+{
+    if (!QFontDatabase::supportsThreadedFontRendering())
+        QSKIP("Text is only laid out asynchronously where fonts can be used in other threads");
+
+    QScopedPointer<QQuickView> window(createView(testFile("asynchronousLayout.qml")));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickText *asynchronous = window->rootObject()->findChild<QQuickText *>("asynchronous");
+    QVERIFY(asynchronous);
+    QQuickText *synchronous = window->rootObject()->findChild<QQuickText *>("synchronous");
+    QVERIFY(synchronous);
+    QQuickTextPrivate *asynchronousPrivate = QQuickTextPrivate::get(asynchronous);
+
+    QTRY_VERIFY(isAsynchronouslyLaidOut(asynchronous));
+
+    // The first job is still running when the text changes again, and its result is dropped.
+    window->rootObject()->setProperty("label", QStringLiteral("Short"));
+    QVERIFY(asynchronousPrivate->extra->layoutJob);
+    window->rootObject()->setProperty("label", QStringLiteral("A label that is long enough to be wrapped onto a few lines"));
+    QVERIFY(asynchronousPrivate->extra->layoutJob);
+
+    QTRY_VERIFY(isAsynchronouslyLaidOut(asynchronous));
+    QCOMPARE(asynchronousPrivate->currentLayout()->text(), synchronous->text());
+
+    QCOMPARE(asynchronous->lineCount(), synchronous->lineCount());
+    QCOMPARE(asynchronous->implicitWidth(), synchronous->implicitWidth());
+    QCOMPARE(asynchronous->implicitHeight(), synchronous->implicitHeight());
+    QCOMPARE(asynchronous->contentWidth(), synchronous->contentWidth());
+    QCOMPARE(asynchronous->contentHeight(), synchronous->contentHeight());
+}
+
+void tst_qquicktext::asynchronousLayoutElide()
+{
+    if (!QFontDatabase::supportsThreadedFontRendering())
+        QSKIP("Text is only laid out asynchronously where fonts can be used in other threads");
+
+    QScopedPointer<QQuickView> window(createView(testFile("asynchronousElide.qml")));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickText *asynchronous = window->rootObject()->findChild<QQuickText *>("asynchronous");
+    QVERIFY(asynchronous);
+    QQuickText *synchronous = window->rootObject()->findChild<QQuickText *>("synchronous");
+    QVERIFY(synchronous);
+    QQuickTextPrivate *asynchronousPrivate = QQuickTextPrivate::get(asynchronous);
+
+    // Eliding switches the text to synchronous layout from within the asynchronous one.
+    QTRY_COMPARE(asynchronous->elideMode(), QQuickText::ElideRight);
+    QVERIFY(!asynchronousPrivate->extra->asyncLayout);
+    QVERIFY(synchronous->truncated());
+
+    QCOMPARE(asynchronous->truncated(), synchronous->truncated());
+    QCOMPARE(asynchronous->lineCount(), synchronous->lineCount());
+    QCOMPARE(asynchronous->implicitWidth(), synchronous->implicitWidth());
+    QCOMPARE(asynchronous->implicitHeight(), synchronous->implicitHeight());
+    QCOMPARE(asynchronous->contentWidth(), synchronous->contentWidth());
+    QCOMPARE(asynchronous->contentHeight(), synchronous->contentHeight());
+    QCOMPARE(asynchronous->baselineOffset(), synchronous->baselineOffset());
+}
+
 QTEST_MAIN(tst_qquicktext)
 
 #include "tst_qquicktext.moc"
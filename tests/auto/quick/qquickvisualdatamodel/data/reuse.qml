@@ -0,0 +1,12 @@
+import QtQuick 2.0
+import QtQml.Models 2.3
+
+DelegateModel {
+    poolSize: 2
+    model: [ "one", "two", "three", "four" ]
+    delegate: Item {
+        property string name: modelData
+        property int itemIndex: index
+        property int itemsIndex: DelegateModel.itemsIndex
+    }
+}
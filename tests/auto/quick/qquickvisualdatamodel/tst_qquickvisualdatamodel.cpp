@@ -430,6 +430,7 @@ private slots:
     void asynchronousMove_data();
     void asynchronousCancel();
     void invalidContext();
+    void reuseItems();
 
 private:
     template <int N> void groups_verify(
@@ -4235,6 +4236,53 @@ void tst_qquickvisualdatamodel::invalidContext()
     QVERIFY(!item);
 }
 
+void tst_qquickvisualdatamodel::reuseItems()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("reuse.qml"));
+
+    QScopedPointer<QObject> object(c.create());
+    QQmlDelegateModel *visualModel = qobject_cast<QQmlDelegateModel*>(object.data());
+    QVERIFY(visualModel);
+    QCOMPARE(visualModel->poolSize(), 2);
+
+    QSignalSpy destroyingSpy(visualModel, SIGNAL(destroyingItem(QObject*)));
+    QSignalSpy initSpy(visualModel, SIGNAL(initItem(int,QObject*)));
+
+    QObject *item = visualModel->object(0, false);
+    QVERIFY(item);
+    QCOMPARE(item->property("name").toString(), QString("one"));
+    QCOMPARE(item->property("itemIndex").toInt(), 0);
+    QCOMPARE(initSpy.count(), 1);
+
+    // A released instance is pooled instead of being destroyed.
+    QCOMPARE(visualModel->release(item), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Destroyed));
+    QCOMPARE(destroyingSpy.count(), 1);
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+
+    // And handed out again for a different index, with the model data updated.
+    QObject *reused = visualModel->object(2, false);
+    QCOMPARE(reused, item);
+    QCOMPARE(reused->property("name").toString(), QString("three"));
+    QCOMPARE(reused->property("itemIndex").toInt(), 2);
+    QCOMPARE(reused->property("itemsIndex").toInt(), 2);
+    QCOMPARE(initSpy.count(), 2);
+    QCOMPARE(initSpy.last().at(0).toInt(), 2);
+
+    // Disabling the pool destroys released instances again.
+    visualModel->setPoolSize(0);
+    QPointer<QObject> guard(reused);
+    QCOMPARE(visualModel->release(reused), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Destroyed));
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    QVERIFY(guard.isNull());
+
+    item = visualModel->object(3, false);
+    QVERIFY(item);
+    QVERIFY(item != reused);
+    QCOMPARE(item->property("name").toString(), QString("four"));
+    visualModel->release(item);
+}
+
 QTEST_MAIN(tst_qquickvisualdatamodel)
 
 #include "tst_qquickvisualdatamodel.moc"
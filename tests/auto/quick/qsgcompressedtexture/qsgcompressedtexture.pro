@@ -0,0 +1,14 @@
+CONFIG += testcase
+TARGET = tst_qsgcompressedtexture
+macx:CONFIG -= app_bundle
+
+HEADERS += ../../shared/testhttpserver.h
+SOURCES += tst_qsgcompressedtexture.cpp \
+           ../../shared/testhttpserver.cpp
+
+include (../../shared/util.pri)
+
+TESTDATA = data/*
+
+QT += core-private gui-private qml-private quick-private network testlib
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtest.h>
+#include <QtTest/QtTest>
+#include <QtQml/qqmlengine.h>
+#include <QtQuick/private/qquickpixmapcache_p.h>
+#include <QtQuick/private/qsgcompressedtexture_p.h>
+#include "../../shared/util.h"
+#include "testhttpserver.h"
+
+struct TextureFile
+{
+    const char *fileName;
+    const char *error;
+    int width;
+    int height;
+    bool hasAlpha;
+    int byteCount;
+};
+
+static const TextureFile textureFiles[] = {
+    { "etc1.ktx", "", 4, 4, false, 8 },
+    { "etc1_bigendian.ktx", "", 4, 4, false, 8 },
+    { "rgba.ktx", "", 2, 2, true, 16 },
+    { "rgb.ktx", "", 3, 2, false, 24 },
+    { "truncatedheader.ktx", "Truncated KTX header", 0, 0, false, 0 },
+    { "truncatedimage.ktx", "Truncated KTX image data", 0, 0, false, 0 },
+    { "shortimage.ktx", "KTX image data is smaller than the texture", 0, 0, false, 0 },
+    { "shortrows.ktx", "KTX image data is smaller than the texture", 0, 0, false, 0 },
+    { "badendianness.ktx", "Invalid KTX endianness marker", 0, 0, false, 0 },
+    { "unsupportedformat.ktx", "Uncompressed KTX textures must be GL_RGBA or GL_RGB with GL_UNSIGNED_BYTE components", 0, 0, false, 0 },
+    { "etc1.pkm", "", 3, 3, false, 8 },
+    { "etc2_rgba8.pkm", "", 4, 4, true, 16 },
+    { "truncatedheader.pkm", "Truncated PKM header", 0, 0, false, 0 },
+    { "truncatedimage.pkm", "Truncated PKM image data", 0, 0, false, 0 },
+    { "unsupportedformat.pkm", "Unsupported PKM texture type 2", 0, 0, false, 0 }
+};
+
+class tst_qsgcompressedtexture : public QQmlDataTest
+{
+    Q_OBJECT
+public:
+    tst_qsgcompressedtexture() {}
+
+private slots:
+    void initTestCase();
+    void canRead();
+    void factory_data();
+    void factory();
+    void pixmapCache_data();
+    void pixmapCache();
+
+private:
+    void addTextureFileColumns();
+
+    QQmlEngine engine;
+    TestHTTPServer server;
+};
+
+void tst_qsgcompressedtexture::initTestCase()
+{
+    QQmlDataTest::initTestCase();
+
+    QVERIFY2(server.listen(), qPrintable(server.errorString()));
+    server.serveDirectory(dataDirectory());
+}
+
+void tst_qsgcompressedtexture::canRead()
+{
+    QFile ktx(testFile("etc1.ktx"));
+    QVERIFY(ktx.open(QIODevice::ReadOnly));
+    QVERIFY(QSGCompressedTextureFactory::canRead(&ktx));
+    QCOMPARE(ktx.pos(), qint64(0));
+
+    QFile pkm(testFile("etc1.pkm"));
+    QVERIFY(pkm.open(QIODevice::ReadOnly));
+    QVERIFY(QSGCompressedTextureFactory::canRead(&pkm));
+    QCOMPARE(pkm.pos(), qint64(0));
+
+    // Recognized by the identifier alone, so broken files report a proper error
+    QVERIFY(QSGCompressedTextureFactory::canRead(QByteArray("PKM ")));
+    QVERIFY(QSGCompressedTextureFactory::canRead(QByteArray("\xabKTX 11\xbb\r\n\x1a\n", 12)));
+
+    QVERIFY(!QSGCompressedTextureFactory::canRead(QByteArray()));
+    QVERIFY(!QSGCompressedTextureFactory::canRead(QByteArray("PKM")));
+    QVERIFY(!QSGCompressedTextureFactory::canRead(QByteArray("\xabKTX 11", 7)));
+    QVERIFY(!QSGCompressedTextureFactory::canRead(QByteArray("\x89PNG\r\n\x1a\n", 8)));
+}
+
+void tst_qsgcompressedtexture::addTextureFileColumns()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QString>("error");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<bool>("hasAlpha");
+    QTest::addColumn<int>("byteCount");
+}
+
+void tst_qsgcompressedtexture::factory_data()
+{
+    QTest::addColumn<bool>("fromData");
+    addTextureFileColumns();
+
+    for (uint i = 0; i < sizeof(textureFiles) / sizeof(textureFiles[0]); ++i) {
+        const TextureFile &f = textureFiles[i];
+        for (int fromData = 0; fromData < 2; ++fromData) {
+            QTest::newRow(QByteArray(f.fileName).append(fromData ? " data" : " file").constData())
+                    << bool(fromData) << QString::fromLatin1(f.fileName) << QString::fromLatin1(f.error)
+                    << QSize(f.width, f.height) << f.hasAlpha << f.byteCount;
+        }
+    }
+}
+
+void tst_qsgcompressedtexture::factory()
+{
+    QFETCH(bool, fromData);
+    QFETCH(QString, fileName);
+    QFETCH(QString, error);
+    QFETCH(QSize, size);
+    QFETCH(bool, hasAlpha);
+    QFETCH(int, byteCount);
+
+    // Local files are memory mapped, network replies are parsed from memory
+    QString errorString;
+    QScopedPointer<QSGCompressedTextureFactory> factory;
+    if (fromData) {
+        QFile file(testFile(fileName));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        factory.reset(QSGCompressedTextureFactory::create(file.readAll(), &errorString));
+    } else {
+        factory.reset(QSGCompressedTextureFactory::create(testFile(fileName), &errorString));
+    }
+
+    if (!error.isEmpty()) {
+        QVERIFY(factory.isNull());
+        QCOMPARE(errorString, error);
+        return;
+    }
+
+    QVERIFY2(!factory.isNull(), qPrintable(errorString));
+    QCOMPARE(factory->textureSize(), size);
+    QCOMPARE(factory->textureByteCount(), byteCount);
+    QVERIFY(factory->image().isNull());
+
+    // Nothing is uploaded until the texture is bound
+    QScopedPointer<QSGTexture> texture(factory->createTexture(0));
+    QVERIFY(!texture.isNull());
+    QCOMPARE(texture->textureId(), 0);
+    QCOMPARE(texture->textureSize(), size);
+    QCOMPARE(texture->hasAlphaChannel(), hasAlpha);
+    QVERIFY(!texture->hasMipmaps());
+}
+
+void tst_qsgcompressedtexture::pixmapCache_data()
+{
+    QTest::addColumn<QUrl>("url");
+    QTest::addColumn<int>("options");
+    addTextureFileColumns();
+
+    for (uint i = 0; i < sizeof(textureFiles) / sizeof(textureFiles[0]); ++i) {
+        const TextureFile &f = textureFiles[i];
+        const QString fileName = QString::fromLatin1(f.fileName);
+        const QSize size(f.width, f.height);
+
+        QTest::newRow(QByteArray(f.fileName).append(" local").constData())
+                << testFileUrl(fileName) << int(QQuickPixmap::Cache)
+                << fileName << QString::fromLatin1(f.error) << size << f.hasAlpha << f.byteCount;
+        QTest::newRow(QByteArray(f.fileName).append(" local async").constData())
+                << testFileUrl(fileName) << int(QQuickPixmap::Cache | QQuickPixmap::Asynchronous)
+                << fileName << QString::fromLatin1(f.error) << size << f.hasAlpha << f.byteCount;
+        QTest::newRow(QByteArray(f.fileName).append(" remote").constData())
+                << server.url(QLatin1Char('/') + fileName) << int(QQuickPixmap::Cache)
+                << fileName << QString::fromLatin1(f.error) << size << f.hasAlpha << f.byteCount;
+    }
+}
+
+void tst_qsgcompressedtexture::pixmapCache()
+{
+    QFETCH(QUrl, url);
+    QFETCH(int, options);
+    QFETCH(QString, error);
+    QFETCH(QSize, size);
+    QFETCH(int, byteCount);
+
+    // Each row must go through the reader, not find the previous row's pixmap
+    QQuickPixmap::purgeCache();
+
+    QQuickPixmap pixmap;
+    pixmap.load(&engine, url, QQuickPixmap::Options(options));
+    QTRY_VERIFY(!pixmap.isLoading());
+
+    if (!error.isEmpty()) {
+        QCOMPARE(pixmap.status(), QQuickPixmap::Error);
+        QCOMPARE(pixmap.error(), QStringLiteral("Error decoding: %1: %2").arg(url.toString()).arg(error));
+        return;
+    }
+
+    QCOMPARE(pixmap.status(), QQuickPixmap::Ready);
+    QCOMPARE(pixmap.implicitSize(), size);
+    QVERIFY(pixmap.image().isNull());
+
+    QSGCompressedTextureFactory *factory = qobject_cast<QSGCompressedTextureFactory *>(pixmap.textureFactory());
+    QVERIFY(factory);
+    QCOMPARE(factory->textureSize(), size);
+    QCOMPARE(factory->textureByteCount(), byteCount);
+}
+
+QTEST_MAIN(tst_qsgcompressedtexture)
+
+#include "tst_qsgcompressedtexture.moc"
@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qsgshaderdiskcache
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qsgshaderdiskcache.cpp
+
+QT += core-private gui-private quick-private testlib
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,196 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtest.h>
+#include <QtTest/QtTest>
+#include <QtGui/qoffscreensurface.h>
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglshaderprogram.h>
+#include <QtQuick/private/qsgshaderdiskcache_p.h>
+
+static const char vertexCode[] =
+        "attribute highp vec4 vertex;\n"
+        "uniform highp mat4 matrix;\n"
+        "void main() { gl_Position = matrix * vertex; }\n";
+
+static const char fragmentCode[] =
+        "uniform lowp vec4 color;\n"
+        "void main() { gl_FragColor = color; }\n";
+
+static const char otherFragmentCode[] =
+        "void main() { gl_FragColor = vec4(1.0); }\n";
+
+static const char *const attributeNames[] = { "vertex", 0 };
+
+class tst_qsgshaderdiskcache : public QObject
+{
+    Q_OBJECT
+public:
+    tst_qsgshaderdiskcache() {}
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void pruneStaleDrivers();
+    void roundTrip();
+    void corruptEntry();
+    void eviction();
+
+private:
+    bool link(QOpenGLShaderProgram *program, const char *fragment);
+    QStringList binaries() const;
+
+    QTemporaryDir m_cacheDir;
+    QOffscreenSurface m_surface;
+    QOpenGLContext m_context;
+};
+
+void tst_qsgshaderdiskcache::initTestCase()
+{
+    QVERIFY(m_cacheDir.isValid());
+    // Read once per process, so they must be set before the first cache is created
+    qputenv("QSG_SHADER_CACHE_DIR", QFile::encodeName(m_cacheDir.path()));
+    qputenv("QSG_SHADER_CACHE_MAX_SIZE", "1");
+
+    // Left behind by another driver, by the older layout, and by someone else
+    QDir dir(m_cacheDir.path());
+    QVERIFY(dir.mkdir(QStringLiteral("0123456789abcdef")));
+    QFile stale(dir.filePath(QStringLiteral("0123456789abcdef/stale.bin")));
+    QVERIFY(stale.open(QIODevice::WriteOnly));
+    stale.close();
+    QFile old(dir.filePath(QStringLiteral("old.bin")));
+    QVERIFY(old.open(QIODevice::WriteOnly));
+    old.close();
+    QFile unrelated(dir.filePath(QStringLiteral("unrelated.txt")));
+    QVERIFY(unrelated.open(QIODevice::WriteOnly));
+    unrelated.close();
+
+    m_surface.create();
+    if (!m_context.create() || !m_context.makeCurrent(&m_surface))
+        QSKIP("OpenGL is not available");
+
+    QSGShaderDiskCache cache(&m_context);
+    if (!cache.isEnabled())
+        QSKIP("Program binaries are not supported");
+}
+
+void tst_qsgshaderdiskcache::cleanupTestCase()
+{
+    m_context.doneCurrent();
+}
+
+bool tst_qsgshaderdiskcache::link(QOpenGLShaderProgram *program, const char *fragment)
+{
+    QSGShaderDiskCache cache(&m_context);
+    program->bindAttributeLocation(attributeNames[0], 0);
+    return cache.link(program, vertexCode, fragment, attributeNames);
+}
+
+QStringList tst_qsgshaderdiskcache::binaries() const
+{
+    QStringList files;
+    QDirIterator it(m_cacheDir.path(), QStringList(QStringLiteral("*.bin")), QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+        files.append(it.next());
+    return files;
+}
+
+void tst_qsgshaderdiskcache::pruneStaleDrivers()
+{
+    QDir dir(m_cacheDir.path());
+    QVERIFY(!dir.exists(QStringLiteral("0123456789abcdef")));
+    QVERIFY(!dir.exists(QStringLiteral("old.bin")));
+    QVERIFY(dir.exists(QStringLiteral("unrelated.txt")));
+    QVERIFY(binaries().isEmpty());
+}
+
+void tst_qsgshaderdiskcache::roundTrip()
+{
+    QOpenGLShaderProgram program;
+    QVERIFY(link(&program, fragmentCode));
+    QCOMPARE(binaries().size(), 1);
+
+    // Linked from the binary, no shaders get compiled
+    QSGShaderDiskCache cache(&m_context);
+    QOpenGLShaderProgram loaded;
+    loaded.bindAttributeLocation(attributeNames[0], 0);
+    QVERIFY(cache.load(&loaded, cache.key(vertexCode, fragmentCode, attributeNames)));
+    QVERIFY(loaded.isLinked());
+    QVERIFY(loaded.shaders().isEmpty());
+    QVERIFY(loaded.uniformLocation("color") >= 0);
+    QCOMPARE(loaded.attributeLocation("vertex"), 0);
+}
+
+void tst_qsgshaderdiskcache::corruptEntry()
+{
+    QOpenGLShaderProgram program;
+    QVERIFY(link(&program, fragmentCode));
+    QStringList files = binaries();
+    QCOMPARE(files.size(), 1);
+
+    QFile file(files.first());
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("not a program binary");
+    file.close();
+
+    QSGShaderDiskCache cache(&m_context);
+    QOpenGLShaderProgram loaded;
+    QVERIFY(!cache.load(&loaded, cache.key(vertexCode, fragmentCode, attributeNames)));
+    QVERIFY(binaries().isEmpty());
+
+    // Built from source again, and stored again
+    QOpenGLShaderProgram rebuilt;
+    QVERIFY(link(&rebuilt, fragmentCode));
+    QVERIFY(!rebuilt.shaders().isEmpty());
+    QCOMPARE(binaries().size(), 1);
+}
+
+void tst_qsgshaderdiskcache::eviction()
+{
+    QOpenGLShaderProgram program;
+    QVERIFY(link(&program, fragmentCode));
+    QOpenGLShaderProgram other;
+    QVERIFY(link(&other, otherFragmentCode));
+
+    // The limit of one byte only leaves room for the binary stored last
+    QCOMPARE(binaries().size(), 1);
+    QSGShaderDiskCache cache(&m_context);
+    QOpenGLShaderProgram loaded;
+    QVERIFY(cache.load(&loaded, cache.key(vertexCode, otherFragmentCode, attributeNames)));
+    QOpenGLShaderProgram evicted;
+    QVERIFY(!cache.load(&evicted, cache.key(vertexCode, fragmentCode, attributeNames)));
+}
+
+QTEST_MAIN(tst_qsgshaderdiskcache)
+
+#include "tst_qsgshaderdiskcache.moc"
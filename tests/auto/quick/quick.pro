@@ -29,7 +29,9 @@ PRIVATETESTS += \
     qquickstates \
     qquicksystempalette \
     qquicktimeline \
-    qquickxmllistmodel
+    qquickxmllistmodel \
+    qsgcompressedtexture \
+    qsgshaderdiskcache
 
 # This test requires the xmlpatterns module
 !qtHaveModule(xmlpatterns): PRIVATETESTS -= qquickxmllistmodel
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.2
+
+/*
+    The test verifies that images render correctly when the texture atlas
+    they are in gets repacked. It is meant to run with a 128x128 atlas, of
+    which there may only be one: the images fill the atlas, every other one
+    is then released, and a wide image that does not fit in any of the holes
+    is added. A fragmented atlas is repacked at most once every 60 frames,
+    so the final stage animates for a while before adding another wide
+    image, which fits once the atlas is repacked.
+
+    #samples: 9
+                 PixelPos     R    G    B    Error-tolerance
+    #base:         2  14     0.0  0.0  0.0        0.1
+    #base:        25  14     1.0  1.0  1.0        0.1
+    #base:        32  14     0.0  0.0  0.0        0.1
+
+    #final:        2  14     0.0  0.0  0.0        0.1
+    #final:       25  14     1.0  1.0  1.0        0.1
+    #final:        2 144     0.0  0.0  0.0        0.1
+    #final:       57 144     1.0  1.0  1.0        0.1
+    #final:        2 174     0.0  0.0  0.0        0.1
+    #final:       57 174     1.0  1.0  1.0        0.1
+*/
+
+RenderTestBase
+{
+    id: root
+
+    property bool thinnedOut: false
+    property bool secondWideImage: false
+
+    Repeater {
+        model: 16
+        Loader {
+            x: (index % 4) * 30
+            y: Math.floor(index / 4) * 30
+            // Keeps a checkerboard, so that no two holes are adjacent
+            active: !root.thinnedOut || (Math.floor(index / 4) + index % 4) % 2 == 0
+            sourceComponent: Image {
+                source: "blacknwhite.png"
+                sourceSize: Qt.size(28, 28)
+                cache: false
+            }
+        }
+    }
+
+    Loader {
+        y: 130
+        active: root.thinnedOut
+        sourceComponent: Image {
+            source: "blacknwhite.png"
+            sourceSize: Qt.size(60, 28)
+            cache: false
+        }
+    }
+
+    Loader {
+        y: 160
+        active: root.secondWideImage
+        sourceComponent: Image {
+            source: "blacknwhite.png"
+            sourceSize: Qt.size(60, 28)
+            cache: false
+        }
+    }
+
+    Rectangle {
+        id: ticker
+        y: 190
+        width: 10
+        height: 10
+        color: "red"
+    }
+
+    NumberAnimation {
+        id: animation
+        target: ticker
+        property: "x"
+        from: 0
+        to: 100
+        duration: 1500
+        onStopped: {
+            root.secondWideImage = true;
+            root.finalStageComplete = true;
+        }
+    }
+
+    onEnterFinalStage: {
+        root.thinnedOut = true;
+        animation.start();
+    }
+}
@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.2
+
+/*
+    The test verifies that an item whose geometry is outside the viewport
+    is not culled when a custom vertex shader moves it into view.
+
+    #samples: 4
+                 PixelPos     R    G    B    Error-tolerance
+    #base:        20  20     1.0  0.0  0.0        0.05
+    #base:       150 150     0.0  0.0  1.0        0.05
+
+    #final:       20  20     0.0  0.0  1.0        0.05
+    #final:      150 150     1.0  0.0  0.0        0.05
+*/
+
+RenderTestBase
+{
+    id: root
+
+    Rectangle {
+        anchors.fill: parent
+        color: "blue"
+    }
+
+    ShaderEffect {
+        id: effect
+        x: -1000
+        y: 10
+        width: 100
+        height: 100
+
+        property point shift: Qt.point(1010, 0)
+
+        vertexShader: "
+            uniform highp mat4 qt_Matrix;
+            uniform highp vec2 shift;
+            attribute highp vec4 qt_Vertex;
+            void main() {
+                gl_Position = qt_Matrix * (qt_Vertex + vec4(shift, 0.0, 0.0));
+            }"
+
+        fragmentShader: "
+            uniform lowp float qt_Opacity;
+            void main() {
+                gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0) * qt_Opacity;
+            }"
+    }
+
+    onEnterFinalStage: {
+        effect.y = 1000;
+        effect.shift = Qt.point(1130, -870);
+        root.finalStageComplete = true;
+    }
+}
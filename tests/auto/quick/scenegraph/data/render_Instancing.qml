@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.2
+
+/*
+    The test verifies that batches of identical geometry render the same
+    whether they are drawn instanced or merged.
+
+    #samples: 8
+                 PixelPos     R    G    B    Error-tolerance
+    #base:         5   5     1.0  0.0  0.0        0.05
+    #base:         5  95     0.0  0.0  1.0        0.05
+    #base:         5 155     0.0  0.0  0.0        0.05
+    #base:        15 155     1.0  1.0  1.0        0.05
+
+    #final:        5   5     1.0  1.0  1.0        0.05
+    #final:      105   5     1.0  0.0  0.0        0.05
+    #final:        5 175     0.0  0.0  0.0        0.05
+    #final:       15 175     1.0  1.0  1.0        0.05
+*/
+
+RenderTestBase
+{
+    id: root
+
+    property real rowOffset: 0
+    property real imageOffset: 0
+
+    Repeater {
+        model: 100
+        Rectangle {
+            x: (index % 10) * 10 + (index < 10 ? root.rowOffset : 0)
+            y: Math.floor(index / 10) * 10
+            width: 10
+            height: 10
+            color: index < 50 ? "red" : "blue"
+        }
+    }
+
+    Repeater {
+        model: 20
+        Image {
+            x: (index % 10) * 20
+            y: 150 + Math.floor(index / 10) * 10 + root.imageOffset
+            width: 20
+            height: 10
+            source: "blacknwhite.png"
+            smooth: false
+        }
+    }
+
+    onEnterFinalStage: {
+        root.rowOffset = 100;
+        root.imageOffset = 20;
+        root.finalStageComplete = true;
+    }
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.2
+
+/*
+    The test verifies that batches filled on several threads render the same
+    as batches filled on the render thread.
+
+    #samples: 8
+                 PixelPos     R    G    B    Error-tolerance
+    #base:         5   5     1.0  0.0  0.0        0.05
+    #base:        15   5     0.0  1.0  0.0        0.05
+    #base:        25   5     0.0  0.0  1.0        0.05
+    #base:        35   5     1.0  1.0  0.0        0.05
+
+    #final:        5   5     0.0  1.0  0.0        0.05
+    #final:       15   5     0.0  0.0  1.0        0.05
+    #final:       25   5     1.0  1.0  0.0        0.05
+    #final:       35   5     1.0  0.0  0.0        0.05
+*/
+
+RenderTestBase
+{
+    id: root
+
+    property int shift: 0
+    property var colors: [ "#ff0000", "#00ff00", "#0000ff", "#ffff00" ]
+
+    Repeater {
+        model: 300
+        Rectangle {
+            x: (index % 20) * 10
+            y: Math.floor(index / 20) * 10
+            width: 10
+            height: 10
+            color: root.colors[(index + root.shift) % 4]
+        }
+    }
+
+    Repeater {
+        model: 40
+        Rectangle {
+            x: (index % 10) * 20 + 5
+            y: Math.floor(index / 10) * 12 + 152
+            width: 10
+            height: 6
+            rotation: 30 + index
+            antialiasing: true
+            color: root.colors[(index + root.shift) % 4]
+        }
+    }
+
+    onEnterFinalStage: {
+        root.shift = 1;
+        root.finalStageComplete = true;
+    }
+}
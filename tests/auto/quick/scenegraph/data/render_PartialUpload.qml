@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.2
+
+/*
+    The test verifies that uploading only the changed elements of a merged
+    batch, over several frames, renders the same as uploading all of it.
+
+    #samples: 6
+                 PixelPos     R    G    B    Error-tolerance
+    #base:         7   5     1.0  0.0  0.0        0.05
+    #base:        17   5     1.0  0.0  0.0        0.05
+    #base:        77   5     1.0  0.0  0.0        0.05
+
+    #final:        7   5     1.0  1.0  1.0        0.05
+    #final:       17   5     1.0  0.0  0.0        0.05
+    #final:       77   5     1.0  1.0  1.0        0.05
+*/
+
+RenderTestBase
+{
+    id: root
+
+    property real shrink: 10
+
+    Repeater {
+        model: 100
+        Rectangle {
+            x: (index % 10) * 10
+            y: Math.floor(index / 10) * 10
+            width: index % 7 == 0 ? root.shrink : 10
+            height: 10
+            color: "red"
+        }
+    }
+
+    NumberAnimation {
+        id: animation
+        target: root
+        property: "shrink"
+        from: 10
+        to: 5
+        duration: 300
+        onStopped: root.finalStageComplete = true
+    }
+
+    onEnterFinalStage: animation.start()
+}
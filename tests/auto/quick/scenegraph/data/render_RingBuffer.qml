@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.2
+
+/*
+    The test verifies that batches which are uploaded in consecutive frames,
+    and therefore streamed through the ring buffer when it is enabled, render
+    correctly.
+
+    #samples: 6
+                 PixelPos     R    G    B    Error-tolerance
+    #base:         5   5     1.0  0.0  0.0        0.05
+    #base:         5  75     0.0  0.0  1.0        0.05
+    #base:        65   5     1.0  1.0  1.0        0.05
+
+    #final:        5   5     1.0  1.0  1.0        0.05
+    #final:       65   5     1.0  0.0  0.0        0.05
+    #final:       65  75     0.0  0.0  1.0        0.05
+*/
+
+RenderTestBase
+{
+    id: root
+
+    property real offset: 0
+
+    Repeater {
+        model: 100
+        Rectangle {
+            x: (index % 5) * 10 + root.offset
+            y: Math.floor(index / 5) * 5
+            width: 10
+            height: 5
+            color: index < 50 ? "red" : "blue"
+        }
+    }
+
+    NumberAnimation {
+        id: animation
+        target: root
+        property: "offset"
+        from: 0
+        to: 60
+        duration: 500
+        onStopped: root.finalStageComplete = true
+    }
+
+    onEnterFinalStage: animation.start()
+}
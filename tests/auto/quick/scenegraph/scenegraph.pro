@@ -13,4 +13,10 @@ DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
 OTHER_FILES += \
     data/render_OutOfFloatRange.qml \
     data/simple.qml \
-    data/render_ImageFiltering.qml
+    data/render_ImageFiltering.qml \
+    data/render_CustomVertexShaderCulling.qml \
+    data/render_ParallelFill.qml \
+    data/render_RingBuffer.qml \
+    data/render_PartialUpload.qml \
+    data/render_Instancing.qml \
+    data/render_AtlasRepack.qml
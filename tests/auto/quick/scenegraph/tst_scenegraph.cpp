@@ -102,6 +102,9 @@ private slots:
     void render_data();
     void render();
 
+    void renderWithFeature_data();
+    void renderWithFeature();
+
     void hideWithOtherContext();
 
     void createTextureFromImage_data();
@@ -418,7 +421,13 @@ void tst_SceneGraph::render_data()
           << "data/render_StackingOrder.qml"
           << "data/render_ImageFiltering.qml"
           << "data/render_bug37422.qml"
-          << "data/render_OpacityThroughBatchRoot.qml";
+          << "data/render_OpacityThroughBatchRoot.qml"
+          << "data/render_CustomVertexShaderCulling.qml"
+          << "data/render_ParallelFill.qml"
+          << "data/render_RingBuffer.qml"
+          << "data/render_PartialUpload.qml"
+          << "data/render_Instancing.qml"
+          << "data/render_AtlasRepack.qml";
     if (!m_brokenMipmapSupport)
           files << "data/render_Mipmap.qml";
 
@@ -504,6 +513,139 @@ void tst_SceneGraph::render()
     }
 }
 
+/*
+  The renderWithFeature test renders a file from the render_ set with one of
+  the renderer's optional code paths turned off and on, and verifies that
+  both render the same, in the base stage as well as in the final stage.
+
+  The code paths are controlled by environment variables which are read when
+  the renderer and the render context are created. Every window has its own
+  renderer, and the render context is recreated once no window is left, so
+  the variables are set before the window is created.
+
+  To add new tests, add a row naming the file and the variables to set with
+  the code path turned off and on, as space separated NAME=value pairs.
+*/
+
+void tst_SceneGraph::renderWithFeature_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QByteArray>("offEnvironment");
+    QTest::addColumn<QByteArray>("onEnvironment");
+
+    QTest::newRow("parallel fill") << QString("data/render_ParallelFill.qml")
+                                   << QByteArray("QSG_RENDERER_PARALLEL_UPLOAD_THRESHOLD=0")
+                                   << QByteArray("QSG_RENDERER_PARALLEL_UPLOAD_THRESHOLD=1");
+    QTest::newRow("ring buffer") << QString("data/render_RingBuffer.qml")
+                                 << QByteArray()
+                                 << QByteArray("QSG_RENDERER_BUFFER_STRATEGY=ring");
+    QTest::newRow("small ring buffer") << QString("data/render_RingBuffer.qml")
+                                       << QByteArray()
+                                       << QByteArray("QSG_RENDERER_BUFFER_STRATEGY=ring QSG_RENDERER_RING_BUFFER_SIZE=1024");
+    QTest::newRow("partial upload") << QString("data/render_PartialUpload.qml")
+                                    << QByteArray("QSG_RENDERER_NO_PARTIAL_UPLOAD=1")
+                                    << QByteArray();
+    QTest::newRow("instancing") << QString("data/render_Instancing.qml")
+                                << QByteArray("QSG_RENDERER_INSTANCING_THRESHOLD=0")
+                                << QByteArray("QSG_RENDERER_INSTANCING_THRESHOLD=2");
+    QTest::newRow("atlas repack") << QString("data/render_AtlasRepack.qml")
+                                  << QByteArray("QSG_ATLAS_WIDTH=128 QSG_ATLAS_HEIGHT=128 QSG_ATLAS_MAX_COUNT=1 QSG_ATLAS_NO_REPACK=1")
+                                  << QByteArray("QSG_ATLAS_WIDTH=128 QSG_ATLAS_HEIGHT=128 QSG_ATLAS_MAX_COUNT=1");
+}
+
+static QList<QByteArray> setEnvironment(const QByteArray &environment)
+{
+    QList<QByteArray> names;
+    foreach (const QByteArray &assignment, environment.split(' ')) {
+        const int equals = assignment.indexOf('=');
+        if (equals <= 0)
+            continue;
+        names << assignment.left(equals);
+        qputenv(names.last().constData(), assignment.mid(equals + 1));
+    }
+    return names;
+}
+
+static void unsetEnvironment(const QList<QByteArray> &names)
+{
+    foreach (const QByteArray &name, names)
+        qunsetenv(name.constData());
+}
+
+static void grabStages(const QString &file, QImage *base, QImage *final)
+{
+    QObject suite;
+    suite.setObjectName("The Suite");
+
+    QQuickView view;
+    view.rootContext()->setContextProperty("suite", &suite);
+    view.setSource(QUrl::fromLocalFile(file));
+    view.setResizeMode(QQuickView::SizeViewToRootObject);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    *base = view.grabWindow();
+
+    QQuickItem *rootItem = view.rootObject();
+    QMetaObject::invokeMethod(rootItem, "enterFinalStage");
+    QTRY_VERIFY(rootItem->property("finalStageComplete").toBool());
+
+    *final = view.grabWindow();
+}
+
+// Allows for the rounding differences of different vertex shaders
+static bool compareImages(const QImage &actual, const QImage &expected, QString *error)
+{
+    if (actual.size() != expected.size()) {
+        *error = QString::fromLatin1("size %1x%2, expected %3x%4")
+                .arg(actual.width()).arg(actual.height())
+                .arg(expected.width()).arg(expected.height());
+        return false;
+    }
+
+    const int tolerance = 2;
+    for (int y=0; y<actual.height(); ++y) {
+        for (int x=0; x<actual.width(); ++x) {
+            const QRgb a = actual.pixel(x, y);
+            const QRgb e = expected.pixel(x, y);
+            if (qAbs(qRed(a) - qRed(e)) > tolerance
+                    || qAbs(qGreen(a) - qGreen(e)) > tolerance
+                    || qAbs(qBlue(a) - qBlue(e)) > tolerance) {
+                *error = QString::fromLatin1("pixel(%1,%2) is %3, expected %4")
+                        .arg(x).arg(y)
+                        .arg(QColor(a).name()).arg(QColor(e).name());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void tst_SceneGraph::renderWithFeature()
+{
+    QFETCH(QString, file);
+    QFETCH(QByteArray, offEnvironment);
+    QFETCH(QByteArray, onEnvironment);
+
+    QImage offBase, offFinal;
+    QList<QByteArray> names = setEnvironment(offEnvironment);
+    grabStages(file, &offBase, &offFinal);
+    unsetEnvironment(names);
+    if (QTest::currentTestFailed())
+        return;
+
+    QImage onBase, onFinal;
+    names = setEnvironment(onEnvironment);
+    grabStages(file, &onBase, &onFinal);
+    unsetEnvironment(names);
+    if (QTest::currentTestFailed())
+        return;
+
+    QString error;
+    QVERIFY2(compareImages(onBase, offBase, &error), qPrintable(QLatin1String("base stage: ") + error));
+    QVERIFY2(compareImages(onFinal, offFinal, &error), qPrintable(QLatin1String("final stage: ") + error));
+}
+
 // Testcase for QTBUG-34898. We make another context current on another surface
 // in the GUI thread and hide the QQuickWindow while the other context is
 // current on the other window.
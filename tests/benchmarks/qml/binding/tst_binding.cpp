@@ -36,6 +36,10 @@
 #include <QQmlContext>
 #include <QQmlComponent>
 #include <QFile>
+#include <QMetaProperty>
+#include <QUrl>
+#include <QDateTime>
+#include <QRectF>
 #include <QDebug>
 #include "testtypes.h"
 
@@ -56,6 +60,8 @@ private slots:
     void objectproperty();
     void basicproperty_data();
     void basicproperty();
+    void declaredproperty_data();
+    void declaredproperty();
     void creation_data();
     void creation();
 
@@ -152,6 +158,56 @@ void tst_binding::basicproperty()
     }
 }
 
+void tst_binding::declaredproperty_data()
+{
+    QTest::addColumn<QByteArray>("property");
+    QTest::addColumn<QVariant>("value1");
+    QTest::addColumn<QVariant>("value2");
+
+    QTest::newRow("int") << QByteArray("intValue") << QVariant(1) << QVariant(2);
+    QTest::newRow("real") << QByteArray("realValue") << QVariant(1.5) << QVariant(2.5);
+    QTest::newRow("bool") << QByteArray("boolValue") << QVariant(true) << QVariant(false);
+    QTest::newRow("string") << QByteArray("stringValue") << QVariant(QStringLiteral("a")) << QVariant(QStringLiteral("b"));
+    QTest::newRow("url") << QByteArray("urlValue") << QVariant(QUrl("http://a/")) << QVariant(QUrl("http://b/"));
+    QTest::newRow("date") << QByteArray("dateValue") << QVariant(QDateTime(QDate(2000, 1, 1))) << QVariant(QDateTime(QDate(2000, 1, 2)));
+    QTest::newRow("point") << QByteArray("pointValue") << QVariant(QPointF(1, 2)) << QVariant(QPointF(3, 4));
+    QTest::newRow("size") << QByteArray("sizeValue") << QVariant(QSizeF(1, 2)) << QVariant(QSizeF(3, 4));
+    QTest::newRow("rect") << QByteArray("rectValue") << QVariant(QRectF(1, 2, 3, 4)) << QVariant(QRectF(5, 6, 7, 8));
+}
+
+void tst_binding::declaredproperty()
+{
+    QFETCH(QByteArray, property);
+    QFETCH(QVariant, value1);
+    QFETCH(QVariant, value2);
+
+    QQmlComponent c(&engine);
+    {
+        QFile f(SRCDIR "/data/declaredproperty.txt");
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        c.setData(f.readAll(), QUrl());
+        QVERIFY(c.isReady());
+    }
+
+    QObject *object = c.create();
+    QVERIFY(object != 0);
+
+    const QMetaObject *mo = object->metaObject();
+    QMetaProperty prop = mo->property(mo->indexOfProperty(property.constData()));
+    QVERIFY(prop.isValid());
+
+    QVariant read;
+    QBENCHMARK {
+        prop.write(object, value1);
+        read = prop.read(object);
+        prop.write(object, value2);
+        read = prop.read(object);
+    }
+    QCOMPARE(read, value2);
+
+    delete object;
+}
+
 void tst_binding::creation_data()
 {
     QTest::addColumn<QString>("file");
@@ -7,12 +7,13 @@ SUBDIRS += \
            holistic \
            qqmlcomponent \
            qqmlimage \
+           qqmllistcompositor \
            qqmlmetaproperty \
            librarymetrics_performance \
 #            script \ ### FIXME: doesn't build
            js
 
-qtHaveModule(opengl): SUBDIRS += painting qquickwindow
+qtHaveModule(opengl): SUBDIRS += painting qquickwindow qquicktextedit
 qtHaveModule(widgets): SUBDIRS += creation
 
 include(../trusted-benchmarks.pri)
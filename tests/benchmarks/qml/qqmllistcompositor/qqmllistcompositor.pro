@@ -0,0 +1,7 @@
+CONFIG += benchmark
+TARGET = tst_qqmllistcompositor
+SOURCES += tst_qqmllistcompositor.cpp
+macx:CONFIG -= app_bundle
+
+QT += core-private qml-private testlib
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
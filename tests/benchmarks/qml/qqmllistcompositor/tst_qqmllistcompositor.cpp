@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <private/qqmllistcompositor_p.h>
+
+typedef QQmlListCompositor C;
+
+static const C::Group Visible = C::Group(2);
+static const C::Group Selection = C::Group(3);
+
+enum {
+    VisibleFlag   = 0x04,
+    SelectionFlag = 0x08
+};
+
+class tst_qqmllistcompositor : public QObject
+{
+    Q_OBJECT
+private slots:
+    void find_data();
+    void find();
+    void findInsertPosition();
+    void setFlags();
+    void clearFlags();
+    void move();
+    void listItemsInserted();
+    void listItemsRemoved();
+
+private:
+    void populate(C *compositor, int count);
+
+    int m_list;
+};
+
+// Fills a compositor with count items, every third of which is visible and every
+// seventh selected, as a filtered DelegateModel would be.
+void tst_qqmllistcompositor::populate(C *compositor, int count)
+{
+    compositor->setGroupCount(4);
+    compositor->setDefaultGroups(VisibleFlag | C::DefaultFlag);
+    compositor->append(&m_list, 0, count, C::AppendFlag | C::PrependFlag | C::DefaultFlag);
+    for (int i = 0; i < count; i += 3)
+        compositor->setFlags(C::Default, i, 1, VisibleFlag);
+    for (int i = 0; i < count; i += 7)
+        compositor->setFlags(C::Default, i, 1, SelectionFlag);
+}
+
+void tst_qqmllistcompositor::find_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("step");
+
+    QTest::newRow("sequential, 1000") << 1000 << 1;
+    QTest::newRow("sequential, 100000") << 100000 << 1;
+    QTest::newRow("random, 1000") << 1000 << 397;
+    QTest::newRow("random, 100000") << 100000 << 39317;
+}
+
+void tst_qqmllistcompositor::find()
+{
+    QFETCH(int, count);
+    QFETCH(int, step);
+
+    C compositor;
+    populate(&compositor, count);
+    const int visibleCount = compositor.count(Visible);
+
+    QBENCHMARK {
+        for (int i = 0, index = 0; i < 1000; ++i, index = (index + step) % visibleCount)
+            compositor.find(Visible, index);
+    }
+}
+
+void tst_qqmllistcompositor::findInsertPosition()
+{
+    C compositor;
+    populate(&compositor, 100000);
+    const int visibleCount = compositor.count(Visible);
+
+    QBENCHMARK {
+        for (int i = 0, index = 0; i < 1000; ++i, index = (index + 39317) % visibleCount)
+            compositor.findInsertPosition(Visible, index);
+    }
+}
+
+void tst_qqmllistcompositor::setFlags()
+{
+    C compositor;
+    populate(&compositor, 100000);
+
+    QBENCHMARK {
+        for (int index = 0; index < 100000; index += 9973)
+            compositor.setFlags(C::Default, index, 5, SelectionFlag);
+    }
+}
+
+void tst_qqmllistcompositor::clearFlags()
+{
+    C compositor;
+    populate(&compositor, 100000);
+
+    QBENCHMARK {
+        for (int index = 0; index < 100000; index += 9973)
+            compositor.clearFlags(C::Default, index, 5, SelectionFlag);
+    }
+}
+
+void tst_qqmllistcompositor::move()
+{
+    C compositor;
+    populate(&compositor, 100000);
+
+    QBENCHMARK {
+        compositor.move(C::Default, 10, C::Default, 90000, 5, C::Default);
+        compositor.move(C::Default, 90000, C::Default, 10, 5, C::Default);
+    }
+}
+
+void tst_qqmllistcompositor::listItemsInserted()
+{
+    C compositor;
+    populate(&compositor, 100000);
+
+    QVector<C::Insert> inserts;
+    QVector<C::Remove> removes;
+    QBENCHMARK {
+        compositor.listItemsInserted(&m_list, 50000, 1, &inserts);
+        compositor.listItemsRemoved(&m_list, 50000, 1, &removes);
+        inserts.clear();
+        removes.clear();
+    }
+}
+
+void tst_qqmllistcompositor::listItemsRemoved()
+{
+    C compositor;
+    populate(&compositor, 100000);
+
+    QVector<C::Remove> removes;
+    QBENCHMARK {
+        compositor.listItemsRemoved(&m_list, 50000, 1, &removes);
+        removes.clear();
+    }
+}
+
+QTEST_MAIN(tst_qqmllistcompositor)
+
+#include "tst_qqmllistcompositor.moc"
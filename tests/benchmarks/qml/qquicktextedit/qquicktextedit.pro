@@ -0,0 +1,7 @@
+CONFIG += benchmark
+TARGET = tst_qquicktextedit
+SOURCES += tst_qquicktextedit.cpp
+macx:CONFIG -= app_bundle
+
+QT += core-private gui-private qml-private quick-private testlib
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
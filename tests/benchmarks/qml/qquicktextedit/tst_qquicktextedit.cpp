@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/private/qquicktextedit_p.h>
+
+#include <qtest.h>
+#include <QtTest/QtTest>
+
+class tst_qquicktextedit : public QObject
+{
+    Q_OBJECT
+private slots:
+    void typeCharacter_data();
+    void typeCharacter();
+    void appendLine_data();
+    void appendLine();
+
+private:
+    void addLineCounts();
+    QQuickTextEdit *createTextEdit(QQuickWindow *window, int lineCount);
+};
+
+void tst_qquicktextedit::addLineCounts()
+{
+    QTest::addColumn<int>("lineCount");
+
+    QTest::newRow("1000 lines") << 1000;
+    QTest::newRow("10000 lines") << 10000;
+    QTest::newRow("100000 lines") << 100000;
+}
+
+QQuickTextEdit *tst_qquicktextedit::createTextEdit(QQuickWindow *window, int lineCount)
+{
+    QString text;
+    text.reserve(lineCount * 32);
+    for (int i = 0; i < lineCount; ++i)
+        text += QStringLiteral("Line %1 of the document\n").arg(i);
+
+    QQuickTextEdit *textEdit = new QQuickTextEdit(window->contentItem());
+    textEdit->setWidth(window->width());
+    textEdit->setText(text);
+    textEdit->setCursorPosition(textEdit->length());
+    textEdit->setFocus(true);
+    return textEdit;
+}
+
+void tst_qquicktextedit::typeCharacter_data()
+{
+    addLineCounts();
+}
+
+// Measures the cost of a keystroke at the end of the document, including the
+// frame that brings the scene graph nodes up to date.
+void tst_qquicktextedit::typeCharacter()
+{
+    QFETCH(int, lineCount);
+
+    QQuickWindow window;
+    window.resize(400, 400);
+    QQuickTextEdit *textEdit = createTextEdit(&window, lineCount);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    window.grabWindow();
+
+    QBENCHMARK {
+        textEdit->insert(textEdit->length(), QStringLiteral("x"));
+        window.grabWindow();
+    }
+}
+
+void tst_qquicktextedit::appendLine_data()
+{
+    addLineCounts();
+}
+
+// Measures the cost of starting a new line at the end of the document, which
+// also adds a block and changes the height of the text.
+void tst_qquicktextedit::appendLine()
+{
+    QFETCH(int, lineCount);
+
+    QQuickWindow window;
+    window.resize(400, 400);
+    QQuickTextEdit *textEdit = createTextEdit(&window, lineCount);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    window.grabWindow();
+
+    QBENCHMARK {
+        textEdit->insert(textEdit->length(), QStringLiteral("\nNew line"));
+        window.grabWindow();
+    }
+}
+
+QTEST_MAIN(tst_qquicktextedit)
+
+#include "tst_qquicktextedit.moc"
@@ -0,0 +1,8 @@
+QT = core gui-private quick-private
+DEFINES += QT_NO_CAST_TO_ASCII QT_NO_CAST_FROM_ASCII
+
+SOURCES += main.cpp
+
+QMAKE_TARGET_DESCRIPTION = Distance Field Glyph Cache Generator
+
+load(qt_tool)
@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the tools applications of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtGui/QGuiApplication>
+#include <QtGui/QRawFont>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QTextStream>
+#include <QtCore/qmath.h>
+#include <private/qrawfont_p.h>
+#include <private/qdistancefield_p.h>
+#include <private/qsgdistancefielddiskcache_p.h>
+#include <private/qsgdefaultdistancefieldglyphcache_p.h>
+
+#include <algorithm>
+
+QT_USE_NAMESPACE
+
+static bool parseRange(const QString &range, uint *first, uint *last)
+{
+    const QStringList bounds = range.split(QLatin1Char('-'));
+    if (bounds.isEmpty() || bounds.size() > 2)
+        return false;
+
+    bool ok = false;
+    *first = bounds.first().toUInt(&ok, 0);
+    if (!ok)
+        return false;
+    *last = bounds.size() == 2 ? bounds.last().toUInt(&ok, 0) : *first;
+    return ok && *first <= *last;
+}
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("dfcachegen"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Pre-populates the distance-field glyph cache used when QSG_DISTANCEFIELD_CACHE_DIR is set."));
+    parser.addHelpOption();
+    QCommandLineOption dirOption(QStringLiteral("cache-dir"),
+                                 QStringLiteral("Cache directory (defaults to $QSG_DISTANCEFIELD_CACHE_DIR)."),
+                                 QStringLiteral("dir"));
+    QCommandLineOption rangeOption(QStringLiteral("range"),
+                                   QStringLiteral("Code point range to generate, e.g. 0x20-0x7e. May be repeated."),
+                                   QStringLiteral("first-last"));
+    QCommandLineOption textOption(QStringLiteral("text"),
+                                  QStringLiteral("Generate the glyphs used by the given text."),
+                                  QStringLiteral("text"));
+    parser.addOption(dirOption);
+    parser.addOption(rangeOption);
+    parser.addOption(textOption);
+    parser.addPositionalArgument(QStringLiteral("font"), QStringLiteral("Font files to generate glyphs for."));
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    const QString cacheDir = parser.isSet(dirOption) ? parser.value(dirOption)
+                                                     : QSGDistanceFieldDiskCache::defaultDirectory();
+    if (cacheDir.isEmpty() || parser.positionalArguments().isEmpty())
+        parser.showHelp(1);
+
+    QString text = parser.values(textOption).join(QString());
+    QStringList ranges = parser.values(rangeOption);
+    if (ranges.isEmpty() && text.isEmpty())
+        ranges << QStringLiteral("0x20-0x7e");
+    foreach (const QString &range, ranges) {
+        uint first, last;
+        if (!parseRange(range, &first, &last)) {
+            err << "Invalid range: " << range << endl;
+            return 1;
+        }
+        for (uint ucs4 = first; ucs4 <= last; ++ucs4)
+            text += QString::fromUcs4(&ucs4, 1);
+    }
+
+    const int padding = QSG_DEFAULT_DISTANCEFIELD_GLYPH_CACHE_PADDING;
+
+    foreach (const QString &fileName, parser.positionalArguments()) {
+        QRawFont font(fileName, 12);
+        if (!font.isValid()) {
+            err << "Cannot load font: " << fileName << endl;
+            return 1;
+        }
+
+        // Mirror what QSGDistanceFieldGlyphCache does, so that the tiles match
+        // what the scene graph would have generated at run time.
+        const int glyphCount = QRawFontPrivate::get(font)->fontEngine->glyphCount();
+        const bool doubleGlyphResolution = qt_fontHasNarrowOutlines(font)
+                && glyphCount < QT_DISTANCEFIELD_HIGHGLYPHCOUNT;
+        const qreal scale = QT_DISTANCEFIELD_SCALE(doubleGlyphResolution);
+        const qreal margin = QT_DISTANCEFIELD_RADIUS(doubleGlyphResolution) / scale;
+
+        QRawFont referenceFont = font;
+        referenceFont.setPixelSize(QT_DISTANCEFIELD_BASEFONTSIZE(doubleGlyphResolution) * scale);
+
+        QSGDistanceFieldDiskCache cache(cacheDir, font, doubleGlyphResolution, padding);
+
+        QVector<quint32> glyphs = font.glyphIndexesForString(text);
+        std::sort(glyphs.begin(), glyphs.end());
+        glyphs.erase(std::unique(glyphs.begin(), glyphs.end()), glyphs.end());
+
+        int stored = 0;
+        foreach (quint32 glyph, glyphs) {
+            const QPainterPath path = referenceFont.pathForGlyph(glyph);
+            const QRectF boundingRect = path.boundingRect();
+            if (boundingRect.isEmpty())
+                continue;
+
+            const int expectedWidth = qCeil(boundingRect.width() / scale + margin * 2);
+            QDistanceField field(path, glyph, doubleGlyphResolution);
+            field = field.copy(-padding, -padding, expectedWidth + padding * 2, field.height() + padding * 2);
+            if (cache.store(glyph, field))
+                ++stored;
+        }
+
+        QTextStream(stdout) << fileName << ": " << stored << " glyphs" << endl;
+    }
+
+    return 0;
+}
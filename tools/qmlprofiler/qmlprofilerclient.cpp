@@ -207,7 +207,10 @@ void QmlProfilerClient::messageReceived(const QByteArray &data)
         QString pixUrl;
         stream >> pixEvTy >> pixUrl;
         if (pixEvTy == (int)QQmlProfilerDefinitions::PixmapReferenceCountChanged ||
-                pixEvTy == (int)QQmlProfilerDefinitions::PixmapCacheCountChanged) {
+                pixEvTy == (int)QQmlProfilerDefinitions::PixmapCacheCountChanged ||
+                pixEvTy == (int)QQmlProfilerDefinitions::PixmapCacheHit ||
+                pixEvTy == (int)QQmlProfilerDefinitions::PixmapCacheMiss ||
+                pixEvTy == (int)QQmlProfilerDefinitions::PixmapCacheEviction) {
             stream >> refcount;
         } else if (pixEvTy == (int)QQmlProfilerDefinitions::PixmapSizeKnown) {
             stream >> width >> height;
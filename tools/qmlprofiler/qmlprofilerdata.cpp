@@ -680,7 +680,13 @@ bool QmlProfilerData::save(const QString &filename)
             } else if (event.data->detailType ==
                        QQmlProfilerDefinitions::PixmapReferenceCountChanged ||
                     event.data->detailType ==
-                       QQmlProfilerDefinitions::PixmapCacheCountChanged) {
+                       QQmlProfilerDefinitions::PixmapCacheCountChanged ||
+                    event.data->detailType ==
+                       QQmlProfilerDefinitions::PixmapCacheHit ||
+                    event.data->detailType ==
+                       QQmlProfilerDefinitions::PixmapCacheMiss ||
+                    event.data->detailType ==
+                       QQmlProfilerDefinitions::PixmapCacheEviction) {
                 stream.writeAttribute(QStringLiteral("refCount"),
                                       QString::number(event.numericData3));
             }
@@ -16,7 +16,8 @@ qmlimportscanner.CONFIG = host_build
             SUBDIRS += \
                 qmlscene \
                 qmlplugindump \
-                qmltime
+                qmltime \
+                dfcachegen
         }
         qtHaveModule(widgets): SUBDIRS += qmleasing
     }
@@ -33,6 +34,7 @@ qmleasing.depends = qmlimportscanner
 # qmlplugindump cannot be a build tool, because it loads target plugins.
 # The other apps are mostly "desktop" tools and are thus excluded.
 qtNomakeTools( \
+    dfcachegen \
     qmlprofiler \
     qmlplugindump \
     qmleasing \